@@ -117,6 +117,33 @@ public:
     return m_filled;
   }
 
+  // Hands over the buffered data apart from the first 'skip' bytes and
+  // empties the buffer. The memory itself is handed over if the data
+  // fills most of it; otherwise the data is copied so that the caller
+  // doesn't keep a mostly unused buffer alive.
+  memory_cptr extract(std::size_t skip = 0) {
+    skip = std::min(skip, m_filled);
+
+    if ((m_filled * 2) < m_size) {
+      auto data = memory_c::clone(get_buffer() + skip, m_filled - skip);
+      clear();
+      return data;
+    }
+
+    auto data = m_data;
+    data->set_size(m_offset + m_filled);
+    data->set_offset(m_offset + skip);
+
+    m_data   = memory_c::alloc(m_chunk_size);
+    m_filled = 0;
+    m_offset = 0;
+    m_size   = m_chunk_size;
+
+    count_alloc(m_size);
+
+    return data;
+  }
+
   void set_chunk_size(size_t chunk_size) {
     m_chunk_size = chunk_size;
     trim();
@@ -16,12 +16,120 @@
 
 #include "common/common_pch.h"
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# define MTX_CRC_PCLMUL 1
+# include <cpuid.h>
+# include <smmintrin.h>
+# include <wmmintrin.h>
+#endif
+
 #include "common/bswap.h"
 #include "common/checksums/crc.h"
 #include "common/endian.h"
 
 namespace mtx { namespace checksum {
 
+#if defined(MTX_CRC_PCLMUL)
+
+namespace {
+
+bool
+cpu_supports_pclmul() {
+  unsigned int eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+
+  return (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+}
+
+bool const s_pclmul_available = cpu_supports_pclmul();
+
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i
+load_unaligned(unsigned char const *ptr) {
+  return _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr));
+}
+
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i
+fold_16(__m128i x,
+        __m128i next,
+        __m128i constants) {
+  auto low = _mm_clmulepi64_si128(x, constants, 0x00);
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, constants, 0x11), next), low);
+}
+
+// Folds the buffer with carry-less multiplications as described in
+// Intel's paper "Fast CRC Computation for Generic Polynomials Using
+// PCLMULQDQ Instruction". The constants are only valid for the
+// bit-reflected IEEE polynomial 0xEDB88320. Requires size to be at
+// least 64 and a multiple of 16.
+__attribute__((target("pclmul,sse4.1")))
+uint32_t
+crc32_ieee_le_pclmul(unsigned char const *buffer,
+                     size_t size,
+                     uint32_t crc) {
+  alignas(16) static uint64_t const k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+  alignas(16) static uint64_t const k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+  alignas(16) static uint64_t const k5k0[] = { 0x0163cd6124, 0x0000000000 };
+  alignas(16) static uint64_t const poly[] = { 0x01db710641, 0x01f7011641 };
+
+  auto x1 = _mm_xor_si128(load_unaligned(buffer), _mm_cvtsi32_si128(crc));
+  auto x2 = load_unaligned(buffer + 0x10);
+  auto x3 = load_unaligned(buffer + 0x20);
+  auto x4 = load_unaligned(buffer + 0x30);
+  auto x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(k1k2));
+
+  buffer += 64;
+  size   -= 64;
+
+  // Fold four blocks of 16 bytes in parallel.
+  while (size >= 64) {
+    x1 = fold_16(x1, load_unaligned(buffer),        x0);
+    x2 = fold_16(x2, load_unaligned(buffer + 0x10), x0);
+    x3 = fold_16(x3, load_unaligned(buffer + 0x20), x0);
+    x4 = fold_16(x4, load_unaligned(buffer + 0x30), x0);
+
+    buffer += 64;
+    size   -= 64;
+  }
+
+  // Fold the four blocks into one.
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(k3k4));
+
+  x1 = fold_16(x1, x2, x0);
+  x1 = fold_16(x1, x3, x0);
+  x1 = fold_16(x1, x4, x0);
+
+  while (size >= 16) {
+    x1      = fold_16(x1, load_unaligned(buffer), x0);
+    buffer += 16;
+    size   -= 16;
+  }
+
+  // Fold 128 bits down to 64 bits.
+  auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2        = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1        = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x0 = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x00), x2);
+
+  // Barrett reduction to 32 bits.
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(poly));
+  x2 = _mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x10), mask);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return _mm_extract_epi32(x1, 1);
+}
+
+}
+
+#endif  // MTX_CRC_PCLMUL
+
 crc_base_c::table_parameters_t const crc_base_c::ms_table_parameters[5] = {
   { 0,  8,       0x07 },
   { 0, 16,     0x8005 },
@@ -57,7 +165,7 @@ crc_base_c::init_table() {
   if ((parameters.bits < 8) || (parameters.bits > 32) || (parameters.poly >= (1LL<<parameters.bits)))
     throw std::domain_error{"Invalid CRC parameters"};
 
-  m_table.resize(256);
+  m_table.resize(256 * ms_num_slices);
 
   for (auto i = 0u; i < 256u; i++) {
     if (parameters.le) {
@@ -74,6 +182,12 @@ crc_base_c::init_table() {
     }
   }
 
+  for (auto slice = 1u; slice < ms_num_slices; ++slice)
+    for (auto i = 0u; i < 256u; i++) {
+      auto previous            = m_table[(slice - 1) * 256 + i];
+      m_table[slice * 256 + i] = (previous >> 8) ^ m_table[previous & 0xff];
+    }
+
   // for (auto row = 0u; row < (256u / 4); ++row)
   //   mxinfo(boost::format("0x%|1$08x| 0x%|2$08x| 0x%|3$08x| 0x%|4$08x|\n")
   //          % m_table[row * 4 + 0] % m_table[row * 4 + 1] % m_table[row * 4 + 2] % m_table[row * 4 + 3]);
@@ -127,6 +241,51 @@ crc_base_c::set_result_in_le(bool result_in_le) {
 void
 crc_base_c::add_impl(unsigned char const *buffer,
                      size_t size) {
+#if defined(MTX_CRC_PCLMUL)
+  if ((crc_32_ieee_le == m_type) && (size >= 64) && s_pclmul_available) {
+    auto to_fold  = size & ~static_cast<size_t>(15);
+    m_crc         = crc32_ieee_le_pclmul(buffer, to_fold, m_crc);
+    buffer       += to_fold;
+    size         -= to_fold;
+  }
+#endif
+
+  add_sliced(buffer, size);
+}
+
+void
+crc_base_c::add_sliced(unsigned char const *buffer,
+                       size_t size) {
+  // All variants are calculated with a right-shifting register (the
+  // MSB-first ones with byte-swapped tables), so the same slicing
+  // works for each of them.
+  auto crc   = m_crc;
+  auto table = m_table.data();
+
+  while (size >= 8) {
+    uint32_t one = (buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (static_cast<uint32_t>(buffer[3]) << 24)) ^ crc;
+
+    crc = table[7 * 256 + ( one        & 0xff)]
+        ^ table[6 * 256 + ((one >>  8) & 0xff)]
+        ^ table[5 * 256 + ((one >> 16) & 0xff)]
+        ^ table[4 * 256 + ( one >> 24        )]
+        ^ table[3 * 256 + buffer[4]]
+        ^ table[2 * 256 + buffer[5]]
+        ^ table[1 * 256 + buffer[6]]
+        ^ table[0 * 256 + buffer[7]];
+
+    buffer += 8;
+    size   -= 8;
+  }
+
+  m_crc = crc;
+
+  add_bytewise(buffer, size);
+}
+
+void
+crc_base_c::add_bytewise(unsigned char const *buffer,
+                         size_t size) {
   auto end = buffer + size;
 
   while (buffer < end) {
@@ -40,6 +40,10 @@ protected:
 
   static table_parameters_t const ms_table_parameters[5];
 
+  // Number of tables used for slicing-by-8: table k contains the CRC
+  // of a byte followed by k zero bytes.
+  static unsigned int const ms_num_slices = 8;
+
 protected:
   type_e m_type;
   table_t &m_table;
@@ -63,6 +67,8 @@ public:
 
 protected:
   virtual void add_impl(unsigned char const *buffer, size_t size);
+  void add_bytewise(unsigned char const *buffer, size_t size);
+  void add_sliced(unsigned char const *buffer, size_t size);
 
   virtual void set_initial_value_impl(uint64_t initial_value) ;
   virtual void set_initial_value_impl(unsigned char const *buffer, size_t size);
@@ -17,82 +17,101 @@
 
 zlib_compressor_c::zlib_compressor_c()
   : compressor_c(COMPRESSION_ZLIB)
+  , m_d_stream_initialized{}
+  , m_c_stream_initialized{}
+  , m_last_decompressed_size{}
 {
 }
 
 zlib_compressor_c::~zlib_compressor_c() {
+  if (m_d_stream_initialized)
+    inflateEnd(&m_d_stream);
+  if (m_c_stream_initialized)
+    deflateEnd(&m_c_stream);
 }
 
 memory_cptr
 zlib_compressor_c::do_decompress(memory_cptr const &buffer) {
-  z_stream d_stream;
+  int result;
 
-  d_stream.zalloc = (alloc_func)0;
-  d_stream.zfree  = (free_func)0;
-  d_stream.opaque = (voidpf)0;
-  int result      = inflateInit2(&d_stream, 15 + 32); // 15: window size; 32: look for zlib/gzip headers automatically
+  if (!m_d_stream_initialized) {
+    std::memset(&m_d_stream, 0, sizeof(m_d_stream));
 
-  if (Z_OK != result)
-    mxerror(boost::format(Y("inflateInit() failed. Result: %1%\n")) % result);
+    result = inflateInit2(&m_d_stream, 15 + 32); // 15: window size; 32: look for zlib/gzip headers automatically
+    if (Z_OK != result)
+      mxerror(boost::format(Y("inflateInit() failed. Result: %1%\n")) % result);
 
-  d_stream.next_in   = reinterpret_cast<Bytef *>(buffer->get_buffer());
-  d_stream.avail_in  = buffer->get_size();
-  int n              = 0;
-  memory_cptr dst    = memory_c::alloc(0);
+    m_d_stream_initialized = true;
 
-  do {
-    n++;
-    dst->resize(n * 4000);
-    d_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer() + (n - 1) * 4000);
-    d_stream.avail_out = 4000;
-    result             = inflate(&d_stream, Z_NO_FLUSH);
+  } else if (Z_OK != (result = inflateReset(&m_d_stream)))
+    mxerror(boost::format(Y("inflateReset() failed. Result: %1%\n")) % result);
 
-    if ((Z_OK != result) && (Z_STREAM_END != result))
+  m_d_stream.next_in  = reinterpret_cast<Bytef *>(buffer->get_buffer());
+  m_d_stream.avail_in = buffer->get_size();
+
+  // Packets of the same track usually decompress to similar sizes.
+  auto dst            = memory_c::alloc(std::max<std::size_t>({ m_last_decompressed_size, buffer->get_size() * 2, 4000 }));
+
+  while (true) {
+    m_d_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer() + m_d_stream.total_out);
+    m_d_stream.avail_out = dst->get_size() - m_d_stream.total_out;
+    result               = inflate(&m_d_stream, Z_NO_FLUSH);
+
+    if (Z_STREAM_END == result)
+      break;
+
+    // No progress possible: the input ended before the end of the stream.
+    if ((Z_BUF_ERROR == result) && !m_d_stream.avail_in)
+      break;
+
+    if (Z_OK != result)
       throw mtx::compression_x(boost::format(Y("Zlib decompression failed. Result: %1%\n")) % result);
 
-  } while ((0 == d_stream.avail_out) && (0 != d_stream.avail_in) && (Z_STREAM_END != result));
+    if (m_d_stream.avail_out)
+      break;
+
+    dst->resize(dst->get_size() * 2);
+  }
 
-  dst->resize(d_stream.total_out);
-  inflateEnd(&d_stream);
+  dst->resize(m_d_stream.total_out);
+  m_last_decompressed_size = m_d_stream.total_out;
 
-  mxverb(3, boost::format("zlib_compressor_c: Decompression from %1% to %2%, %3%%%\n") % buffer->get_size() % dst->get_size() % (dst->get_size() * 100 / buffer->get_size()));
+  mxverb(3, boost::format("zlib_compressor_c: Decompression from %1% to %2%, %3%%%\n") % buffer->get_size() % dst->get_size() % (dst->get_size() * 100 / std::max<std::size_t>(buffer->get_size(), 1)));
 
   return dst;
 }
 
 memory_cptr
 zlib_compressor_c::do_compress(memory_cptr const &buffer) {
-  z_stream c_stream;
+  int result;
+
+  if (!m_c_stream_initialized) {
+    std::memset(&m_c_stream, 0, sizeof(m_c_stream));
 
-  c_stream.zalloc = (alloc_func)0;
-  c_stream.zfree  = (free_func)0;
-  c_stream.opaque = (voidpf)0;
-  int result      = deflateInit(&c_stream, 9);
+    result = deflateInit(&m_c_stream, 9);
+    if (Z_OK != result)
+      mxerror(boost::format(Y("deflateInit() failed. Result: %1%\n")) % result);
 
-  if (Z_OK != result)
-    mxerror(boost::format(Y("deflateInit() failed. Result: %1%\n")) % result);
+    m_c_stream_initialized = true;
 
-  c_stream.next_in   = (Bytef *)buffer->get_buffer();
-  c_stream.avail_in  = buffer->get_size();
-  int n              = 0;
-  memory_cptr dst    = memory_c::alloc(0);
+  } else if (Z_OK != (result = deflateReset(&m_c_stream)))
+    mxerror(boost::format(Y("deflateReset() failed. Result: %1%\n")) % result);
 
-  do {
-    n++;
-    dst->resize(n * 4000);
-    c_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer() + (n - 1) * 4000);
-    c_stream.avail_out = 4000;
-    result             = deflate(&c_stream, Z_FINISH);
+  // deflateBound() guarantees that a single call with Z_FINISH suffices.
+  auto dst             = memory_c::alloc(deflateBound(&m_c_stream, buffer->get_size()));
 
-    if ((Z_OK != result) && (Z_STREAM_END != result))
-      mxerror(boost::format(Y("Zlib decompression failed. Result: %1%\n")) % result);
+  m_c_stream.next_in   = reinterpret_cast<Bytef *>(buffer->get_buffer());
+  m_c_stream.avail_in  = buffer->get_size();
+  m_c_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer());
+  m_c_stream.avail_out = dst->get_size();
+  result               = deflate(&m_c_stream, Z_FINISH);
 
-  } while ((c_stream.avail_out == 0) && (result != Z_STREAM_END));
+  if (Z_STREAM_END != result)
+    mxerror(boost::format(Y("Zlib compression failed. Result: %1%\n")) % result);
 
-  dst->resize(c_stream.total_out);
-  deflateEnd(&c_stream);
+  dst->resize(m_c_stream.total_out);
 
-  mxverb(3, boost::format("zlib_compressor_c: Compression from %1% to %2%, %3%%%\n") % buffer->get_size() % dst->get_size() % (dst->get_size() * 100 / buffer->get_size()));
+  mxverb(3, boost::format("zlib_compressor_c: Compression from %1% to %2%, %3%%%\n") % buffer->get_size() % dst->get_size() % (dst->get_size() * 100 / std::max<std::size_t>(buffer->get_size(), 1)));
 
   return dst;
 }
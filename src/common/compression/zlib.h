@@ -21,10 +21,21 @@
 #include "common/compression.h"
 
 class zlib_compressor_c: public compressor_c {
+protected:
+  // The streams are initialized on first use and only reset between
+  // packets as setting them up is much more expensive than
+  // (de)compressing a typical subtitle packet.
+  z_stream m_d_stream, m_c_stream;
+  bool m_d_stream_initialized, m_c_stream_initialized;
+  std::size_t m_last_decompressed_size;
+
 public:
   zlib_compressor_c();
   virtual ~zlib_compressor_c();
 
+  zlib_compressor_c(zlib_compressor_c const &) = delete;
+  zlib_compressor_c &operator =(zlib_compressor_c const &) = delete;
+
 protected:
   virtual memory_cptr do_decompress(memory_cptr const &buffer);
   virtual memory_cptr do_compress(memory_cptr const &buffer);
@@ -16,6 +16,9 @@
 
 #include "common/common_pch.h"
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 
@@ -65,37 +68,62 @@ class debugging_option_c {
   };
 
 protected:
-  mutable size_t m_registered_idx;
+  // Set on first use. Instances may be used from several threads at
+  // the same time (e.g. static ones in code run during parallel file
+  // type probing).
+  mutable std::atomic<option_c *> m_registered_option;
   std::string m_option;
 
 private:
-  static std::vector<option_c> ms_registered_options;
+  // Options may be registered from several threads (e.g. during
+  // parallel file type probing). A deque keeps the addresses of
+  // registered options stable while new ones are added.
+  static std::deque<option_c> ms_registered_options;
+  static std::mutex ms_mutex;
 
 public:
   debugging_option_c(std::string const &option)
-    : m_registered_idx{std::numeric_limits<size_t>::max()}
+    : m_registered_option{}
     , m_option{option}
   {
   }
 
+  debugging_option_c(debugging_option_c const &other)
+    : m_registered_option{other.m_registered_option.load()}
+    , m_option{other.m_option}
+  {
+  }
+
+  debugging_option_c &operator =(debugging_option_c const &other) {
+    m_registered_option = other.m_registered_option.load();
+    m_option            = other.m_option;
+
+    return *this;
+  }
+
   operator bool() const {
-    return ms_registered_options.at(get_idx()).get();
+    return get_option().get();
   }
 
   void set(boost::tribool requested) {
-    ms_registered_options.at(get_idx()).m_requested = requested;
+    get_option().m_requested = requested;
   }
 
 protected:
-  std::size_t get_idx() const {
-    if (m_registered_idx == std::numeric_limits<size_t>::max())
-      m_registered_idx = register_option(m_option);
+  option_c &get_option() const {
+    // Registering is idempotent. Threads racing here store the same
+    // address.
+    auto option = m_registered_option.load();
+    if (!option) {
+      option              = &register_option(m_option);
+      m_registered_option = option;
+    }
 
-    return m_registered_idx;
+    return *option;
   }
 
 public:
-  static size_t register_option(std::string const &option);
+  static option_c &register_option(std::string const &option);
   static void invalidate_cache();
 };
 
@@ -43,6 +43,8 @@ static const struct {
   { ENGAGE_KEEP_LAST_CHAPTER_IN_MPLS,    "keep_last_chapter_in_mpls"    },
   { ENGAGE_KEEP_TRACK_STATISTICS_TAGS,   "keep_track_statistics_tags"   },
   { ENGAGE_ALL_I_SLICES_ARE_KEY_FRAMES,  "all_i_slices_are_key_frames"  },
+  { ENGAGE_MEMORY_MAPPED_INPUT,          "memory_mapped_input"          },
+  { ENGAGE_MEMORY_POOLS,                 "memory_pools"                 },
   { 0,                                   nullptr },
 };
 static std::vector<bool> s_engaged_hacks(ENGAGE_MAX_IDX + 1, false);
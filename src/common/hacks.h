@@ -40,7 +40,9 @@
 #define ENGAGE_KEEP_LAST_CHAPTER_IN_MPLS    19
 #define ENGAGE_KEEP_TRACK_STATISTICS_TAGS   20
 #define ENGAGE_ALL_I_SLICES_ARE_KEY_FRAMES  21
-#define ENGAGE_MAX_IDX                      21
+#define ENGAGE_MEMORY_MAPPED_INPUT          22
+#define ENGAGE_MEMORY_POOLS                 23
+#define ENGAGE_MAX_IDX                      23
 
 void engage_hacks(const std::string &hacks);
 void engage_hack(unsigned int id);
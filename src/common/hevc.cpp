@@ -1433,77 +1433,13 @@ es_parser_c::discard_actual_frames(bool discard) {
 void
 es_parser_c::add_bytes(unsigned char *buffer,
                        size_t size) {
-  memory_slice_cursor_c cursor;
-  int marker_size              = 0;
-  int previous_marker_size     = 0;
-  int previous_pos             = -1;
-  uint64_t previous_parsed_pos = m_parsed_position;
-
-  if (m_unparsed_buffer && (0 != m_unparsed_buffer->get_size()))
-    cursor.add_slice(m_unparsed_buffer);
-  cursor.add_slice(buffer, size);
-
-  if (3 <= cursor.get_remaining_size()) {
-    uint32_t marker =                               1 << 24
-                    | (unsigned int)cursor.get_char() << 16
-                    | (unsigned int)cursor.get_char() <<  8
-                    | (unsigned int)cursor.get_char();
-
-    while (1) {
-      if (NALU_START_CODE == marker)
-        marker_size = 4;
-      else if (NALU_START_CODE == (marker & 0x00ffffff))
-        marker_size = 3;
-
-      if (0 != marker_size) {
-        if (-1 != previous_pos) {
-          auto new_size = cursor.get_position() - marker_size - previous_pos - previous_marker_size;
-          auto nalu     = memory_c::alloc(new_size);
-          cursor.copy(nalu->get_buffer(), previous_pos + previous_marker_size, new_size);
-          m_parsed_position = previous_parsed_pos + previous_pos;
-
-          mtx::mpeg::remove_trailing_zero_bytes(*nalu);
-          if (nalu->get_size())
-            handle_nalu(nalu, m_parsed_position);
-        }
-        previous_pos         = cursor.get_position() - marker_size;
-        previous_marker_size = marker_size;
-        marker_size          = 0;
-      }
-
-      if (!cursor.char_available())
-        break;
-
-      marker <<= 8;
-      marker  |= (unsigned int)cursor.get_char();
-    }
-  }
-
-  if (-1 == previous_pos)
-    previous_pos = 0;
-
+  mtx::mpeg::split_into_nalus(m_unparsed_buffer, m_parsed_position, buffer, size, [this](memory_cptr const &nalu, uint64_t position) { handle_nalu(nalu, position); });
   m_stream_position += size;
-  m_parsed_position  = previous_parsed_pos + previous_pos;
-
-  int new_size = cursor.get_size() - previous_pos;
-  if (0 != new_size) {
-    m_unparsed_buffer = memory_c::alloc(new_size);
-    cursor.copy(m_unparsed_buffer->get_buffer(), previous_pos, new_size);
-
-  } else
-    m_unparsed_buffer.reset();
 }
 
 void
 es_parser_c::flush() {
-  if (m_unparsed_buffer && (5 <= m_unparsed_buffer->get_size())) {
-    m_parsed_position += m_unparsed_buffer->get_size();
-    auto marker_size   = get_uint32_be(m_unparsed_buffer->get_buffer()) == NALU_START_CODE ? 4 : 3;
-    auto nalu_size     = m_unparsed_buffer->get_size() - marker_size;
-    handle_nalu(memory_c::clone(m_unparsed_buffer->get_buffer() + marker_size, nalu_size), m_parsed_position - nalu_size);
-  }
-
-  m_unparsed_buffer.reset();
+  mtx::mpeg::flush_nalus(m_unparsed_buffer, m_parsed_position, [this](memory_cptr const &nalu, uint64_t position) { handle_nalu(nalu, position); });
   if (m_have_incomplete_frame) {
     m_frames.push_back(m_incomplete_frame);
     m_have_incomplete_frame = false;
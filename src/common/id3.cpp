@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include "common/mm_io.h"
+#include "common/mm_io_x.h"
 
 int
 skip_id3v2_tag(mm_io_c &io) {
@@ -96,7 +97,14 @@ id3v1_tag_present_at_end(mm_io_c &io) {
 
 int
 id3_tag_present_at_end(mm_io_c &io) {
-  if (id3v1_tag_present_at_end(io))
-    return 128;
-  return id3v2_tag_present_at_end(io);
+  // Sources that cannot seek, e.g. pipes, cannot be checked.
+  try {
+    if (id3v1_tag_present_at_end(io))
+      return 128;
+    return id3v2_tag_present_at_end(io);
+
+  } catch (mtx::mm_io::seek_x &) {
+    io.restore_pos();
+    return 0;
+  }
 }
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 
+#include <ebml/EbmlCrc32.h>
 #include <ebml/EbmlStream.h>
 #include <ebml/EbmlSubHead.h>
 #include <ebml/EbmlVoid.h>
@@ -30,6 +31,7 @@
 #include "common/error.h"
 #include "common/list_utils.h"
 #include "common/kax_analyzer.h"
+#include "common/kax_level1_scanner.h"
 #include "common/mm_io_x.h"
 #include "common/strings/editing.h"
 
@@ -90,6 +92,11 @@ kax_analyzer_c::close_file() {
 
     delete m_stream;
     m_stream = nullptr;
+
+    // Only now that the file has been closed are its modification
+    // time and content final.
+    if (m_sidecar_index_needs_update)
+      store_sidecar_index();
   }
 }
 
@@ -245,6 +252,18 @@ kax_analyzer_c::set_parser_start_position(uint64_t position) {
   return *this;
 }
 
+kax_analyzer_c &
+kax_analyzer_c::set_use_sidecar_index(bool use_sidecar_index) {
+  m_use_sidecar_index = use_sidecar_index;
+  return *this;
+}
+
+kax_analyzer_c &
+kax_analyzer_c::set_num_scan_threads(unsigned int num_scan_threads) {
+  m_num_scan_threads = std::max(num_scan_threads, 1u);
+  return *this;
+}
+
 bool
 kax_analyzer_c::process() {
   try {
@@ -275,6 +294,7 @@ kax_analyzer_c::process_internal() {
 
   m_segment.reset();
   m_data.clear();
+  m_data_complete = false;
 
   m_file->setFilePointer(0);
   m_stream = new EbmlStream(*m_file);
@@ -326,8 +346,27 @@ kax_analyzer_c::process_internal() {
   if (m_parser_start_position)
     m_file->setFilePointer(std::max<uint64_t>(*m_parser_start_position, m_segment->GetElementPosition() + m_segment->HeadSize()));
 
+  // A valid sidecar index contains all level 1 elements. It's
+  // therefore at least as good as parsing fully. Otherwise parse fully
+  // so that a complete index can be stored.
+  else if (m_use_sidecar_index) {
+    if (load_data_from_sidecar_index()) {
+      show_progress_done();
+      return true;
+    }
+
+    parse_fully = true;
+  }
+
+  // Scanning in parallel requires opening the file several times.
+  auto scanned_in_parallel = parse_fully
+                          && !m_parser_start_position
+                          && m_close_file
+                          && (1 < m_num_scan_threads)
+                          && scan_level1_elements_in_parallel();
+
   // We've got our segment, so let's find all level 1 elements.
-  while (m_file->getFilePointer() < m_segment_end) {
+  while (!scanned_in_parallel && (m_file->getFilePointer() < m_segment_end)) {
     if (!l1)
       l1 = m_stream->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true, 1);
 
@@ -359,9 +398,14 @@ kax_analyzer_c::process_internal() {
   show_progress_done();
 
   if (!aborted) {
-    if (parse_mode_full != m_parse_mode)
+    if (!parse_fully)
       fix_element_sizes(file_size);
 
+    else if (!m_parser_start_position) {
+      m_data_complete              = true;
+      m_sidecar_index_needs_update = m_use_sidecar_index;
+    }
+
     return true;
   }
 
@@ -443,6 +487,8 @@ kax_analyzer_c::update_element(EbmlElement *e,
     call_and_validate(add_to_meta_seek(e),                        "update_element_6");
     call_and_validate(merge_void_elements(),                      "update_element_7");
 
+    m_sidecar_index_needs_update = m_use_sidecar_index && m_data_complete;
+
   } catch (kax_analyzer_c::update_element_result_e result) {
     debug_dump_elements_maybe("update_element_exception");
     return result;
@@ -467,6 +513,8 @@ kax_analyzer_c::remove_elements(EbmlId const &id) {
     call_and_validate(remove_from_meta_seeks(id),                 "remove_elements_4");
     call_and_validate(merge_void_elements(),                      "remove_elements_5");
 
+    m_sidecar_index_needs_update = m_use_sidecar_index && m_data_complete;
+
   } catch (kax_analyzer_c::update_element_result_e result) {
     debug_dump_elements_maybe("update_element_exception");
     return result;
@@ -1528,6 +1576,149 @@ kax_analyzer_c::determine_webm() {
   m_is_webm     = doc_type && (doc_type->GetValue() == "webm");
 }
 
+bool
+kax_analyzer_c::verify_element_id_at(kax_analyzer_index_c::entry_t const &entry) {
+  unsigned char buffer[4];
+
+  if (!entry.m_id_length || (entry.m_id_length > 4))
+    return false;
+
+  m_file->setFilePointer(entry.m_pos);
+  if (m_file->read(buffer, entry.m_id_length) != entry.m_id_length)
+    return false;
+
+  uint32_t id = 0;
+  for (auto idx = 0u; idx < entry.m_id_length; ++idx)
+    id = (id << 8) | buffer[idx];
+
+  return id == entry.m_id;
+}
+
+bool
+kax_analyzer_c::load_data_from_sidecar_index() {
+  kax_analyzer_index_c index{m_file_name};
+
+  if (!index.load() || index.get_entries().empty() || (index.get_segment_pos() != get_segment_pos())) {
+    mxdebug_if(m_debug, boost::format("kax_analyzer: no usable sidecar index for '%1%'\n") % m_file_name);
+    return false;
+  }
+
+  // The signature covers the file's size, modification time and its
+  // start & end. Additionally verify the structure: the entries must
+  // not overlap, and all elements apart from the clusters in the
+  // middle must actually be present at the positions recorded.
+  auto const &entries = index.get_entries();
+  auto cluster_id     = EBML_ID_VALUE(EBML_ID(KaxCluster));
+  auto first_cluster  = entries.size();
+  auto last_cluster   = entries.size();
+  auto next_pos       = get_segment_data_start_pos();
+
+  for (std::size_t idx = 0; idx < entries.size(); ++idx)
+    if (entries[idx].m_id == cluster_id) {
+      first_cluster = std::min(first_cluster, idx);
+      last_cluster  = idx;
+    }
+
+  for (std::size_t idx = 0; idx < entries.size(); ++idx) {
+    auto const &entry = entries[idx];
+    auto check_id     = (entry.m_id != cluster_id) || (idx == first_cluster) || (idx == last_cluster);
+
+    if (   (entry.m_pos < next_pos)
+        || (entry.m_size < 0)
+        || (entry.m_size_known && ((entry.m_pos + entry.m_size) > m_segment_end))
+        || (check_id && !verify_element_id_at(entry))) {
+      mxdebug_if(m_debug, boost::format("kax_analyzer: sidecar index for '%1%' doesn't match the file at position %2%\n") % m_file_name % entry.m_pos);
+      return false;
+    }
+
+    next_pos = entry.m_pos + entry.m_size;
+  }
+
+  for (auto const &entry : entries)
+    m_data.push_back(kax_analyzer_data_c::create(EbmlId(entry.m_id, entry.m_id_length), entry.m_pos, entry.m_size, entry.m_size_known));
+
+  m_data_complete = true;
+
+  mxdebug_if(m_debug, boost::format("kax_analyzer: using %1% entries from the sidecar index for '%2%'\n") % m_data.size() % m_file_name);
+
+  return true;
+}
+
+void
+kax_analyzer_c::store_sidecar_index() {
+  m_sidecar_index_needs_update = false;
+
+  auto entries = std::vector<kax_analyzer_index_c::entry_t>{};
+  for (auto const &data : m_data)
+    entries.push_back(kax_analyzer_index_c::entry_t{ EBML_ID_VALUE(data->m_id), EBML_ID_LENGTH(data->m_id), data->m_pos, data->m_size, data->m_size_known });
+
+  kax_analyzer_index_c index{m_file_name};
+  index.set(get_segment_pos(), entries);
+
+  if (!index.store())
+    mxdebug_if(m_debug, boost::format("kax_analyzer: storing the sidecar index for '%1%' failed\n") % m_file_name);
+}
+
+bool
+kax_analyzer_c::scan_level1_elements_in_parallel() {
+  auto const &context = EBML_CONTEXT(m_segment.get());
+  auto level1_ids     = std::vector<uint32_t>{ EBML_ID_VALUE(EBML_ID(EbmlVoid)), EBML_ID_VALUE(EBML_ID(EbmlCrc32)) };
+
+  for (auto idx = 0u; idx < EBML_CTX_SIZE(context); ++idx)
+    level1_ids.push_back(EBML_ID_VALUE(EBML_CTX_IDX_ID(context, idx)));
+
+  // Used for the ranges whose results cannot be verified. Works like
+  // the regular scan including libebml's resyncing on damaged data.
+  auto scan_sequentially = [this](uint64_t start, uint64_t end) {
+    kax_level1_scanner_c::range_result_t result;
+    auto pos = start;
+
+    while (pos < end) {
+      int upper_lvl_el = 0;
+      m_file->setFilePointer(pos);
+
+      auto l1 = std::unique_ptr<EbmlElement>(m_stream->FindNextElement(EBML_CONTEXT(m_segment.get()), upper_lvl_el, 0xFFFFFFFFL, true, 1));
+      if (!l1 || (0 < upper_lvl_el))
+        break;
+
+      if (l1->GetElementPosition() >= end) {
+        pos = l1->GetElementPosition();
+        break;
+      }
+
+      auto id = EbmlId(*l1);
+      result.m_entries.push_back(kax_level1_scanner_c::entry_t{ EBML_ID_VALUE(id), EBML_ID_LENGTH(id), l1->GetElementPosition(), static_cast<int64_t>(l1->ElementSize(true)), l1->IsFiniteSize() });
+
+      l1->SkipData(*m_stream, EBML_CONTEXT(l1.get()));
+      pos = m_file->getFilePointer();
+
+      if (!in_parent(m_segment))
+        break;
+    }
+
+    result.m_stop_pos = pos;
+    result.m_complete = true;
+
+    return result;
+  };
+
+  try {
+    kax_level1_scanner_c scanner{m_file_name, get_segment_data_start_pos(), m_segment_end, level1_ids, EBML_ID_VALUE(EBML_ID(KaxCluster))};
+
+    for (auto const &entry : scanner.scan(m_num_scan_threads, scan_sequentially))
+      m_data.push_back(kax_analyzer_data_c::create(EbmlId(entry.m_id, entry.m_id_length), entry.m_pos, entry.m_size, entry.m_size_known));
+
+    return true;
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxdebug_if(m_debug, boost::format("kax_analyzer: scanning in parallel failed: %1%\n") % ex.what());
+  }
+
+  m_data.clear();
+  m_file->setFilePointer(get_segment_data_start_pos());
+
+  return false;
+}
 
 // ------------------------------------------------------------
 
@@ -20,6 +20,7 @@
 #include <matroska/KaxSegment.h>
 
 #include "common/ebml.h"
+#include "common/kax_analyzer_index.h"
 #include "common/mm_io.h"
 
 using namespace libebml;
@@ -112,6 +113,8 @@ private:
   bool m_throw_on_error{};
   boost::optional<uint64_t> m_parser_start_position;
   bool m_is_webm{};
+  bool m_use_sidecar_index{}, m_data_complete{}, m_sidecar_index_needs_update{};
+  unsigned int m_num_scan_threads{1};
 
 public:                         // Static functions
   static bool probe(std::string file_name);
@@ -144,6 +147,8 @@ public:
   virtual kax_analyzer_c &set_open_mode(open_mode mode);
   virtual kax_analyzer_c &set_throw_on_error(bool throw_on_error);
   virtual kax_analyzer_c &set_parser_start_position(uint64_t position);
+  virtual kax_analyzer_c &set_use_sidecar_index(bool use_sidecar_index);
+  virtual kax_analyzer_c &set_num_scan_threads(unsigned int num_scan_threads);
 
   virtual bool process();
 
@@ -209,6 +214,12 @@ protected:
 
   virtual void determine_webm();
 
+  virtual bool load_data_from_sidecar_index();
+  virtual bool verify_element_id_at(kax_analyzer_index_c::entry_t const &entry);
+  virtual void store_sidecar_index();
+
+  virtual bool scan_level1_elements_in_parallel();
+
 protected:
   virtual bool process_internal();
 };
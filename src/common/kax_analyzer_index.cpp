@@ -0,0 +1,202 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   sidecar index for the Matroska file analyzer
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#if !defined(SYS_WINDOWS)
+# include <sys/stat.h>
+# include <sys/types.h>
+#endif
+
+#include "common/checksums/base.h"
+#include "common/kax_analyzer_index.h"
+#include "common/mm_io_x.h"
+#include "common/strings/formatting.h"
+
+static debugging_option_c s_debug{"kax_analyzer_index"};
+
+unsigned int const kax_analyzer_index_c::ms_format_version;
+uint64_t const kax_analyzer_index_c::ms_hashed_size;
+
+static std::string
+hash_range(mm_io_c &in,
+           uint64_t start,
+           uint64_t size) {
+  auto buffer = memory_c::alloc(size);
+
+  in.setFilePointer(start);
+  if (in.read(buffer, size) != size)
+    throw mtx::mm_io::end_of_file_x{};
+
+  auto hash = mtx::checksum::calculate(mtx::checksum::algorithm_e::md5, *buffer);
+
+  return to_hex(hash, true);
+}
+
+kax_analyzer_index_c::kax_analyzer_index_c(std::string const &file_name)
+  : m_file_name{file_name}
+{
+}
+
+std::string
+kax_analyzer_index_c::get_index_file_name()
+  const {
+  return m_file_name + ".mtxindex";
+}
+
+boost::optional<nlohmann::json>
+kax_analyzer_index_c::build_signature(std::string const &file_name) {
+  auto path = bfs::path{file_name};
+  auto ec   = boost::system::error_code{};
+
+  if (!bfs::is_regular_file(path, ec) || ec)
+    return boost::none;
+
+  auto modification_time = bfs::last_write_time(path, ec);
+  if (ec)
+    return boost::none;
+
+  try {
+    mm_file_io_c in{file_name};
+
+    uint64_t size    = in.get_size();
+    auto hashed_size = std::min(size, ms_hashed_size);
+
+    auto signature = nlohmann::json{
+      { "size",              size                                                 },
+      { "modification_time", static_cast<int64_t>(modification_time)              },
+      { "head_md5",          hash_range(in, 0,                  hashed_size)      },
+      { "tail_md5",          hash_range(in, size - hashed_size, hashed_size)      },
+    };
+
+#if !defined(SYS_WINDOWS)
+    // Sub-second modification times catch files that have been
+    // modified in place quickly after the index was stored.
+    struct stat st;
+    if (0 != ::stat(g_cc_local_utf8->native(file_name).c_str(), &st))
+      return boost::none;
+
+# if defined(SYS_APPLE)
+    signature["modification_time_ns"] = static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+# else
+    signature["modification_time_ns"] = static_cast<int64_t>(st.st_mtim.tv_nsec);
+# endif
+#endif
+
+    return signature;
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxdebug_if(s_debug, boost::format("build_signature: reading %1% failed: %2%\n") % file_name % ex);
+  }
+
+  return boost::none;
+}
+
+void
+kax_analyzer_index_c::set(uint64_t segment_pos,
+                          std::vector<entry_t> const &entries) {
+  m_segment_pos = segment_pos;
+  m_entries     = entries;
+}
+
+bool
+kax_analyzer_index_c::load() {
+  auto index_file_name = get_index_file_name();
+  auto ec              = boost::system::error_code{};
+
+  m_entries.clear();
+
+  if (!bfs::exists(bfs::path{index_file_name}, ec) || ec)
+    return false;
+
+  try {
+    auto content = mm_file_io_c::slurp(index_file_name);
+    auto index   = mtx::json::parse(std::string{reinterpret_cast<char const *>(content->get_buffer()), content->get_size()});
+
+    if (   !index.is_object()
+        || (index.value("version", 0u) != ms_format_version)
+        || (index["signature"] != build_signature(m_file_name).value_or(nlohmann::json{}))) {
+      mxdebug_if(s_debug, boost::format("load: index %1% is outdated\n") % index_file_name);
+      return false;
+    }
+
+    auto entries = std::vector<entry_t>{};
+
+    for (auto const &entry : index["entries"])
+      entries.push_back(entry_t{ entry.at(0).get<uint32_t>(), entry.at(1).get<unsigned int>(), entry.at(2).get<uint64_t>(), entry.at(3).get<int64_t>(), entry.at(4).get<bool>() });
+
+    m_segment_pos = index["segment_position"].get<uint64_t>();
+    m_entries     = std::move(entries);
+
+    mxdebug_if(s_debug, boost::format("load: loaded %1% entries from %2%\n") % m_entries.size() % index_file_name);
+
+    return true;
+
+  } catch (std::exception &ex) {
+    mxdebug_if(s_debug, boost::format("load: reading %1% failed: %2%\n") % index_file_name % ex.what());
+  }
+
+  return false;
+}
+
+bool
+kax_analyzer_index_c::store()
+  const {
+  auto signature = build_signature(m_file_name);
+  if (!signature)
+    return false;
+
+  auto index_file_name = get_index_file_name();
+  auto temp_path       = bfs::path{index_file_name + ".tmp"};
+  auto ec              = boost::system::error_code{};
+
+  try {
+    auto entries = nlohmann::json::array();
+    for (auto const &entry : m_entries)
+      entries.push_back(nlohmann::json{ entry.m_id, entry.m_id_length, entry.m_pos, entry.m_size, entry.m_size_known });
+
+    auto content = mtx::json::dump(nlohmann::json{
+      { "version",          ms_format_version },
+      { "signature",        *signature        },
+      { "segment_position", m_segment_pos     },
+      { "entries",          entries           },
+    });
+
+    {
+      mm_file_io_c out{temp_path.string(), MODE_CREATE};
+      out.write(content.c_str(), content.size());
+    }
+
+    bfs::rename(temp_path, bfs::path{index_file_name}, ec);
+    if (!ec) {
+      mxdebug_if(s_debug, boost::format("store: stored %1% entries in %2%\n") % m_entries.size() % index_file_name);
+      return true;
+    }
+
+    mxdebug_if(s_debug, boost::format("store: renaming %1% to %2% failed: %3%\n") % temp_path.string() % index_file_name % ec.message());
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxdebug_if(s_debug, boost::format("store: writing %1% failed: %2%\n") % temp_path.string() % ex);
+  }
+
+  bfs::remove(temp_path, ec);
+
+  return false;
+}
+
+void
+kax_analyzer_index_c::remove()
+  const {
+  auto ec = boost::system::error_code{};
+  bfs::remove(bfs::path{get_index_file_name()}, ec);
+}
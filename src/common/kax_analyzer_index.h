@@ -0,0 +1,69 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   sidecar index for the Matroska file analyzer
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_ANALYZER_INDEX_H
+#define MTX_COMMON_KAX_ANALYZER_INDEX_H
+
+#include "common/common_pch.h"
+
+#include "common/json.h"
+
+// Stores the level 1 elements found by kax_analyzer_c in a file next
+// to the Matroska file ("<file name>.mtxindex") so that analyzing the
+// same file again doesn't require walking all of its clusters.
+//
+// The index is only used if the Matroska file's size, modification
+// time and the hashes of its first and last MiB are the same as when
+// the index was stored. The index is written to a temporary file
+// first and then renamed.
+class kax_analyzer_index_c {
+public:
+  struct entry_t {
+    uint32_t m_id;
+    unsigned int m_id_length;
+    uint64_t m_pos;
+    int64_t m_size;
+    bool m_size_known;
+  };
+
+  static unsigned int const ms_format_version = 1;
+  static uint64_t const ms_hashed_size        = 1024 * 1024;
+
+protected:
+  std::string m_file_name;
+  uint64_t m_segment_pos{};
+  std::vector<entry_t> m_entries;
+
+public:
+  kax_analyzer_index_c(std::string const &file_name);
+
+  bool load();
+  bool store() const;
+  void remove() const;
+
+  void set(uint64_t segment_pos, std::vector<entry_t> const &entries);
+
+  uint64_t get_segment_pos() const {
+    return m_segment_pos;
+  }
+
+  std::vector<entry_t> const &get_entries() const {
+    return m_entries;
+  }
+
+  std::string get_index_file_name() const;
+
+  static boost::optional<nlohmann::json> build_signature(std::string const &file_name);
+};
+
+#endif  // MTX_COMMON_KAX_ANALYZER_INDEX_H
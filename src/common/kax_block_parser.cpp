@@ -0,0 +1,203 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   parsing raw Matroska elements and block headers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/kax_block_parser.h"
+
+namespace mtx { namespace kax {
+
+namespace {
+
+// Returns the number of bytes the variable length integer starting
+// with 'first_byte' occupies or 0 if it is invalid.
+unsigned int
+get_vint_length(unsigned char first_byte,
+                unsigned int max_length) {
+  for (auto length = 1u; length <= max_length; ++length)
+    if (first_byte & (0x80 >> (length - 1)))
+      return length;
+
+  return 0;
+}
+
+bool
+read_vint(unsigned char const *buffer,
+          std::size_t size,
+          std::size_t &length,
+          uint64_t &value,
+          bool &is_unknown) {
+  if (!size)
+    return false;
+
+  length = get_vint_length(buffer[0], 8);
+  if (!length || (length > size))
+    return false;
+
+  auto all_ones = (0xffu >> length) == (buffer[0] & (0xff >> length));
+  value         = buffer[0] & (0xff >> length);
+
+  for (auto idx = 1u; idx < length; ++idx) {
+    value    = (value << 8) | buffer[idx];
+    all_ones = all_ones && (0xff == buffer[idx]);
+  }
+
+  is_unknown = all_ones;
+
+  return true;
+}
+
+bool
+read_vint(unsigned char const *buffer,
+          std::size_t size,
+          std::size_t &length,
+          uint64_t &value) {
+  auto is_unknown = false;
+  return read_vint(buffer, size, length, value, is_unknown);
+}
+
+}
+
+bool
+read_raw_element_header(unsigned char const *buffer,
+                        std::size_t size,
+                        raw_element_t &element) {
+  if (!size)
+    return false;
+
+  auto id_length = get_vint_length(buffer[0], 4);
+  if (!id_length || (id_length > size))
+    return false;
+
+  element.m_id = 0;
+  for (auto idx = 0u; idx < id_length; ++idx)
+    element.m_id = (element.m_id << 8) | buffer[idx];
+
+  auto size_length = std::size_t{};
+  auto is_unknown  = false;
+
+  if (   !read_vint(buffer + id_length, size - id_length, size_length, element.m_data_size, is_unknown)
+      || is_unknown)
+    return false;
+
+  element.m_header_size = id_length + size_length;
+
+  return true;
+}
+
+bool
+read_raw_element(unsigned char const *buffer,
+                 std::size_t size,
+                 raw_element_t &element) {
+  return read_raw_element_header(buffer, size, element)
+      && (element.m_data_size <= (size - element.m_header_size));
+}
+
+uint64_t
+read_raw_uint(unsigned char const *buffer,
+              std::size_t size) {
+  auto value = uint64_t{};
+
+  for (auto idx = 0u; idx < std::min<std::size_t>(size, 8); ++idx)
+    value = (value << 8) | buffer[idx];
+
+  return value;
+}
+
+bool
+raw_block_t::parse(unsigned char const *buffer,
+                   std::size_t size) {
+  m_frames.clear();
+
+  auto length = std::size_t{};
+  if (!read_vint(buffer, size, length, m_track_number) || ((length + 3) > size))
+    return false;
+
+  m_relative_timecode = static_cast<int16_t>((buffer[length] << 8) | buffer[length + 1]);
+  m_flags             = buffer[length + 2];
+
+  auto pos    = length + 3;
+  auto lacing = (m_flags >> 1) & 0x03;
+
+  if (!lacing) {
+    m_frames.push_back({ pos, size - pos });
+    return true;
+  }
+
+  if (pos >= size)
+    return false;
+
+  auto num_frames = static_cast<std::size_t>(buffer[pos]) + 1;
+  auto sizes      = std::vector<uint64_t>{};
+  ++pos;
+
+  if (1 == lacing) {
+    // Xiph lacing
+    for (auto frame_idx = 1u; frame_idx < num_frames; ++frame_idx) {
+      auto frame_size = uint64_t{};
+
+      while (true) {
+        if (pos >= size)
+          return false;
+
+        frame_size += buffer[pos];
+        if (0xff != buffer[pos++])
+          break;
+      }
+
+      sizes.push_back(frame_size);
+    }
+
+  } else if ((3 == lacing) && (1 < num_frames)) {
+    // EBML lacing: the first size is coded as an unsigned number, all
+    // following ones as the signed difference to the previous size.
+    auto frame_size = uint64_t{};
+    if (!read_vint(buffer + pos, size - pos, length, frame_size))
+      return false;
+
+    sizes.push_back(frame_size);
+    pos += length;
+
+    for (auto frame_idx = 2u; frame_idx < num_frames; ++frame_idx) {
+      auto raw_difference = uint64_t{};
+      if (!read_vint(buffer + pos, size - pos, length, raw_difference))
+        return false;
+
+      auto difference = static_cast<int64_t>(raw_difference) - ((int64_t{1} << (length * 7 - 1)) - 1);
+      frame_size      = static_cast<uint64_t>(static_cast<int64_t>(frame_size) + difference);
+
+      sizes.push_back(frame_size);
+      pos += length;
+    }
+
+  } else if (2 == lacing) {
+    // Fixed lacing: all frames including the last one have the same
+    // size.
+    sizes.assign(num_frames, (size - pos) / num_frames);
+  }
+
+  for (auto frame_size : sizes) {
+    if (frame_size > (size - pos))
+      return false;
+
+    m_frames.push_back({ pos, static_cast<std::size_t>(frame_size) });
+    pos += frame_size;
+  }
+
+  if (2 != lacing)
+    m_frames.push_back({ pos, size - pos });
+
+  return true;
+}
+
+}}
@@ -0,0 +1,72 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for parsing raw Matroska elements and block headers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_BLOCK_PARSER_H
+#define MTX_COMMON_KAX_BLOCK_PARSER_H
+
+#include "common/common_pch.h"
+
+// Helpers for walking the content of a cluster that has been read
+// into memory without building libebml element trees for it. Only
+// elements with a known size are supported; the callers fall back to
+// libebml for everything else.
+namespace mtx { namespace kax {
+
+struct raw_element_t {
+  uint32_t m_id{};
+  std::size_t m_header_size{};
+  uint64_t m_data_size{};
+
+  uint64_t get_total_size() const {
+    return m_header_size + m_data_size;
+  }
+};
+
+// Reads an element's header from 'buffer'. Fails if the header is
+// invalid or if the size is unknown.
+bool read_raw_element_header(unsigned char const *buffer, std::size_t size, raw_element_t &element);
+
+// Same as read_raw_element_header() but also fails if the element's
+// data doesn't fit into 'size' bytes.
+bool read_raw_element(unsigned char const *buffer, std::size_t size, raw_element_t &element);
+
+// Reads the value of an unsigned integer element's data.
+uint64_t read_raw_uint(unsigned char const *buffer, std::size_t size);
+
+// The header of a Block or SimpleBlock and the positions of its
+// frames relative to the start of the block's data.
+struct raw_block_t {
+  struct frame_t {
+    std::size_t m_offset, m_size;
+  };
+
+  uint64_t m_track_number{};
+  int16_t m_relative_timecode{};
+  uint8_t m_flags{};
+  std::vector<frame_t> m_frames;
+
+  bool parse(unsigned char const *buffer, std::size_t size);
+
+  // Only valid for SimpleBlocks.
+  bool is_keyframe() const {
+    return (m_flags & 0x80) == 0x80;
+  }
+
+  bool is_discardable() const {
+    return (m_flags & 0x01) == 0x01;
+  }
+};
+
+}}
+
+#endif  // MTX_COMMON_KAX_BLOCK_PARSER_H
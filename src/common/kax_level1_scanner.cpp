@@ -0,0 +1,233 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   parallel scanner for level 1 elements of Matroska files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include "common/endian.h"
+#include "common/kax_level1_scanner.h"
+#include "common/mm_io_x.h"
+
+uint64_t const kax_level1_scanner_c::ms_min_range_size;
+
+kax_level1_scanner_c::kax_level1_scanner_c(std::string const &file_name,
+                                           uint64_t data_start,
+                                           uint64_t data_end,
+                                           std::vector<uint32_t> const &level1_ids,
+                                           uint32_t cluster_id)
+  : m_file_name{file_name}
+  , m_data_start{data_start}
+  , m_data_end{data_end}
+  , m_level1_ids{level1_ids}
+  , m_cluster_id{cluster_id}
+{
+}
+
+bool
+kax_level1_scanner_c::read_element_header(mm_io_c &in,
+                                          uint64_t pos,
+                                          entry_t &entry)
+  const {
+  unsigned char buffer[12];
+
+  in.setFilePointer(pos);
+  auto num_read = in.read(buffer, 12);
+  if (!num_read)
+    return false;
+
+  // EBML IDs are up to four bytes long including their length marker.
+  auto id_length = 1u;
+  while ((id_length <= 4) && !(buffer[0] & (0x80 >> (id_length - 1))))
+    ++id_length;
+
+  if ((id_length > 4) || (num_read <= id_length))
+    return false;
+
+  auto size_byte   = buffer[id_length];
+  auto size_length = 1u;
+  while ((size_length <= 8) && !(size_byte & (0x80 >> (size_length - 1))))
+    ++size_length;
+
+  if ((size_length > 8) || (num_read < (id_length + size_length)))
+    return false;
+
+  uint32_t id = 0;
+  for (auto idx = 0u; idx < id_length; ++idx)
+    id = (id << 8) | buffer[idx];
+
+  uint64_t size_mask = 0xff >> size_length;
+  uint64_t size      = size_byte & size_mask;
+  bool size_unknown  = size == size_mask;
+
+  for (auto idx = 1u; idx < size_length; ++idx) {
+    size          = (size << 8) | buffer[id_length + idx];
+    size_unknown &= buffer[id_length + idx] == 0xff;
+  }
+
+  entry = entry_t{ id, id_length, pos, static_cast<int64_t>(id_length + size_length + size), !size_unknown };
+
+  return true;
+}
+
+bool
+kax_level1_scanner_c::is_level1_element_at(mm_io_c &in,
+                                           uint64_t pos,
+                                           entry_t &entry)
+  const {
+  return read_element_header(in, pos, entry)
+      && entry.m_size_known
+      && brng::count(m_level1_ids, entry.m_id)
+      && ((pos + entry.m_size) <= m_data_end);
+}
+
+boost::optional<uint64_t>
+kax_level1_scanner_c::find_first_cluster(mm_io_c &in,
+                                         uint64_t start,
+                                         uint64_t end)
+  const {
+  uint64_t const chunk_size = 1024 * 1024;
+  auto buffer               = memory_c::alloc(chunk_size + 3);
+
+  for (auto chunk_start = start; chunk_start < end; chunk_start += chunk_size) {
+    in.setFilePointer(chunk_start);
+    auto num_read = in.read(buffer->get_buffer(), std::min<uint64_t>(chunk_size + 3, m_data_end - chunk_start));
+    auto ptr      = buffer->get_buffer();
+
+    for (auto idx = 0u; ((idx + 4) <= num_read) && ((chunk_start + idx) < end); ++idx) {
+      if (get_uint32_be(&ptr[idx]) != m_cluster_id)
+        continue;
+
+      // A cluster ID inside some payload is hardly ever followed by a
+      // size pointing to the start of another level 1 element.
+      auto candidate = chunk_start + idx;
+      entry_t cluster, next;
+
+      if (   is_level1_element_at(in, candidate, cluster)
+          && (   ((candidate + cluster.m_size) == m_data_end)
+              || is_level1_element_at(in, candidate + cluster.m_size, next)))
+        return candidate;
+    }
+  }
+
+  return boost::none;
+}
+
+kax_level1_scanner_c::range_result_t
+kax_level1_scanner_c::scan_range(uint64_t start,
+                                 uint64_t end,
+                                 bool resync)
+  const {
+  range_result_t result;
+  mm_file_io_c in{m_file_name};
+
+  auto pos = start;
+
+  if (resync) {
+    auto first_cluster = find_first_cluster(in, start, end);
+    if (!first_cluster) {
+      result.m_stop_pos = end;
+      result.m_complete = true;
+      return result;
+    }
+
+    pos = *first_cluster;
+  }
+
+  while ((pos < end) && (pos < m_data_end)) {
+    entry_t entry;
+
+    if (!is_level1_element_at(in, pos, entry)) {
+      result.m_stop_pos = pos;
+      return result;
+    }
+
+    result.m_entries.push_back(entry);
+    pos += entry.m_size;
+  }
+
+  result.m_stop_pos = pos;
+  result.m_complete = true;
+
+  return result;
+}
+
+std::vector<kax_level1_scanner_c::entry_t>
+kax_level1_scanner_c::scan(unsigned int num_threads,
+                           sequential_scanner_t const &sequential_scanner) {
+  auto data_size  = m_data_end - std::min(m_data_start, m_data_end);
+  auto num_ranges = std::min<uint64_t>(num_threads * 4, data_size / ms_min_range_size);
+
+  if ((2 > num_threads) || (2 > num_ranges))
+    return sequential_scanner(m_data_start, m_data_end).m_entries;
+
+  auto range_start = [this, data_size, num_ranges](uint64_t idx) {
+    return m_data_start + data_size * idx / num_ranges;
+  };
+
+  auto results = std::vector<range_result_t>(num_ranges);
+  std::atomic<uint64_t> next_range{0};
+
+  auto worker = [&]() {
+    while (true) {
+      auto idx = next_range++;
+      if (idx >= num_ranges)
+        return;
+
+      try {
+        results[idx] = scan_range(range_start(idx), range_start(idx + 1), 0 != idx);
+      } catch (mtx::mm_io::exception &) {
+      }
+    }
+  };
+
+  auto threads = std::vector<std::thread>{};
+  for (auto idx = 0u; idx < std::min<uint64_t>(num_threads, num_ranges); ++idx)
+    threads.emplace_back(worker);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  auto entries = std::vector<entry_t>{};
+  auto pos     = m_data_start;
+
+  for (auto idx = 0u; idx < num_ranges; ++idx) {
+    auto end = range_start(idx + 1);
+    if (pos >= end)
+      continue;
+
+    auto const &result = results[idx];
+    auto usable        = result.m_complete && !result.m_entries.empty() && (result.m_entries.front().m_pos == pos);
+
+    if (usable) {
+      brng::copy(result.m_entries, std::back_inserter(entries));
+      pos = result.m_stop_pos;
+      continue;
+    }
+
+    mxdebug_if(m_debug, boost::format("range %1% (%2%-%3%) not usable (complete %4% num_entries %5% expected start %6%); scanning sequentially\n")
+               % idx % range_start(idx) % end % result.m_complete % result.m_entries.size() % pos);
+
+    auto sequential_result = sequential_scanner(pos, end);
+    brng::copy(sequential_result.m_entries, std::back_inserter(entries));
+
+    if (sequential_result.m_stop_pos < end)
+      break;
+
+    pos = sequential_result.m_stop_pos;
+  }
+
+  mxdebug_if(m_debug, boost::format("found %1% elements in %2% ranges on %3% threads\n") % entries.size() % num_ranges % threads.size());
+
+  return entries;
+}
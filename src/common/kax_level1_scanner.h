@@ -0,0 +1,73 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   parallel scanner for level 1 elements of Matroska files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_LEVEL1_SCANNER_H
+#define MTX_COMMON_KAX_LEVEL1_SCANNER_H
+
+#include "common/common_pch.h"
+
+#include "common/kax_analyzer_index.h"
+
+// Finds the level 1 elements of a segment by splitting its data into
+// ranges that are scanned on several threads, each with a file handle
+// of its own.
+//
+// Apart from the first range, which starts at the segment's data
+// start, each range is resynced to the first cluster starting in it:
+// a cluster ID with a known size that is followed by another level 1
+// element or the segment's end. From there the elements are walked
+// until the range's end has been passed.
+//
+// The results are verified against each other: a range is only used
+// if the walk through the previous ranges ends exactly where the
+// range's first element starts. Otherwise, and for ranges whose walk
+// failed (unknown IDs, unknown sizes, damaged data), the range is
+// scanned again with the sequential scanner provided by the caller.
+class kax_level1_scanner_c {
+public:
+  using entry_t = kax_analyzer_index_c::entry_t;
+
+  struct range_result_t {
+    std::vector<entry_t> m_entries;
+    uint64_t m_stop_pos{};
+    bool m_complete{};
+  };
+
+  // Scans from 'start' until an element starting at or after 'end'
+  // is reached. 'm_stop_pos' must be that element's position, or less
+  // than 'end' if no further elements were found.
+  using sequential_scanner_t = std::function<range_result_t(uint64_t start, uint64_t end)>;
+
+  static uint64_t const ms_min_range_size = 16 * 1024 * 1024;
+
+protected:
+  std::string m_file_name;
+  uint64_t m_data_start, m_data_end;
+  std::vector<uint32_t> m_level1_ids;
+  uint32_t m_cluster_id;
+  debugging_option_c m_debug{"kax_level1_scanner"};
+
+public:
+  kax_level1_scanner_c(std::string const &file_name, uint64_t data_start, uint64_t data_end, std::vector<uint32_t> const &level1_ids, uint32_t cluster_id);
+
+  std::vector<entry_t> scan(unsigned int num_threads, sequential_scanner_t const &sequential_scanner);
+
+  range_result_t scan_range(uint64_t start, uint64_t end, bool resync) const;
+
+protected:
+  bool read_element_header(mm_io_c &in, uint64_t pos, entry_t &entry) const;
+  bool is_level1_element_at(mm_io_c &in, uint64_t pos, entry_t &entry) const;
+  boost::optional<uint64_t> find_first_cluster(mm_io_c &in, uint64_t start, uint64_t end) const;
+};
+
+#endif  // MTX_COMMON_KAX_LEVEL1_SCANNER_H
@@ -26,16 +26,35 @@ memory_c::resize(size_t new_size)
   if (new_size == its_counter->size)
     return;
 
-  if (its_counter->is_free) {
+  if (its_counter->is_free && (0 <= its_counter->pool_class)) {
+    // Pooled buffers have room up to the size of their class.
+    auto new_full_size = new_size + its_counter->offset;
+
+    if (new_full_size > mtx::mem::pool::get_class_size(its_counter->pool_class)) {
+      auto pool_class = -1;
+      auto tmp        = mtx::mem::pool::allocate(new_full_size, pool_class);
+      memcpy(tmp, its_counter->ptr, std::min(new_full_size, its_counter->size));
+      mtx::mem::pool::release(its_counter->ptr, its_counter->pool_class);
+
+      its_counter->ptr        = tmp;
+      its_counter->pool_class = pool_class;
+    }
+
+    its_counter->size = new_full_size;
+
+  } else if (its_counter->is_free) {
     its_counter->ptr  = (unsigned char *)saferealloc(its_counter->ptr, new_size + its_counter->offset);
     its_counter->size = new_size + its_counter->offset;
 
   } else {
     auto tmp = (unsigned char *)safemalloc(new_size);
     memcpy(tmp, its_counter->ptr + its_counter->offset, std::min(new_size, its_counter->size - its_counter->offset));
-    its_counter->ptr     = tmp;
-    its_counter->is_free = true;
-    its_counter->size    = new_size;
+    its_counter->ptr        = tmp;
+    its_counter->is_free    = true;
+    its_counter->pool_class = -1;
+    its_counter->size       = new_size;
+    its_counter->offset     = 0;
+    its_counter->owner.reset();
   }
 }
 
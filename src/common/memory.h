@@ -19,6 +19,7 @@
 #include <deque>
 
 #include "common/error.h"
+#include "common/memory_pool.h"
 
 namespace mtx {
   namespace mem {
@@ -103,6 +104,14 @@ public:
     release();
   }
 
+  static void *operator new(size_t size) {
+    return mtx::mem::object_pool_c<memory_c>::allocate(size);
+  }
+
+  static void operator delete(void *p, size_t size) {
+    mtx::mem::object_pool_c<memory_c>::release(p, size);
+  }
+
   memory_c(const memory_c &r) throw() {
     acquire(r.its_counter);
   }
@@ -150,19 +159,32 @@ public:
     return its_counter && its_counter->is_free;
   }
 
+  // Whether or not the buffer stays valid for as long as this object
+  // exists, either because it is owned or because it has been
+  // borrowed from an owner that is kept alive.
+  bool keeps_buffer_alive() const {
+    return its_counter && (its_counter->is_free || its_counter->owner);
+  }
+
+  // Makes sure the buffer stays valid once whoever provided it
+  // releases it. Only buffers that are neither owned nor borrowed are
+  // copied.
   void grab() {
-    if (!its_counter || its_counter->is_free)
+    if (!its_counter || keeps_buffer_alive())
       return;
 
-    its_counter->ptr      = static_cast<unsigned char *>(safememdup(get_buffer(), get_size()));
-    its_counter->is_free  = true;
-    its_counter->size    -= its_counter->offset;
-    its_counter->offset   = 0;
+    make_private_copy();
   }
 
   void lock() {
-    if (its_counter)
-      its_counter->is_free = false;
+    if (its_counter && its_counter->owner)
+      make_private_copy();
+
+    if (its_counter) {
+      // Whoever takes over the buffer will release it with free().
+      its_counter->is_free    = false;
+      its_counter->pool_class = -1;
+    }
   }
 
   void resize(size_t new_size) throw();
@@ -180,13 +202,27 @@ public:
 public:
   static memory_cptr
   alloc(size_t size) {
-    return memory_cptr(new memory_c(static_cast<unsigned char *>(safemalloc(size)), size, true));
+    auto pool_class = -1;
+    auto buffer     = mtx::mem::pool::allocate(size, pool_class);
+    auto memory     = memory_cptr(new memory_c(buffer, size, true));
+
+    if (memory->its_counter)
+      memory->its_counter->pool_class = pool_class;
+
+    return memory;
   };
 
   static inline memory_cptr
   clone(const void *buffer,
         size_t size) {
-    return memory_cptr(new memory_c(static_cast<unsigned char *>(safememdup(buffer, size)), size, true));
+    if (!buffer)
+      return memory_cptr(new memory_c);
+
+    auto memory = alloc(size);
+    if (size)
+      std::memcpy(memory->get_buffer(), buffer, size);
+
+    return memory;
   }
 
   static inline memory_cptr
@@ -199,6 +235,21 @@ public:
     return std::make_shared<memory_c>(reinterpret_cast<unsigned char *>(&buffer[0]), buffer.length(), false);
   }
 
+  // Refers to a part of a buffer owned by someone else, e.g. a chunk
+  // read from a file, without copying it. The owner is kept alive
+  // until the last reference to the returned object is gone.
+  static inline memory_cptr
+  borrow(std::shared_ptr<void> const &owner,
+         void *buffer,
+         size_t size) {
+    auto memory = memory_cptr(new memory_c(buffer, size, false));
+
+    if (memory->its_counter)
+      memory->its_counter->owner = owner;
+
+    return memory;
+  }
+
 private:
   struct counter {
     unsigned char *ptr;
@@ -206,6 +257,8 @@ private:
     bool is_free;
     unsigned count;
     size_t offset;
+    int pool_class;
+    std::shared_ptr<void> owner;
 
     counter(unsigned char *p = nullptr,
             size_t s = 0,
@@ -216,9 +269,27 @@ private:
       , is_free(f)
       , count(c)
       , offset(0)
+      , pool_class(-1)
     { }
+
+    static void *operator new(size_t size) {
+      return mtx::mem::object_pool_c<counter>::allocate(size);
+    }
+
+    static void operator delete(void *p, size_t size) {
+      mtx::mem::object_pool_c<counter>::release(p, size);
+    }
   } *its_counter;
 
+  void make_private_copy() {
+    its_counter->ptr         = static_cast<unsigned char *>(safememdup(get_buffer(), get_size()));
+    its_counter->is_free     = true;
+    its_counter->pool_class  = -1;
+    its_counter->size       -= its_counter->offset;
+    its_counter->offset      = 0;
+    its_counter->owner.reset();
+  }
+
   void acquire(counter *c) throw() { // increment the count
     its_counter = c;
     if (c)
@@ -229,7 +300,7 @@ private:
     if (its_counter) {
       if (--its_counter->count == 0) {
         if (its_counter->is_free)
-          free(its_counter->ptr);
+          mtx::mem::pool::release(its_counter->ptr, its_counter->pool_class);
         delete its_counter;
       }
       its_counter = 0;
@@ -0,0 +1,190 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   memory pools for frequently allocated objects and buffers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/memory_pool.h"
+
+namespace mtx { namespace mem { namespace pool {
+
+namespace {
+
+// Buffers are pooled in size classes that are powers of two from 64
+// bytes up to 8 MB. Larger requests are always passed on to the
+// system allocator.
+int const s_min_class_shift = 6;
+int const s_max_class_shift = 23;
+int const s_num_classes     = s_max_class_shift - s_min_class_shift + 1;
+
+// Upper limit for the memory kept around in each size class.
+std::size_t const s_max_bytes_per_class = 16 * 1024 * 1024;
+
+std::atomic<bool> s_enabled{false};
+
+struct size_class_t {
+  std::mutex m_mutex;
+  std::vector<unsigned char *> m_free_buffers;
+  std::size_t m_max_free_buffers{};
+  statistics_t m_statistics;
+};
+
+struct state_t {
+  std::vector<size_class_t> m_classes;
+  statistics_t m_unpooled;
+
+  std::mutex m_registry_mutex;
+  std::vector<statistics_t *> m_registry;
+
+  state_t()
+    : m_classes(s_num_classes)
+  {
+    m_unpooled.m_name = "buffers larger than the largest size class";
+
+    for (auto idx = 0; idx < s_num_classes; ++idx) {
+      auto &size_class                = m_classes[idx];
+      size_class.m_max_free_buffers   = std::max<std::size_t>(s_max_bytes_per_class / get_class_size(idx), 4);
+      size_class.m_statistics.m_name  = (boost::format("buffers of %1% bytes") % get_class_size(idx)).str();
+    }
+  }
+};
+
+state_t &
+get_state() {
+  // Never destroyed: buffers may still be released during static
+  // destruction.
+  static auto s_state = new state_t;
+  return *s_state;
+}
+
+int
+find_size_class(std::size_t size) {
+  auto shift = s_min_class_shift;
+  while ((shift <= s_max_class_shift) && ((static_cast<std::size_t>(1) << shift) < size))
+    ++shift;
+
+  return shift <= s_max_class_shift ? shift - s_min_class_shift : -1;
+}
+
+}
+
+void
+enable(bool enable) {
+  s_enabled = enable;
+}
+
+bool
+is_enabled() {
+  return s_enabled;
+}
+
+std::size_t
+get_class_size(int size_class) {
+  return static_cast<std::size_t>(1) << (size_class + s_min_class_shift);
+}
+
+unsigned char *
+allocate(std::size_t size,
+         int &size_class) {
+  auto &state = get_state();
+  size_class  = find_size_class(size);
+
+  if (-1 == size_class) {
+    ++state.m_unpooled.m_num_allocations;
+    return safemalloc(size);
+  }
+
+  auto &the_class = state.m_classes[size_class];
+  ++the_class.m_statistics.m_num_allocations;
+
+  if (!s_enabled) {
+    size_class = -1;
+    return safemalloc(size);
+  }
+
+  std::lock_guard<std::mutex> lock{the_class.m_mutex};
+
+  if (the_class.m_free_buffers.empty())
+    return safemalloc(get_class_size(size_class));
+
+  auto buffer = the_class.m_free_buffers.back();
+  the_class.m_free_buffers.pop_back();
+  ++the_class.m_statistics.m_num_reused;
+
+  return buffer;
+}
+
+void
+release(unsigned char *buffer,
+        int size_class) {
+  if (!buffer)
+    return;
+
+  if ((0 > size_class) || (s_num_classes <= size_class)) {
+    free(buffer);
+    return;
+  }
+
+  auto &the_class = get_state().m_classes[size_class];
+  ++the_class.m_statistics.m_num_released;
+
+  if (!s_enabled) {
+    free(buffer);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{the_class.m_mutex};
+
+  if (the_class.m_free_buffers.size() >= the_class.m_max_free_buffers) {
+    free(buffer);
+    return;
+  }
+
+  the_class.m_free_buffers.push_back(buffer);
+  ++the_class.m_statistics.m_num_recycled;
+}
+
+void
+register_statistics(statistics_t &statistics) {
+  auto &state = get_state();
+  std::lock_guard<std::mutex> lock{state.m_registry_mutex};
+
+  state.m_registry.push_back(&statistics);
+}
+
+void
+dump_statistics() {
+  static debugging_option_c s_debug{"memory_pool"};
+
+  if (!s_debug)
+    return;
+
+  auto &state = get_state();
+  auto dump   = [](statistics_t const &statistics) {
+    if (statistics.m_num_allocations)
+      mxdebug(boost::format("memory pool statistics for %1%: allocations %2% reused %3% released %4% recycled %5%\n")
+              % statistics.m_name % statistics.m_num_allocations.load() % statistics.m_num_reused.load() % statistics.m_num_released.load() % statistics.m_num_recycled.load());
+  };
+
+  mxdebug(boost::format("memory pools are %1%\n") % (s_enabled ? "enabled" : "disabled"));
+
+  for (auto &size_class : state.m_classes)
+    dump(size_class.m_statistics);
+
+  dump(state.m_unpooled);
+
+  std::lock_guard<std::mutex> lock{state.m_registry_mutex};
+  for (auto statistics : state.m_registry)
+    dump(*statistics);
+}
+
+}}}
@@ -0,0 +1,130 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   memory pools for frequently allocated objects and buffers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MEMORY_POOL_H
+#define MTX_COMMON_MEMORY_POOL_H
+
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+
+namespace mtx { namespace mem { namespace pool {
+
+// The pools are disabled by default. While they're disabled all
+// requests are passed on to the system allocator; only the
+// statistics are kept. Memory handed out by the pools can always be
+// released with free() or ::operator delete respectively.
+
+struct statistics_t {
+  std::string m_name;
+  std::atomic<uint64_t> m_num_allocations{}, m_num_reused{}, m_num_released{}, m_num_recycled{};
+};
+
+void enable(bool enable);
+bool is_enabled();
+
+unsigned char *allocate(std::size_t size, int &size_class);
+void release(unsigned char *buffer, int size_class);
+std::size_t get_class_size(int size_class);
+
+void register_statistics(statistics_t &statistics);
+void dump_statistics();
+
+}
+
+// Recycles memory for objects of type T. Meant to be used from
+// class-specific operator new and operator delete.
+template<typename T>
+class object_pool_c {
+private:
+  static std::size_t const s_max_free_objects = 4096;
+
+  struct state_t {
+    std::mutex m_mutex;
+    std::vector<void *> m_free_objects;
+    pool::statistics_t m_statistics;
+
+    state_t() {
+      m_statistics.m_name = typeid(T).name();
+      pool::register_statistics(m_statistics);
+    }
+  };
+
+  static state_t &
+  get_state() {
+    // Never destroyed: objects may still be released during static
+    // destruction.
+    static auto s_state = new state_t;
+    return *s_state;
+  }
+
+public:
+  static void *
+  allocate(std::size_t size) {
+    if (size != sizeof(T))
+      return ::operator new(size);
+
+    auto &state = get_state();
+    ++state.m_statistics.m_num_allocations;
+
+    if (!pool::is_enabled())
+      return ::operator new(size);
+
+    std::lock_guard<std::mutex> lock{state.m_mutex};
+
+    if (state.m_free_objects.empty())
+      return ::operator new(size);
+
+    auto object = state.m_free_objects.back();
+    state.m_free_objects.pop_back();
+    ++state.m_statistics.m_num_reused;
+
+    return object;
+  }
+
+  static void
+  release(void *object,
+          std::size_t size) {
+    if (!object)
+      return;
+
+    if (size != sizeof(T)) {
+      ::operator delete(object);
+      return;
+    }
+
+    auto &state = get_state();
+    ++state.m_statistics.m_num_released;
+
+    if (!pool::is_enabled()) {
+      ::operator delete(object);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock{state.m_mutex};
+
+    if (state.m_free_objects.size() >= s_max_free_objects) {
+      ::operator delete(object);
+      return;
+    }
+
+    state.m_free_objects.push_back(object);
+    ++state.m_statistics.m_num_recycled;
+  }
+};
+
+}}
+
+#endif // MTX_COMMON_MEMORY_POOL_H
@@ -26,8 +26,10 @@
 #include "common/endian.h"
 #include "common/error.h"
 #include "common/fs_sys_helpers.h"
+#include "common/hacks.h"
 #include "common/mm_io.h"
 #include "common/mm_io_x.h"
+#include "common/mm_mmap_io.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
 
@@ -197,6 +199,14 @@ mm_file_io_c::cleanup() {
 mm_io_cptr
 mm_file_io_c::open(const std::string &path,
                    const open_mode mode) {
+  if ((MODE_READ == mode) && hack_engaged(ENGAGE_MEMORY_MAPPED_INPUT)) {
+    try {
+      return mm_io_cptr(new mm_mmap_io_c(path));
+    } catch (mtx::mm_io::exception &) {
+      // Not a regular local file or mapping failed; read it normally.
+    }
+  }
+
   return mm_io_cptr(new mm_file_io_c(path, mode));
 }
 
@@ -1127,7 +1137,9 @@ mm_text_io_c::setFilePointer(int64 offset,
    Class for reading from stdin & writing to stdout.
 */
 
-mm_stdio_c::mm_stdio_c() {
+mm_stdio_c::mm_stdio_c(FILE *file)
+  : m_file{file}
+{
 }
 
 uint64
@@ -1152,7 +1164,7 @@ mm_stdio_c::_write(const void *buffer,
                    size_t size) {
   m_cached_size = -1;
 
-  return fwrite(buffer, 1, size, stdout);
+  return fwrite(buffer, 1, size, m_file);
 }
 #endif // defined(SYS_WINDOWS)
 
@@ -1162,5 +1174,5 @@ mm_stdio_c::close() {
 
 void
 mm_stdio_c::flush() {
-  fflush(stdout);
+  fflush(m_file);
 }
@@ -299,8 +299,12 @@ public:
 using mm_text_io_cptr = std::shared_ptr<mm_text_io_c>;
 
 class mm_stdio_c: public mm_io_c {
+protected:
+  FILE *m_file;
+
 public:
-  mm_stdio_c();
+  // Writes to the given stream, either stdout or stderr.
+  mm_stdio_c(FILE *file = stdout);
 
   virtual uint64 getFilePointer();
   virtual void setFilePointer(int64 offset, seek_mode mode=seek_beginning);
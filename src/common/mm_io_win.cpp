@@ -185,12 +185,13 @@ void
 mm_file_io_c::setup() {
 }
 
-static bool s_stdout_binmode_set = false;
+static bool s_binmode_set[2] = { false, false };
 
 size_t
 mm_stdio_c::_write(const void *buffer,
                    size_t size) {
-  HANDLE h_stdout = GetStdHandle(STD_OUTPUT_HANDLE);
+  auto is_stderr  = stderr == m_file;
+  HANDLE h_stdout = GetStdHandle(is_stderr ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
   if (INVALID_HANDLE_VALUE == h_stdout)
     return 0;
 
@@ -210,13 +211,13 @@ mm_stdio_c::_write(const void *buffer,
     return bytes_written;
   }
 
-  if (!s_stdout_binmode_set) {
-    _setmode(1, _O_BINARY);
-    s_stdout_binmode_set = true;
+  if (!s_binmode_set[is_stderr]) {
+    _setmode(_fileno(m_file), _O_BINARY);
+    s_binmode_set[is_stderr] = true;
   }
 
-  size_t bytes_written = fwrite(buffer, 1, size, stdout);
-  fflush(stdout);
+  size_t bytes_written = fwrite(buffer, 1, size, m_file);
+  fflush(m_file);
 
   m_cached_size = -1;
 
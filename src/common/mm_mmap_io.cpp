@@ -0,0 +1,164 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class implementation
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#if !defined(SYS_WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+# include <unistd.h>
+#endif
+
+#include "common/mm_io_x.h"
+#include "common/mm_mmap_io.h"
+
+mm_mmap_io_c::mm_mmap_io_c(std::string const &path)
+  : m_file_name{path}
+  , m_data{}
+  , m_size{}
+  , m_eof{}
+{
+#if defined(SYS_WINDOWS)
+  throw mtx::mm_io::open_x{std::make_error_code(std::errc::not_supported)};
+
+#else
+  auto local_path = g_cc_local_utf8->native(path);
+  auto fd         = ::open(local_path.c_str(), O_RDONLY);
+  if (-1 == fd)
+    throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
+
+  struct stat st;
+  if ((0 != fstat(fd, &st)) || !S_ISREG(st.st_mode) || (0 == st.st_size) || (static_cast<uint64_t>(st.st_size) > std::numeric_limits<std::size_t>::max())) {
+    ::close(fd);
+    throw mtx::mm_io::open_x{std::make_error_code(std::errc::not_supported)};
+  }
+
+  auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  auto code = mtx::mm_io::make_error_code();
+
+  // The mapping stays valid after the descriptor has been closed.
+  ::close(fd);
+
+  if (MAP_FAILED == data)
+    throw mtx::mm_io::open_x{code};
+
+  m_data = static_cast<unsigned char *>(data);
+  m_size = st.st_size;
+#endif
+}
+
+mm_mmap_io_c::~mm_mmap_io_c() {
+  close();
+}
+
+void
+mm_mmap_io_c::close() {
+#if !defined(SYS_WINDOWS)
+  if (m_data)
+    munmap(m_data, m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
+uint64
+mm_mmap_io_c::getFilePointer() {
+  return m_current_position;
+}
+
+void
+mm_mmap_io_c::setFilePointer(int64 offset,
+                             seek_mode mode) {
+  int64_t new_position = seek_beginning == mode ? offset
+                       : seek_end       == mode ? m_size             + offset
+                       :                          m_current_position + offset;
+
+  if (0 > new_position)
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_argument)};
+
+  m_current_position = std::min(new_position, m_size);
+  m_eof              = false;
+}
+
+uint32
+mm_mmap_io_c::_read(void *buffer,
+                    size_t size) {
+  auto available = static_cast<size_t>(std::max<int64_t>(m_size - m_current_position, 0));
+  if (available < size) {
+    size  = available;
+    m_eof = true;
+  }
+
+  if (size)
+    std::memcpy(buffer, m_data + m_current_position, size);
+
+  m_current_position += size;
+
+  return size;
+}
+
+memory_cptr
+mm_mmap_io_c::read(size_t size) {
+  if (static_cast<int64_t>(size) > (m_size - m_current_position)) {
+    m_current_position = m_size;
+    m_eof              = true;
+    throw mtx::mm_io::end_of_file_x{};
+  }
+
+  auto buffer = memory_c::clone(m_data + m_current_position, size);
+  m_current_position += size;
+
+  return buffer;
+}
+
+memory_cptr
+mm_mmap_io_c::read_view(size_t size) {
+  auto view           = get_view(m_current_position, size);
+  m_current_position += size;
+
+  return view;
+}
+
+memory_cptr
+mm_mmap_io_c::get_view(int64_t position,
+                       size_t size)
+  const {
+  if ((0 > position) || ((position + static_cast<int64_t>(size)) > m_size))
+    throw mtx::mm_io::end_of_file_x{};
+
+  return memory_cptr{new memory_c{m_data + position, size, false}};
+}
+
+size_t
+mm_mmap_io_c::_write(const void *,
+                     size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x{};
+}
+
+int64_t
+mm_mmap_io_c::get_size() {
+  return m_size;
+}
+
+bool
+mm_mmap_io_c::eof() {
+  return m_eof;
+}
+
+void
+mm_mmap_io_c::clear_eof() {
+  m_eof = false;
+}
@@ -0,0 +1,63 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_MMAP_IO_H
+#define MTX_COMMON_MM_MMAP_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+// Maps a local file read-only into memory and serves all reads and
+// seeks from that mapping without any system calls. Only regular,
+// non-empty files can be mapped; the constructor throws
+// mtx::mm_io::open_x otherwise so that callers can fall back to
+// mm_file_io_c.
+//
+// The views returned by read_view() and get_view() point directly
+// into the mapping. They must not be modified, and they're only valid
+// as long as this object hasn't been closed.
+class mm_mmap_io_c: public mm_io_c {
+protected:
+  std::string m_file_name;
+  unsigned char *m_data;
+  int64_t m_size;
+  bool m_eof;
+
+public:
+  mm_mmap_io_c(std::string const &path);
+  virtual ~mm_mmap_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual memory_cptr read(size_t size);
+  virtual int64_t get_size();
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual void close();
+
+  virtual std::string get_file_name() const {
+    return m_file_name;
+  }
+
+  memory_cptr read_view(size_t size);
+  memory_cptr get_view(int64_t position, size_t size) const;
+
+  using mm_io_c::read;
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif // MTX_COMMON_MM_MMAP_IO_H
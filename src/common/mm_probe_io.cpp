@@ -0,0 +1,143 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class implementation
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_probe_io.h"
+
+mm_probe_io_c::window_c::window_c(mm_io_cptr const &in,
+                                  std::size_t size)
+  : m_in{in}
+  , m_size{size}
+  , m_filled{}
+  , m_file_size{in->get_size()}
+{
+  m_size = std::min<std::size_t>(m_size, std::max<int64_t>(m_file_size, 0));
+
+  // The pages of the buffer are only touched once they're filled.
+  if (m_size)
+    m_data = memory_c::alloc(m_size);
+}
+
+void
+mm_probe_io_c::window_c::fill_up_to(std::size_t end) {
+  if (end <= m_filled)
+    return;
+
+  // Grow in large steps so that probes reading small pieces one after
+  // the other don't result in lots of small reads.
+  auto target = std::min(m_size, std::max({ end, 2 * m_filled, static_cast<std::size_t>(128 * 1024) }));
+
+  m_in->setFilePointer(m_filled);
+  auto num_read  = m_in->read(m_data->get_buffer() + m_filled, target - m_filled);
+  auto truncated = num_read < (target - m_filled);
+  m_filled      += num_read;
+
+  // The file is shorter than announced. Don't try again.
+  if (truncated)
+    m_size = m_filled;
+}
+
+std::size_t
+mm_probe_io_c::window_c::read(int64_t position,
+                              unsigned char *buffer,
+                              std::size_t size) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+
+  auto num_read = std::size_t{};
+
+  if (position < static_cast<int64_t>(m_size)) {
+    auto wanted = std::min<std::size_t>(size, m_size - position);
+    fill_up_to(position + wanted);
+
+    num_read = std::min<std::size_t>(wanted, m_filled - position);
+    std::memcpy(buffer, m_data->get_buffer() + position, num_read);
+
+    if ((num_read < wanted) || (num_read == size))
+      return num_read;
+  }
+
+  m_in->setFilePointer(position + num_read);
+  return num_read + m_in->read(buffer + num_read, size - num_read);
+}
+
+// ------------------------------------------------------------
+
+mm_probe_io_c::mm_probe_io_c(window_cptr const &window)
+  : m_window{window}
+  , m_eof{}
+{
+}
+
+mm_probe_io_c::~mm_probe_io_c() {
+  close();
+}
+
+void
+mm_probe_io_c::close() {
+  m_window.reset();
+}
+
+uint64
+mm_probe_io_c::getFilePointer() {
+  return m_current_position;
+}
+
+void
+mm_probe_io_c::setFilePointer(int64 offset,
+                              seek_mode mode) {
+  int64_t new_position = seek_beginning == mode ? offset
+                       : seek_end       == mode ? m_window->get_file_size() + offset
+                       :                          m_current_position        + offset;
+
+  if (0 > new_position)
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_argument)};
+
+  // Same as the buffered file I/O the probes used before.
+  m_current_position = std::min(new_position, m_window->get_file_size());
+  m_eof              = false;
+}
+
+uint32
+mm_probe_io_c::_read(void *buffer,
+                     size_t size) {
+  auto num_read = m_window->read(m_current_position, static_cast<unsigned char *>(buffer), size);
+  if (num_read < size)
+    m_eof = true;
+
+  m_current_position += num_read;
+
+  return num_read;
+}
+
+size_t
+mm_probe_io_c::_write(const void *,
+                      size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x{};
+}
+
+int64_t
+mm_probe_io_c::get_size() {
+  return m_window->get_file_size();
+}
+
+bool
+mm_probe_io_c::eof() {
+  return m_eof;
+}
+
+void
+mm_probe_io_c::clear_eof() {
+  m_eof = false;
+}
@@ -0,0 +1,81 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_PROBE_IO_H
+#define MTX_COMMON_MM_PROBE_IO_H
+
+#include "common/common_pch.h"
+
+#include <mutex>
+
+#include "common/mm_io.h"
+
+// Serves file type probing. All instances created for the same
+// window share one buffer holding the start of the file. That buffer
+// is read from the source file only once and on demand, no matter how
+// many probes seek back to the start and read the same data again.
+// Reads beyond the window are passed through to the source file.
+//
+// Each instance has its own file position. Instances sharing a window
+// may be used on different threads at the same time.
+class mm_probe_io_c: public mm_io_c {
+public:
+  class window_c {
+  protected:
+    std::mutex m_mutex;
+    mm_io_cptr m_in;
+    memory_cptr m_data;
+    std::size_t m_size, m_filled;
+    int64_t m_file_size;
+
+  public:
+    window_c(mm_io_cptr const &in, std::size_t size);
+
+    std::size_t read(int64_t position, unsigned char *buffer, std::size_t size);
+    int64_t get_file_size() const {
+      return m_file_size;
+    }
+    std::string get_file_name() const {
+      return m_in->get_file_name();
+    }
+
+  protected:
+    void fill_up_to(std::size_t end);
+  };
+  using window_cptr = std::shared_ptr<window_c>;
+
+protected:
+  window_cptr m_window;
+  bool m_eof;
+
+public:
+  mm_probe_io_c(window_cptr const &window);
+  virtual ~mm_probe_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual int64_t get_size();
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual void close();
+
+  virtual std::string get_file_name() const {
+    return m_window->get_file_name();
+  }
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif // MTX_COMMON_MM_PROBE_IO_H
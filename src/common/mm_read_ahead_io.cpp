@@ -0,0 +1,284 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class implementation
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_read_ahead_io.h"
+
+mm_read_ahead_io_c::mm_read_ahead_io_c(mm_io_c *in,
+                                       std::size_t block_size,
+                                       std::size_t max_blocks,
+                                       bool delete_in)
+  : mm_proxy_io_c{in, delete_in}
+  , m_block_size{block_size}
+  , m_max_blocks{std::max<std::size_t>(max_blocks, 1)}
+  , m_size{in->get_size()}
+  , m_cursor{}
+  , m_position{static_cast<int64_t>(in->getFilePointer())}
+  , m_worker_position{m_position}
+  , m_generation{}
+  , m_worker_done{}
+  , m_quit{}
+  , m_eof{}
+{
+  m_worker = std::thread{[this]() { run_worker(); }};
+}
+
+mm_read_ahead_io_c::~mm_read_ahead_io_c() {
+  close();
+}
+
+void
+mm_read_ahead_io_c::close() {
+  stop_worker();
+  mm_proxy_io_c::close();
+}
+
+void
+mm_read_ahead_io_c::stop_worker() {
+  if (!m_worker.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_quit = true;
+  }
+
+  m_worker_cond.notify_one();
+  m_worker.join();
+}
+
+void
+mm_read_ahead_io_c::run_worker() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  auto generation = m_generation - 1;
+  auto position   = int64_t{};
+
+  while (!m_quit) {
+    auto must_seek = false;
+
+    if (generation != m_generation) {
+      generation = m_generation;
+      position   = m_worker_position;
+      must_seek  = true;
+    }
+
+    if (m_worker_done || (m_blocks.size() >= m_max_blocks)) {
+      m_worker_cond.wait(lock);
+      continue;
+    }
+
+    // The proxied file is only ever accessed from this thread while
+    // the lock is released. The consumer only touches the queue.
+    lock.unlock();
+
+    auto block     = memory_cptr{};
+    auto exception = std::exception_ptr{};
+
+    try {
+      if (must_seek)
+        m_proxy_io->setFilePointer(position, seek_beginning);
+
+      block = memory_c::alloc(m_block_size);
+      block->set_size(m_proxy_io->read(block->get_buffer(), m_block_size));
+
+    } catch (...) {
+      exception = std::current_exception();
+    }
+
+    lock.lock();
+
+    // The consumer has seeked somewhere else in the meantime. Throw
+    // the block away and start over at the new position.
+    if (generation != m_generation)
+      continue;
+
+    if (exception) {
+      m_worker_exception = exception;
+      m_worker_done      = true;
+
+    } else {
+      auto num_read      = block->get_size();
+      position          += num_read;
+      m_worker_position  = position;
+      m_worker_done      = num_read < m_block_size;
+
+      if (num_read)
+        m_blocks.push_back(block);
+    }
+
+    m_consumer_cond.notify_one();
+  }
+}
+
+void
+mm_read_ahead_io_c::consume_front_block() {
+  // Keep the block around so that seeking back a bit doesn't restart
+  // the worker.
+  m_previous_block = m_blocks.front();
+  m_cursor         = 0;
+  m_blocks.pop_front();
+
+  m_worker_cond.notify_one();
+}
+
+void
+mm_read_ahead_io_c::restart_worker_at(int64_t position) {
+  m_blocks.clear();
+  m_previous_block.reset();
+  m_cursor           = 0;
+  m_position         = position;
+  m_worker_position  = position;
+  m_worker_done      = false;
+  m_worker_exception = nullptr;
+  ++m_generation;
+
+  m_worker_cond.notify_one();
+}
+
+uint64
+mm_read_ahead_io_c::getFilePointer() {
+  return m_position;
+}
+
+void
+mm_read_ahead_io_c::setFilePointer(int64 offset,
+                                   seek_mode mode) {
+  int64_t new_pos = seek_beginning == mode ? offset
+                  : seek_current   == mode ? m_position + offset
+                  :                          m_size     + offset;
+
+  if (0 > new_pos)
+    throw mtx::mm_io::seek_x{};
+
+  new_pos = std::min(new_pos, m_size);
+
+  std::lock_guard<std::mutex> lock{m_mutex};
+
+  m_eof = false;
+
+  if (new_pos == m_position)
+    return;
+
+  if (new_pos < m_position) {
+    auto to_rewind = m_position - new_pos;
+
+    if (to_rewind <= static_cast<int64_t>(m_cursor))
+      m_cursor -= to_rewind;
+
+    else if (m_previous_block && ((to_rewind - static_cast<int64_t>(m_cursor)) <= static_cast<int64_t>(m_previous_block->get_size()))) {
+      m_cursor = m_previous_block->get_size() - (to_rewind - m_cursor);
+      m_blocks.push_front(m_previous_block);
+      m_previous_block.reset();
+
+    } else {
+      restart_worker_at(new_pos);
+      return;
+    }
+
+    m_position = new_pos;
+    return;
+  }
+
+  // Seeking forward: drop the queued data in front of the new
+  // position as long as it is covered by what has been read already.
+  auto to_skip = new_pos - m_position;
+
+  while (!m_blocks.empty() && to_skip) {
+    auto available = static_cast<int64_t>(m_blocks.front()->get_size() - m_cursor);
+
+    if (to_skip < available) {
+      m_cursor += to_skip;
+      to_skip   = 0;
+      break;
+    }
+
+    to_skip -= available;
+    consume_front_block();
+  }
+
+  if (to_skip || (m_blocks.empty() && (new_pos != m_worker_position))) {
+    restart_worker_at(new_pos);
+    return;
+  }
+
+  m_position = new_pos;
+  m_worker_cond.notify_one();
+}
+
+int64_t
+mm_read_ahead_io_c::get_size() {
+  return m_size;
+}
+
+bool
+mm_read_ahead_io_c::eof() {
+  return m_eof;
+}
+
+void
+mm_read_ahead_io_c::clear_eof() {
+  m_eof = false;
+}
+
+uint32
+mm_read_ahead_io_c::_read(void *buffer,
+                          size_t size) {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  auto dst      = static_cast<unsigned char *>(buffer);
+  auto num_read = uint32_t{};
+
+  while (0 < size) {
+    if (m_blocks.empty()) {
+      if (m_worker_exception) {
+        auto exception     = m_worker_exception;
+        m_worker_exception = nullptr;
+        std::rethrow_exception(exception);
+      }
+
+      if (m_worker_done) {
+        m_eof = true;
+        break;
+      }
+
+      m_consumer_cond.wait(lock);
+      continue;
+    }
+
+    auto &block    = *m_blocks.front();
+    auto available = std::min(size, block.get_size() - m_cursor);
+
+    std::memcpy(dst, block.get_buffer() + m_cursor, available);
+
+    dst        += available;
+    size       -= available;
+    num_read   += available;
+    m_cursor   += available;
+    m_position += available;
+
+    if (m_cursor == block.get_size())
+      consume_front_block();
+  }
+
+  return num_read;
+}
+
+size_t
+mm_read_ahead_io_c::_write(const void *,
+                           size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x();
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_READ_AHEAD_IO_H
+#define MTX_COMMON_MM_READ_AHEAD_IO_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "common/mm_io.h"
+
+// Reads the proxied file sequentially on a background thread into a
+// bounded queue of blocks. The consumer is served from that queue and
+// only has to wait if the worker hasn't caught up yet. Seeking within
+// the queued data or back into the block consumed last doesn't touch
+// the file; seeking anywhere else discards the queue and restarts the
+// worker at the new position. Readers that seek around the file a lot
+// should therefore not be used with it.
+//
+// This only overlaps waiting for the storage with the consumer's work.
+// It doesn't parallelize any processing, and the data is copied once
+// more than without it: from the queued blocks into the consumer's
+// buffer.
+//
+// The proxied file must not be accessed by anyone else while this
+// object exists.
+class mm_read_ahead_io_c: public mm_proxy_io_c {
+protected:
+  std::size_t const m_block_size, m_max_blocks;
+  int64_t const m_size;
+
+  std::deque<memory_cptr> m_blocks;
+  memory_cptr m_previous_block;
+  std::size_t m_cursor;
+  int64_t m_position, m_worker_position;
+  unsigned int m_generation;
+  bool m_worker_done, m_quit, m_eof;
+  std::exception_ptr m_worker_exception;
+
+  std::mutex m_mutex;
+  std::condition_variable m_worker_cond, m_consumer_cond;
+  std::thread m_worker;
+
+public:
+  mm_read_ahead_io_c(mm_io_c *in, std::size_t block_size = 1 << 20, std::size_t max_blocks = 8, bool delete_in = true);
+  virtual ~mm_read_ahead_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual int64_t get_size();
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual void close();
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+
+  void run_worker();
+  void stop_worker();
+  void restart_worker_at(int64_t position);
+  void consume_front_block();
+};
+
+#endif // MTX_COMMON_MM_READ_AHEAD_IO_H
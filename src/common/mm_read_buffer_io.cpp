@@ -16,6 +16,7 @@
 
 #include "common/mm_io_x.h"
 #include "common/mm_read_buffer_io.h"
+#include "common/profiling.h"
 
 mm_read_buffer_io_c::mm_read_buffer_io_c(mm_io_c *in,
                                          size_t buffer_size,
@@ -28,14 +29,21 @@ mm_read_buffer_io_c::mm_read_buffer_io_c(mm_io_c *in,
   , m_fill(0)
   , m_offset(0)
   , m_size(buffer_size)
+  , m_initial_size(buffer_size)
+  , m_max_size(std::max<size_t>(buffer_size, 1 << 21))
+  , m_num_sequential_refills(0)
   , m_buffering(true)
   , m_debug_seek{"read_buffer_io|read_buffer_io_read"}
   , m_debug_read{"read_buffer_io|read_buffer_io_read"}
+  , m_debug_statistics{"read_buffer_io|read_buffer_io_statistics"}
 {
   setFilePointer(0, seek_beginning);
 }
 
 mm_read_buffer_io_c::~mm_read_buffer_io_c() {
+  if (m_debug_statistics)
+    dump_statistics();
+
   close();
 }
 
@@ -86,6 +94,12 @@ mm_read_buffer_io_c::setFilePointer(int64 offset,
 
   int64_t previous_pos = m_proxy_io->getFilePointer();
 
+  // Random access: large refills would mostly read data that's never
+  // used.
+  m_size                   = m_initial_size;
+  m_num_sequential_refills = 0;
+  ++m_statistics.m_num_seeks;
+
   // Actual seeking
   m_proxy_io->setFilePointer(std::min(new_pos, get_size()), seek_beginning);
 
@@ -107,14 +121,18 @@ mm_read_buffer_io_c::get_size() {
 uint32
 mm_read_buffer_io_c::_read(void *buffer,
                            size_t size) {
-  if (!m_buffering)
+  if (!m_buffering) {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::read_wait};
     return m_proxy_io->read(buffer, size);
+  }
+
+  char *buf       = static_cast<char *>(buffer);
+  uint32_t res    = 0;
+  auto refilled   = false;
 
-  char *buf    = static_cast<char *>(buffer);
-  uint32_t res = 0;
+  ++m_statistics.m_num_reads;
 
   while (0 < size) {
-    // TODO Directly write full blocks into the output buffer when size > m_size
     size_t avail = std::min(size, m_fill - m_cursor);
     if (avail) {
       memcpy(buf, m_buffer + m_cursor, avail);
@@ -123,8 +141,47 @@ mm_read_buffer_io_c::_read(void *buffer,
       size     -= avail;
       m_cursor += avail;
 
+      m_statistics.m_bytes_copied += avail;
+
+    } else if (size >= m_size) {
+      // The buffer is empty, and the rest of the request would fill
+      // it completely anyway: read directly into the caller's memory.
+      m_offset += m_cursor;
+      m_cursor  = 0;
+      m_fill    = 0;
+      avail     = std::min<int64_t>(get_size() - m_offset, size);
+
+      if (!avail) {
+        m_eof = true;
+        break;
+      }
+
+      auto num_read = uint32_t{};
+      {
+        mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::read_wait};
+        num_read = m_proxy_io->read(buf, avail);
+      }
+
+      m_offset      += num_read;
+      buf           += num_read;
+      res           += num_read;
+      size          -= num_read;
+      refilled       = true;
+
+      ++m_statistics.m_num_bypasses;
+      m_statistics.m_bytes_bypassed += num_read;
+
+      mxdebug_if(m_debug_read, boost::format("physical read bypassing the buffer from position %3% for %1% returned %2%\n") % avail % num_read % (m_offset - num_read));
+
+      if (num_read != avail) {
+        m_eof = true;
+        break;
+      }
+
     } else {
       // Refill the buffer
+      adjust_buffer_size_for_refill();
+
       m_offset += m_cursor;
       m_cursor  = 0;
       m_fill    = 0;
@@ -139,7 +196,16 @@ mm_read_buffer_io_c::_read(void *buffer,
 
       int64_t previous_pos = m_proxy_io->getFilePointer();
 
-      m_fill = m_proxy_io->read(m_buffer, avail);
+      {
+        mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::read_wait};
+        m_fill = m_proxy_io->read(m_buffer, avail);
+      }
+
+      refilled = true;
+
+      ++m_statistics.m_num_refills;
+      m_statistics.m_bytes_refilled += m_fill;
+
       mxdebug_if(m_debug_read, boost::format("physical read from position %3% for %1% returned %2%\n") % avail % m_fill % previous_pos);
       if (m_fill != avail) {
         m_eof = true;
@@ -149,9 +215,41 @@ mm_read_buffer_io_c::_read(void *buffer,
     }
   }
 
+  if (!refilled)
+    ++m_statistics.m_num_hits;
+
   return res;
 }
 
+void
+mm_read_buffer_io_c::adjust_buffer_size_for_refill() {
+  // Only called once the buffer has been consumed completely. Several
+  // refills in a row without seeking outside the buffer indicate
+  // sequential reading; larger blocks mean fewer physical reads then.
+  ++m_num_sequential_refills;
+
+  if ((2 > m_num_sequential_refills) || (m_size >= m_max_size))
+    return;
+
+  m_size                   = std::min(m_size * 2, m_max_size);
+  m_num_sequential_refills = 0;
+
+  if (m_af_buffer->get_size() < m_size) {
+    m_af_buffer->resize(m_size);
+    m_buffer = m_af_buffer->get_buffer();
+  }
+}
+
+void
+mm_read_buffer_io_c::dump_statistics()
+  const {
+  mxdebug(boost::format("read_buffer_io statistics for %1%: reads %2% hits %3% refills %4% bypasses %5% seeks %6%; bytes copied from buffer %7% refilled %8% bypassed %9%; buffer size %10% maximum %11%\n")
+          % m_proxy_io->get_file_name()
+          % m_statistics.m_num_reads % m_statistics.m_num_hits % m_statistics.m_num_refills % m_statistics.m_num_bypasses % m_statistics.m_num_seeks
+          % m_statistics.m_bytes_copied % m_statistics.m_bytes_refilled % m_statistics.m_bytes_bypassed
+          % m_size % m_af_buffer->get_size());
+}
+
 size_t
 mm_read_buffer_io_c::_write(const void *,
                             size_t) {
@@ -19,17 +19,30 @@
 
 #include "common/mm_io.h"
 
+// Reads from the proxied file in blocks. Reads that are at least as
+// large as the buffer bypass it and go straight into the caller's
+// memory. The buffer grows while the file is read sequentially and is
+// shrunk back to its initial size whenever the caller seeks outside
+// of it.
 class mm_read_buffer_io_c: public mm_proxy_io_c {
 protected:
+  struct statistics_t {
+    uint64_t m_num_reads{}, m_num_hits{}, m_num_refills{}, m_num_bypasses{}, m_num_seeks{};
+    uint64_t m_bytes_copied{}, m_bytes_refilled{}, m_bytes_bypassed{};
+  };
+
   memory_cptr m_af_buffer;
   unsigned char *m_buffer;
   size_t m_cursor;
   bool m_eof;
   size_t m_fill;
   int64_t m_offset;
-  const size_t m_size;
+  size_t m_size;
+  size_t const m_initial_size, m_max_size;
+  unsigned int m_num_sequential_refills;
   bool m_buffering;
-  debugging_option_c m_debug_seek, m_debug_read;
+  statistics_t m_statistics;
+  debugging_option_c m_debug_seek, m_debug_read, m_debug_statistics;
 
 public:
   mm_read_buffer_io_c(mm_io_c *in, size_t buffer_size = 1 << 12, bool delete_in = true);
@@ -45,6 +58,9 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+
+  void adjust_buffer_size_for_refill();
+  void dump_statistics() const;
 };
 
 using mm_read_buffer_io_cptr = std::shared_ptr<mm_read_buffer_io_c>;
@@ -0,0 +1,199 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#if defined(SYS_WINDOWS)
+# include <fcntl.h>
+# include <io.h>
+#endif
+
+#include "common/mm_io_x.h"
+#include "common/mm_sequential_read_io.h"
+
+int64_t const mm_sequential_read_io_c::ms_unknown_size;
+std::size_t const mm_sequential_read_io_c::ms_window_size;
+std::size_t const mm_sequential_read_io_c::ms_history_size;
+std::size_t const mm_sequential_read_io_c::ms_min_read_size;
+std::size_t const mm_sequential_read_io_c::ms_max_read_size;
+
+mm_sequential_read_io_c::mm_sequential_read_io_c(mm_io_c *in,
+                                                 std::size_t window_size)
+  : m_in{in}
+  , m_buffer{memory_c::alloc(ms_min_read_size)}
+  , m_buffer_start{}
+  , m_buffer_fill{}
+  , m_current_position{}
+  , m_window_size{window_size}
+  , m_streaming{}
+  , m_source_eof{}
+  , m_eof{}
+{
+}
+
+mm_sequential_read_io_c::~mm_sequential_read_io_c() {
+  close();
+}
+
+bool
+mm_sequential_read_io_c::is_sequential_source(std::string const &file_name) {
+  if (file_name == "-")
+    return true;
+
+  boost::system::error_code ec;
+  auto type = bfs::status(bfs::path{file_name}, ec).type();
+
+  return !ec && ((bfs::fifo_file == type) || (bfs::character_file == type));
+}
+
+mm_io_c *
+mm_sequential_read_io_c::open_source(std::string const &file_name) {
+  if (file_name != "-")
+    return new mm_file_io_c{file_name};
+
+#if defined(SYS_WINDOWS)
+  _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+  return new mm_stdio_c;
+}
+
+void
+mm_sequential_read_io_c::close() {
+  m_in.reset();
+  m_buffer.reset();
+}
+
+std::string
+mm_sequential_read_io_c::get_file_name()
+  const {
+  auto file_name = m_in ? m_in->get_file_name() : std::string{};
+  return file_name.empty() ? std::string{"-"} : file_name;
+}
+
+void
+mm_sequential_read_io_c::enable_streaming() {
+  m_streaming = true;
+}
+
+uint64
+mm_sequential_read_io_c::getFilePointer() {
+  return m_current_position;
+}
+
+void
+mm_sequential_read_io_c::setFilePointer(int64 offset,
+                                        seek_mode mode) {
+  if (seek_end == mode)
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_seek)};
+
+  int64_t new_position = seek_beginning == mode ? offset : static_cast<int64_t>(m_current_position) + offset;
+
+  if (0 > new_position)
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_argument)};
+
+  if (static_cast<uint64_t>(new_position) < m_buffer_start)
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_seek)};
+
+  m_current_position = new_position;
+  m_eof              = false;
+}
+
+int64_t
+mm_sequential_read_io_c::get_size() {
+  if (m_source_eof)
+    return m_buffer_start + m_buffer_fill;
+
+  return m_streaming ? ms_unknown_size : m_window_size;
+}
+
+bool
+mm_sequential_read_io_c::eof() {
+  return m_eof;
+}
+
+void
+mm_sequential_read_io_c::clear_eof() {
+  m_eof = false;
+}
+
+void
+mm_sequential_read_io_c::release_consumed_data() {
+  // The window must stay around until the reader has moved past it.
+  if (!m_streaming || (m_current_position <= m_window_size))
+    return;
+
+  auto keep_from = m_current_position - std::min<uint64_t>(m_current_position, ms_history_size);
+  auto to_drop   = std::min<uint64_t>(keep_from - std::min(keep_from, m_buffer_start), m_buffer_fill);
+
+  // Avoid moving the remaining data around for small gains.
+  if ((to_drop < ms_history_size) && (to_drop < m_buffer_fill))
+    return;
+
+  m_buffer_fill  -= to_drop;
+  m_buffer_start += to_drop;
+  std::memmove(m_buffer->get_buffer(), m_buffer->get_buffer() + to_drop, m_buffer_fill);
+
+  // Give back the memory the window occupied.
+  auto wanted_size = 2 * ms_history_size + ms_max_read_size;
+  if ((m_buffer->get_size() > 2 * wanted_size) && (m_buffer_fill <= wanted_size))
+    m_buffer->resize(wanted_size);
+}
+
+void
+mm_sequential_read_io_c::fill_up_to(uint64_t end) {
+  if (!m_streaming)
+    end = std::min<uint64_t>(end, m_window_size);
+
+  while (!m_source_eof && ((m_buffer_start + m_buffer_fill) < end)) {
+    release_consumed_data();
+
+    auto wanted = std::min<uint64_t>(std::max<uint64_t>(end - m_buffer_start - m_buffer_fill, ms_min_read_size), ms_max_read_size);
+    if (!m_streaming)
+      wanted = std::min<uint64_t>(wanted, m_window_size - m_buffer_fill);
+
+    if (m_buffer->get_size() < (m_buffer_fill + wanted))
+      m_buffer->resize(std::max<uint64_t>(m_buffer_fill + wanted, m_buffer->get_size() * 2));
+
+    auto num_read  = m_in->read(m_buffer->get_buffer() + m_buffer_fill, wanted);
+    m_buffer_fill += num_read;
+
+    if (!num_read)
+      m_source_eof = true;
+  }
+}
+
+uint32
+mm_sequential_read_io_c::_read(void *buffer,
+                               size_t size) {
+  fill_up_to(m_current_position + size);
+
+  auto buffer_end = m_buffer_start + m_buffer_fill;
+  auto num_read   = m_current_position < buffer_end ? std::min<uint64_t>(size, buffer_end - m_current_position) : 0;
+
+  if (num_read)
+    std::memcpy(buffer, m_buffer->get_buffer() + m_current_position - m_buffer_start, num_read);
+
+  if (num_read < size)
+    m_eof = true;
+
+  m_current_position += num_read;
+
+  return num_read;
+}
+
+size_t
+mm_sequential_read_io_c::_write(const void *,
+                                size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x{};
+}
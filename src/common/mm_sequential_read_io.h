@@ -0,0 +1,82 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_SEQUENTIAL_READ_IO_H
+#define MTX_COMMON_MM_SEQUENTIAL_READ_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+// Input from sources that cannot seek, e.g. pipes or the standard
+// input. Everything read from the start of the source up to the
+// window size is kept in memory so that file type probing and the
+// readers' header parsing can seek back to the start.
+//
+// While probing, reading is limited to the window so that a probe
+// cannot consume the whole source. Once streaming has been enabled,
+// reading continues sequentially beyond the window. After the reader
+// has moved past the window, only a bit of history before the current
+// position is kept for short seeks backwards. Seeking forward skips
+// the data in between. Seeking to data no longer kept and seeking
+// relative to the end throw a seek_x.
+class mm_sequential_read_io_c: public mm_io_c {
+public:
+  // Reported as the size until the end of the source has been reached.
+  static int64_t const ms_unknown_size  = 1ll << 50;
+  static std::size_t const ms_window_size = 64 * 1024 * 1024;
+
+protected:
+  static std::size_t const ms_history_size = 1024 * 1024, ms_min_read_size = 64 * 1024, ms_max_read_size = 4 * 1024 * 1024;
+
+  std::unique_ptr<mm_io_c> m_in;
+  memory_cptr m_buffer;
+  uint64_t m_buffer_start, m_buffer_fill, m_current_position;
+  std::size_t m_window_size;
+  bool m_streaming, m_source_eof, m_eof;
+
+public:
+  mm_sequential_read_io_c(mm_io_c *in, std::size_t window_size = ms_window_size);
+  virtual ~mm_sequential_read_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual int64_t get_size();
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual void close();
+
+  virtual std::string get_file_name() const;
+
+  std::size_t get_window_size() const {
+    return m_window_size;
+  }
+
+  // Lifts the restriction to the window. To be called once the file
+  // type has been determined.
+  void enable_streaming();
+
+  // Whether or not the file name refers to the standard input ("-"),
+  // a named pipe or a character device.
+  static bool is_sequential_source(std::string const &file_name);
+  static mm_io_c *open_source(std::string const &file_name);
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+
+  void fill_up_to(uint64_t end);
+  void release_consumed_data();
+};
+
+#endif // MTX_COMMON_MM_SEQUENTIAL_READ_IO_H
@@ -0,0 +1,57 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_sequential_write_io.h"
+
+mm_sequential_write_io_c::mm_sequential_write_io_c(mm_io_c *out,
+                                                   bool delete_out)
+  : mm_proxy_io_c(out, delete_out)
+  , m_current_position{}
+{
+}
+
+mm_io_c *
+mm_sequential_write_io_c::open(std::string const &file_name) {
+  if (file_name == "-")
+    return new mm_sequential_write_io_c{new mm_stdio_c};
+
+  return new mm_sequential_write_io_c{new mm_file_io_c{file_name, MODE_CREATE}};
+}
+
+uint64
+mm_sequential_write_io_c::getFilePointer() {
+  return m_current_position;
+}
+
+void
+mm_sequential_write_io_c::setFilePointer(int64 offset,
+                                         seek_mode mode) {
+  // Everything written so far is the whole file. Therefore the current
+  // position and the end of the file are the same.
+  auto new_pos = seek_beginning == mode ? offset : static_cast<int64>(m_current_position) + offset;
+
+  if (new_pos != static_cast<int64>(m_current_position))
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_seek)};
+}
+
+size_t
+mm_sequential_write_io_c::_write(const void *buffer,
+                                 size_t size) {
+  auto bytes_written  = mm_proxy_io_c::_write(buffer, size);
+  m_current_position += bytes_written;
+
+  return bytes_written;
+}
@@ -0,0 +1,42 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_SEQUENTIAL_WRITE_IO_H
+#define MTX_COMMON_MM_SEQUENTIAL_WRITE_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+// Output to destinations that cannot seek, e.g. pipes or the standard
+// output. The position is tracked by counting the bytes written. Any
+// attempt to seek anywhere but the current position throws a seek_x.
+class mm_sequential_write_io_c: public mm_proxy_io_c {
+protected:
+  uint64_t m_current_position;
+
+public:
+  mm_sequential_write_io_c(mm_io_c *out, bool delete_out = true);
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+
+  // Opens the standard output for the file name "-" and the named
+  // file otherwise.
+  static mm_io_c *open(std::string const &file_name);
+
+protected:
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif // MTX_COMMON_MM_SEQUENTIAL_WRITE_IO_H
@@ -16,6 +16,7 @@
 
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/profiling.h"
 
 mm_write_buffer_io_c::mm_write_buffer_io_c(mm_io_c *out,
                                            size_t buffer_size,
@@ -27,27 +28,64 @@ mm_write_buffer_io_c::mm_write_buffer_io_c(mm_io_c *out,
   , m_size(buffer_size)
   , m_debug_seek{ "write_buffer_io|write_buffer_io_read"}
   , m_debug_write{"write_buffer_io|write_buffer_io_write"}
+  , m_max_queued_buffers{}
+  , m_queued_end_position{}
+  , m_writer_busy{}
+  , m_writer_quit{}
 {
 }
 
 mm_write_buffer_io_c::~mm_write_buffer_io_c() {
-  close();
+  // Write errors are only reported by explicit calls to close() or
+  // flush(); users must close the file themselves unless its content
+  // has been discarded. Throwing from a destructor would terminate the
+  // program.
+  try {
+    close();
+  } catch (...) {
+  }
 }
 
 mm_io_cptr
 mm_write_buffer_io_c::open(const std::string &file_name,
-                           size_t buffer_size) {
-  return mm_io_cptr(new mm_write_buffer_io_c(new mm_file_io_c(file_name, MODE_CREATE), buffer_size));
+                           size_t buffer_size,
+                           bool write_behind) {
+  auto out = std::make_shared<mm_write_buffer_io_c>(new mm_file_io_c(file_name, MODE_CREATE), buffer_size);
+  if (write_behind)
+    out->enable_write_behind();
+
+  return out;
+}
+
+void
+mm_write_buffer_io_c::enable_write_behind(size_t max_queued_buffers) {
+  if (m_writer.joinable())
+    return;
+
+  flush_buffer();
+
+  m_max_queued_buffers  = std::max<size_t>(max_queued_buffers, 1);
+  m_queued_end_position = mm_proxy_io_c::getFilePointer();
+  m_writer_quit         = false;
+  m_writer              = std::thread{[this]() { run_writer(); }};
 }
 
 uint64
 mm_write_buffer_io_c::getFilePointer() {
+  // The proxied file is owned by the writer thread while buffers are
+  // queued. Therefore the position must be tracked here.
+  if (m_writer.joinable())
+    return m_queued_end_position + m_fill;
+
   return mm_proxy_io_c::getFilePointer() + m_fill;
 }
 
 void
 mm_write_buffer_io_c::setFilePointer(int64 offset,
                                      seek_mode mode) {
+  if (seek_end == mode)
+    wait_for_writer();
+
   int64_t new_pos
     = seek_beginning == mode ? offset
     : seek_end       == mode ? m_proxy_io->get_size() + offset // offsets from the end are negative already
@@ -57,6 +95,7 @@ mm_write_buffer_io_c::setFilePointer(int64 offset,
     return;
 
   flush_buffer();
+  wait_for_writer();
 
   if (m_debug_seek) {
     int64_t previous_pos = mm_proxy_io_c::getFilePointer();
@@ -64,25 +103,52 @@ mm_write_buffer_io_c::setFilePointer(int64 offset,
   }
 
   mm_proxy_io_c::setFilePointer(offset, mode);
+
+  m_queued_end_position = mm_proxy_io_c::getFilePointer();
 }
 
 void
 mm_write_buffer_io_c::flush() {
   flush_buffer();
+  wait_for_writer();
   mm_proxy_io_c::flush();
 }
 
 void
 mm_write_buffer_io_c::close() {
-  flush_buffer();
+  // The writer thread must be stopped even if the last buffer cannot
+  // be written.
+  auto exception = std::exception_ptr{};
+
+  try {
+    flush_buffer();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  try {
+    stop_writer();
+  } catch (...) {
+    if (!exception)
+      exception = std::current_exception();
+  }
+
   mm_proxy_io_c::close();
+
+  if (exception)
+    std::rethrow_exception(exception);
 }
 
 uint32
 mm_write_buffer_io_c::_read(void *buffer,
                             size_t size) {
   flush_buffer();
-  return mm_proxy_io_c::_read(buffer, size);
+  wait_for_writer();
+
+  auto num_read         = mm_proxy_io_c::_read(buffer, size);
+  m_queued_end_position = mm_proxy_io_c::getFilePointer();
+
+  return num_read;
 }
 
 size_t
@@ -103,9 +169,22 @@ mm_write_buffer_io_c::_write(const void *buffer,
       remain -= avail;
       buf    += avail;
 
+    } else if (m_writer.joinable()) {
+      // The writer thread owns the proxied file; hand whole blocks
+      // over to it, too.
+      memcpy(m_buffer, buf, m_size);
+      m_fill  = m_size;
+      flush_buffer();
+      remain -= m_size;
+      buf    += m_size;
+
     } else {
       // write whole blocks, skipping the buffer
-      avail = mm_proxy_io_c::_write(buf, m_size);
+      {
+        mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::write_wait};
+        avail = mm_proxy_io_c::_write(buf, m_size);
+      }
+
       if (avail != m_size)
         throw mtx::mm_io::insufficient_space_x();
 
@@ -129,9 +208,19 @@ mm_write_buffer_io_c::flush_buffer() {
   if (!m_fill)
     return;
 
-  size_t written = mm_proxy_io_c::_write(m_buffer, m_fill);
-  size_t fill    = m_fill;
-  m_fill         = 0;
+  if (m_writer.joinable()) {
+    queue_buffer();
+    return;
+  }
+
+  size_t written = 0;
+  {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::write_wait};
+    written = mm_proxy_io_c::_write(m_buffer, m_fill);
+  }
+
+  size_t fill = m_fill;
+  m_fill      = 0;
 
   mxdebug_if(m_debug_write, boost::format("flush_buffer() at %1% for %2% written %3%\n") % (mm_proxy_io_c::getFilePointer() - written) % fill % written);
 
@@ -142,4 +231,133 @@ mm_write_buffer_io_c::flush_buffer() {
 void
 mm_write_buffer_io_c::discard_buffer() {
   m_fill = 0;
+
+  if (!m_writer.joinable())
+    return;
+
+  std::lock_guard<std::mutex> lock{m_writer_mutex};
+
+  m_queued_buffers.clear();
+  m_writer_exception = nullptr;
+}
+
+void
+mm_write_buffer_io_c::queue_buffer() {
+  std::unique_lock<std::mutex> lock{m_writer_mutex};
+
+  if (m_writer_exception)
+    std::rethrow_exception(m_writer_exception);
+
+  mxdebug_if(m_debug_write, boost::format("queue_buffer() at %1% for %2% already queued %3%\n") % m_queued_end_position % m_fill % m_queued_buffers.size());
+
+  m_queued_buffers.emplace_back(m_af_buffer, m_fill);
+  m_queued_end_position += m_fill;
+  m_writer_cond.notify_one();
+
+  // Bound the amount of memory used by waiting for the writer to
+  // catch up.
+  {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::write_wait};
+    m_writer_done_cond.wait(lock, [this]() { return m_queued_buffers.size() < m_max_queued_buffers; });
+  }
+
+  if (m_free_buffers.empty())
+    m_af_buffer = memory_c::alloc(m_size);
+
+  else {
+    m_af_buffer = m_free_buffers.back();
+    m_free_buffers.pop_back();
+  }
+
+  m_buffer = m_af_buffer->get_buffer();
+  m_fill   = 0;
+}
+
+void
+mm_write_buffer_io_c::wait_for_writer() {
+  if (!m_writer.joinable())
+    return;
+
+  std::unique_lock<std::mutex> lock{m_writer_mutex};
+
+  {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::write_wait};
+    m_writer_done_cond.wait(lock, [this]() { return m_queued_buffers.empty() && !m_writer_busy; });
+  }
+
+  if (!m_writer_exception)
+    return;
+
+  auto exception     = m_writer_exception;
+  m_writer_exception = nullptr;
+
+  std::rethrow_exception(exception);
+}
+
+void
+mm_write_buffer_io_c::stop_writer() {
+  if (!m_writer.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{m_writer_mutex};
+    m_writer_quit = true;
+  }
+
+  m_writer_cond.notify_one();
+  m_writer.join();
+
+  m_free_buffers.clear();
+
+  if (!m_writer_exception)
+    return;
+
+  auto exception     = m_writer_exception;
+  m_writer_exception = nullptr;
+
+  std::rethrow_exception(exception);
+}
+
+void
+mm_write_buffer_io_c::run_writer() {
+  std::unique_lock<std::mutex> lock{m_writer_mutex};
+
+  while (true) {
+    m_writer_cond.wait(lock, [this]() { return !m_queued_buffers.empty() || m_writer_quit; });
+
+    if (m_queued_buffers.empty())
+      break;
+
+    auto buffer = m_queued_buffers.front();
+    m_queued_buffers.pop_front();
+    m_writer_busy = true;
+
+    lock.unlock();
+
+    auto exception = std::exception_ptr{};
+
+    try {
+      // Bypass mm_proxy_io_c::_write() as it modifies members that
+      // belong to the main thread.
+      auto written = m_proxy_io->write(buffer.first->get_buffer(), buffer.second);
+      if (written != buffer.second)
+        throw mtx::mm_io::insufficient_space_x();
+
+    } catch (...) {
+      exception = std::current_exception();
+    }
+
+    lock.lock();
+
+    m_writer_busy = false;
+    m_free_buffers.push_back(buffer.first);
+
+    // Nothing queued after a failed write can be written properly.
+    if (exception) {
+      m_writer_exception = exception;
+      m_queued_buffers.clear();
+    }
+
+    m_writer_done_cond.notify_all();
+  }
 }
@@ -17,6 +17,12 @@
 
 #include "common/common_pch.h"
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include "common/mm_io.h"
 
 class mm_write_buffer_io_c: public mm_proxy_io_c {
@@ -27,6 +33,18 @@ protected:
   const size_t m_size;
   debugging_option_c m_debug_seek, m_debug_write;
 
+  // Write-behind mode: full buffers are handed over to a writer
+  // thread instead of being written synchronously.
+  std::thread m_writer;
+  std::mutex m_writer_mutex;
+  std::condition_variable m_writer_cond, m_writer_done_cond;
+  std::deque<std::pair<memory_cptr, size_t>> m_queued_buffers;
+  std::vector<memory_cptr> m_free_buffers;
+  size_t m_max_queued_buffers;
+  int64_t m_queued_end_position;
+  bool m_writer_busy, m_writer_quit;
+  std::exception_ptr m_writer_exception;
+
 public:
   mm_write_buffer_io_c(mm_io_c *out, size_t buffer_size, bool delete_out = true);
   virtual ~mm_write_buffer_io_c();
@@ -37,12 +55,19 @@ public:
   virtual void close();
   virtual void discard_buffer();
 
-  static mm_io_cptr open(const std::string &file_name, size_t buffer_size);
+  virtual void enable_write_behind(size_t max_queued_buffers = 2);
+
+  static mm_io_cptr open(const std::string &file_name, size_t buffer_size, bool write_behind = false);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
   virtual void flush_buffer();
+
+  void queue_buffer();
+  void wait_for_writer();
+  void stop_writer();
+  void run_writer();
 };
 using mm_write_buffer_io_cptr = std::shared_ptr<mm_write_buffer_io_c>;
 
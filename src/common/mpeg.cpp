@@ -16,6 +16,11 @@
 #include "common/endian.h"
 #include "common/mpeg.h"
 
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+# define MTX_MPEG_START_CODE_SSE2
+# include <emmintrin.h>
+#endif
+
 namespace mtx { namespace mpeg {
 
 memory_cptr
@@ -124,4 +129,141 @@ remove_trailing_zero_bytes(memory_c &buffer) {
   mxdebug_if(s_debug_trailing_zero_byte_removal, boost::format("Removing trailing zero bytes from old size %1% down to new size %2%, removed %3%\n") % size % new_size % idx);
 }
 
+unsigned char const *
+find_start_code(unsigned char const *begin,
+                unsigned char const *end) {
+  auto p = begin;
+
+#if defined(MTX_MPEG_START_CODE_SSE2)
+  // Compare 16 candidate positions at once: byte i and i + 1 must be
+  // zero and byte i + 2 must be one.
+  auto zeros = _mm_setzero_si128();
+  auto ones  = _mm_set1_epi8(1);
+
+  while ((p + 16 + 2) <= end) {
+    auto b0   = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+    auto b1   = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 1));
+    auto b2   = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 2));
+    auto mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zeros), _mm_cmpeq_epi8(b1, zeros)), _mm_cmpeq_epi8(b2, ones)));
+
+    if (mask)
+      return p + __builtin_ctz(mask);
+
+    p += 16;
+  }
+
+#else
+  // Skip four bytes at a time as long as none of them is zero.
+  while ((p + 4 + 2) <= end) {
+    uint32_t word;
+    std::memcpy(&word, p, 4);
+
+    if (!((word - 0x01010101u) & ~word & 0x80808080u)) {
+      p += 4;
+      continue;
+    }
+
+    if (!p[0] && !p[1] && (1 == p[2]))
+      return p;
+
+    ++p;
+  }
+#endif
+
+  for (; (p + 3) <= end; ++p)
+    if (!p[0] && !p[1] && (1 == p[2]))
+      return p;
+
+  return end;
+}
+
+void
+split_into_nalus(memory_cptr &unparsed_buffer,
+                 uint64_t &parsed_position,
+                 unsigned char const *buffer,
+                 std::size_t size,
+                 nalu_handler_t const &handle_nalu) {
+  uint64_t previous_parsed_pos = parsed_position;
+  auto num_unparsed            = unparsed_buffer ? unparsed_buffer->get_size() : 0;
+  auto data                    = buffer;
+  auto data_size               = size;
+
+  // Search one contiguous block so that start codes crossing the
+  // boundary between the old and the new data are found.
+  if (num_unparsed) {
+    unparsed_buffer->resize(num_unparsed + size);
+    std::memcpy(unparsed_buffer->get_buffer() + num_unparsed, buffer, size);
+    data      = unparsed_buffer->get_buffer();
+    data_size = num_unparsed + size;
+  }
+
+  // All positions in the unparsed data but the last two have already
+  // been searched.
+  int previous_pos         = -1;
+  int previous_marker_size = 0;
+  auto search_from         = data;
+
+  if (3 <= num_unparsed) {
+    if (!data[0] && !data[1] && (1 == data[2]))
+      previous_marker_size = 3;
+    else if ((4 <= num_unparsed) && (0x00000001 == get_uint32_be(data)))
+      previous_marker_size = 4;
+
+    if (previous_marker_size)
+      previous_pos = 0;
+
+    search_from = data + std::max<std::size_t>(previous_marker_size, num_unparsed - 2);
+  }
+
+  auto end = data + data_size;
+
+  for (auto p = find_start_code(search_from, end); p != end; p = find_start_code(p + 3, end)) {
+    int marker_pos  = p - data;
+    int marker_size = 3;
+
+    if ((marker_pos > std::max(previous_pos + previous_marker_size, 0)) && !data[marker_pos - 1]) {
+      --marker_pos;
+      marker_size = 4;
+    }
+
+    if (-1 != previous_pos) {
+      auto nalu       = memory_c::clone(data + previous_pos + previous_marker_size, marker_pos - previous_pos - previous_marker_size);
+      parsed_position = previous_parsed_pos + previous_pos;
+
+      remove_trailing_zero_bytes(*nalu);
+      if (nalu->get_size())
+        handle_nalu(nalu, parsed_position);
+    }
+
+    previous_pos         = marker_pos;
+    previous_marker_size = marker_size;
+  }
+
+  if (-1 == previous_pos)
+    previous_pos = 0;
+
+  parsed_position = previous_parsed_pos + previous_pos;
+
+  auto new_size = data_size - previous_pos;
+  if (!new_size)
+    unparsed_buffer.reset();
+
+  else if ((data == buffer) || (0 != previous_pos))
+    unparsed_buffer = memory_c::clone(data + previous_pos, new_size);
+}
+
+void
+flush_nalus(memory_cptr &unparsed_buffer,
+            uint64_t &parsed_position,
+            nalu_handler_t const &handle_nalu) {
+  if (unparsed_buffer && (5 <= unparsed_buffer->get_size())) {
+    parsed_position += unparsed_buffer->get_size();
+    auto marker_size = get_uint32_be(unparsed_buffer->get_buffer()) == 0x00000001 ? 4 : 3;
+    auto nalu_size   = unparsed_buffer->get_size() - marker_size;
+    handle_nalu(memory_c::clone(unparsed_buffer->get_buffer() + marker_size, nalu_size), parsed_position - nalu_size);
+  }
+
+  unparsed_buffer.reset();
+}
+
 }}
@@ -49,6 +49,32 @@ memory_cptr create_nalu_with_size(memory_cptr const &src, std::size_t nalu_size_
 
 void remove_trailing_zero_bytes(memory_c &buffer);
 
+// Returns a pointer to the first "00 00 01" start code prefix in
+// [begin, end) or end if there's none.
+unsigned char const *find_start_code(unsigned char const *begin, unsigned char const *end);
+inline unsigned char *
+find_start_code(unsigned char *begin,
+                unsigned char *end) {
+  return const_cast<unsigned char *>(find_start_code(static_cast<unsigned char const *>(begin), static_cast<unsigned char const *>(end)));
+}
+
+// Splitting an elementary stream with "00 00 01" or "00 00 00 01"
+// start codes into NALUs as used by the AVC and HEVC parsers. The
+// stream is fed in arbitrary chunks. unparsed_buffer holds the data
+// that hasn't been handed out yet. Unless no start code has been found
+// so far it starts with the start code of the NALU that is still
+// incomplete; parsed_position is that start code's position in the
+// stream. Complete NALUs are passed to handle_nalu without their start
+// code and trailing zero bytes together with the position of their
+// start code.
+using nalu_handler_t = std::function<void(memory_cptr const &nalu, uint64_t position)>;
+
+void split_into_nalus(memory_cptr &unparsed_buffer, uint64_t &parsed_position, unsigned char const *buffer, std::size_t size, nalu_handler_t const &handle_nalu);
+
+// Hands out the remaining incomplete NALU at the end of the stream. Its
+// position is the one of the NALU itself, not of its start code.
+void flush_nalus(memory_cptr &unparsed_buffer, uint64_t &parsed_position, nalu_handler_t const &handle_nalu);
+
 }}
 
 #endif  // MTX_COMMON_MPEG_COMMON_H
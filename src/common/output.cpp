@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <mutex>
 #include <sstream>
 
 #include "common/command_line.h"
@@ -40,6 +41,9 @@ std::shared_ptr<mm_io_c> g_mm_stdio   = std::shared_ptr<mm_io_c>(new mm_stdio_c)
 static mxmsg_handler_t s_mxmsg_info_handler, s_mxmsg_warning_handler, s_mxmsg_error_handler;
 static std::vector<std::string> s_warnings_emitted, s_errors_emitted;
 
+// Messages may be output from worker threads, too.
+static std::recursive_mutex s_output_mutex;
+
 static nlohmann::json
 to_json_array(std::vector<std::string> const &messages) {
   auto result = nlohmann::json::array();
@@ -50,12 +54,17 @@ to_json_array(std::vector<std::string> const &messages) {
   return result;
 }
 
-void
-display_json_output(nlohmann::json json) {
+nlohmann::json
+add_warnings_and_errors_to_json(nlohmann::json json) {
   json["warnings"] = to_json_array(s_warnings_emitted);
   json["errors"]   = to_json_array(s_errors_emitted);
 
-  mxinfo(boost::format("%1%\n") % mtx::json::dump(json, 2));
+  return json;
+}
+
+void
+display_json_output(nlohmann::json json) {
+  mxinfo(boost::format("%1%\n") % mtx::json::dump(add_warnings_and_errors_to_json(json), 2));
 }
 
 static void
@@ -112,6 +121,8 @@ mxmsg(unsigned int level,
   if (g_suppress_info && (MXMSG_INFO == level))
     return;
 
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   if ('\n' == message[0]) {
     message.erase(0, 1);
     g_mm_stdio->puts("\n");
@@ -158,6 +169,10 @@ default_mxinfo(unsigned int,
 
 void
 mxinfo(std::string const &info) {
+  auto worker_messages = mtx::output::worker_messages_c::current();
+  if (worker_messages && worker_messages->handle(MXMSG_INFO, info))
+    return;
+
   if (s_mxmsg_info_handler)
     s_mxmsg_info_handler(MXMSG_INFO, info);
 }
@@ -178,6 +193,8 @@ default_mxwarn(unsigned int,
   if (g_suppress_warnings)
     return;
 
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   mxmsg(MXMSG_WARNING, warning);
 
   g_warning_issued = true;
@@ -185,6 +202,10 @@ default_mxwarn(unsigned int,
 
 void
 mxwarn(std::string const &warning) {
+  auto worker_messages = mtx::output::worker_messages_c::current();
+  if (worker_messages && worker_messages->handle(MXMSG_WARNING, warning))
+    return;
+
   if (s_mxmsg_warning_handler)
     s_mxmsg_warning_handler(MXMSG_WARNING, warning);
 }
@@ -198,10 +219,63 @@ default_mxerror(unsigned int,
 
 void
 mxerror(std::string const &error) {
+  auto worker_messages = mtx::output::worker_messages_c::current();
+  if (worker_messages)
+    worker_messages->handle(MXMSG_ERROR, error);
+
   if (s_mxmsg_error_handler)
     s_mxmsg_error_handler(MXMSG_ERROR, error);
 }
 
+namespace mtx { namespace output {
+
+static thread_local worker_messages_c *s_current_worker_messages;
+
+worker_messages_c::worker_messages_c(bool capture)
+  : m_capture{capture}
+  , m_previous{s_current_worker_messages}
+{
+  s_current_worker_messages = this;
+}
+
+worker_messages_c::~worker_messages_c() {
+  s_current_worker_messages = m_previous;
+}
+
+worker_messages_c *
+worker_messages_c::current() {
+  return s_current_worker_messages;
+}
+
+bool
+worker_messages_c::handle(unsigned int level,
+                          std::string const &message) {
+  if (MXMSG_ERROR == level) {
+    if (m_capture)
+      m_messages.push_back(message_t{ level, message });
+    throw error_x{message};
+  }
+
+  if (!m_capture)
+    return false;
+
+  m_messages.push_back(message_t{ level, message });
+  return true;
+}
+
+void
+replay(std::vector<message_t> const &messages) {
+  for (auto const &message : messages)
+    if (MXMSG_INFO == message.m_level)
+      mxinfo(message.m_message);
+    else if (MXMSG_WARNING == message.m_level)
+      mxwarn(message.m_message);
+    else
+      mxerror(message.m_message);
+}
+
+}}
+
 void
 mxinfo_fn(const std::string &file_name,
           const std::string &info) {
@@ -38,6 +38,7 @@ void redirect_stdio(const mm_io_cptr &new_stdio);
 bool stdio_redirected();
 
 void redirect_warnings_and_errors_to_json();
+nlohmann::json add_warnings_and_errors_to_json(nlohmann::json json);
 void display_json_output(nlohmann::json json);
 
 void init_common_output(bool no_charset_detection);
@@ -138,6 +139,67 @@ mxverb_tid(unsigned int level,
   mxverb_tid(level, file_name, track_id, message.str());
 }
 
+namespace mtx { namespace output {
+
+class error_x: public mtx::exception {
+protected:
+  std::string m_message;
+public:
+  explicit error_x(std::string const &message) : m_message{message} { }
+  virtual ~error_x() throw() { }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+struct message_t {
+  unsigned int m_level;
+  std::string m_message;
+};
+
+// Changes how the messages emitted on the current thread are handled
+// for as long as an instance exists. It's meant for worker threads:
+// they must not terminate the program themselves, and their messages
+// must not be output in an order differing from single-threaded
+// operation.
+//
+// Errors aren't passed to the error handler but thrown as error_x.
+// The owner of the worker reports them on the main thread. In capture
+// mode warnings and informational messages are collected as well so
+// that they can be replayed on another thread later.
+class worker_messages_c {
+protected:
+  bool m_capture;
+  std::vector<message_t> m_messages;
+  worker_messages_c *m_previous;
+
+public:
+  explicit worker_messages_c(bool capture = false);
+  ~worker_messages_c();
+
+  std::vector<message_t> const &get_messages() const {
+    return m_messages;
+  }
+
+  std::vector<message_t> take_messages() {
+    auto messages = std::move(m_messages);
+    m_messages.clear();
+    return messages;
+  }
+
+  // Returns whether or not the message has been handled.
+  bool handle(unsigned int level, std::string const &message);
+
+  static worker_messages_c *current();
+};
+
+// Emits the messages on the calling thread via mxinfo(), mxwarn() and
+// mxerror().
+void replay(std::vector<message_t> const &messages);
+
+}}
+
 extern const std::string empty_string;
 
 std::string fourcc_to_string(uint32_t fourcc);
@@ -0,0 +1,232 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   lightweight performance counters
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "common/mm_io.h"
+#include "common/profiling.h"
+#include "common/translation.h"
+
+namespace mtx { namespace profiling {
+
+namespace {
+
+auto const s_num_stages = static_cast<std::size_t>(stage_e::num_stages);
+
+struct counter_t {
+  uint64_t m_calls{};
+  int64_t m_ns{};
+};
+
+using counters_t = std::array<counter_t, s_num_stages>;
+
+struct stage_name_t {
+  char const *m_id;
+  translatable_string_c m_description;
+};
+
+std::atomic<bool> s_enabled{false};
+std::chrono::steady_clock::time_point s_start;
+
+// Timers may run on several threads, e.g. while waiting for I/O in
+// read-ahead or write-behind mode.
+std::mutex s_mutex;
+std::map<int64_t, counters_t> s_counters_by_track;
+
+// The innermost timer currently running on each thread.
+thread_local scoped_timer_c *tl_current_timer = nullptr;
+
+std::vector<stage_name_t> const &
+get_stage_names() {
+  static std::vector<stage_name_t> s_names{
+    { "reader_read",        YT("reader read")          },
+    { "packetizer_process", YT("packetizer process")   },
+    { "apply_factory",      YT("timestamp factory")    },
+    { "cluster_render",     YT("cluster rendering")    },
+    { "cues_write",         YT("cues writing")         },
+    { "read_wait",          YT("waiting for reads")    },
+    { "write_wait",         YT("waiting for writes")   },
+  };
+
+  return s_names;
+}
+
+int64_t
+get_elapsed_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+nlohmann::json
+counters_to_json(counters_t const &counters) {
+  auto json = nlohmann::json::object();
+
+  for (auto idx = 0u; idx < s_num_stages; ++idx)
+    if (counters[idx].m_calls)
+      json[get_stage_names()[idx].m_id] = nlohmann::json{
+        { "calls",   counters[idx].m_calls },
+        { "time_ns", counters[idx].m_ns    },
+      };
+
+  return json;
+}
+
+// Sums up the counters of all tracks. Must be called with s_mutex
+// locked.
+counters_t
+get_totals() {
+  auto totals = counters_t{};
+
+  for (auto const &pair : s_counters_by_track)
+    for (auto idx = 0u; idx < s_num_stages; ++idx) {
+      totals[idx].m_calls += pair.second[idx].m_calls;
+      totals[idx].m_ns    += pair.second[idx].m_ns;
+    }
+
+  return totals;
+}
+
+int64_t
+get_other_ns(counters_t const &totals,
+             int64_t total_ns) {
+  for (auto const &counter : totals)
+    total_ns -= counter.m_ns;
+
+  return std::max<int64_t>(total_ns, 0);
+}
+
+std::string
+format_line(std::string const &name,
+            std::string const &calls,
+            int64_t ns,
+            int64_t total_ns) {
+  return (boost::format("  %|1$-20s| %|2$12s| %|3$10.3f| %|4$6.1f|%%\n")
+          % name
+          % calls
+          % (ns / 1000000000.0)
+          % (total_ns ? ns * 100.0 / total_ns : 0.0)).str();
+}
+
+std::string
+format_counters(counters_t const &counters,
+                int64_t total_ns) {
+  auto result = std::string{};
+
+  for (auto idx = 0u; idx < s_num_stages; ++idx)
+    if (counters[idx].m_calls)
+      result += format_line(get_stage_names()[idx].m_description.get_translated(), std::to_string(counters[idx].m_calls), counters[idx].m_ns, total_ns);
+
+  return result;
+}
+
+}
+
+void
+enable(bool enable) {
+  if (enable && !s_enabled) {
+    std::lock_guard<std::mutex> lock{s_mutex};
+
+    s_counters_by_track.clear();
+    s_start = std::chrono::steady_clock::now();
+  }
+
+  s_enabled = enable;
+}
+
+bool
+is_enabled() {
+  return s_enabled;
+}
+
+void
+add(stage_e stage,
+    int64_t track_num,
+    int64_t duration_ns) {
+  std::lock_guard<std::mutex> lock{s_mutex};
+
+  auto &counter = s_counters_by_track[track_num][static_cast<std::size_t>(stage)];
+  ++counter.m_calls;
+  counter.m_ns += duration_ns;
+}
+
+void
+scoped_timer_c::start() {
+  m_parent         = tl_current_timer;
+  tl_current_timer = this;
+  m_start          = std::chrono::steady_clock::now();
+}
+
+void
+scoped_timer_c::stop() {
+  auto duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+  tl_current_timer = m_parent;
+
+  if (m_parent)
+    m_parent->m_nested_ns += duration_ns;
+
+  add(m_stage, m_track_num, std::max<int64_t>(duration_ns - m_nested_ns, 0));
+}
+
+nlohmann::json
+create_report() {
+  std::lock_guard<std::mutex> lock{s_mutex};
+
+  auto totals   = get_totals();
+  auto total_ns = get_elapsed_ns();
+  auto tracks   = nlohmann::json::array();
+
+  for (auto const &pair : s_counters_by_track)
+    if (-1 != pair.first)
+      tracks.push_back(nlohmann::json{
+        { "track_number", pair.first                    },
+        { "stages",       counters_to_json(pair.second) },
+      });
+
+  return nlohmann::json{
+    { "total_time_ns", total_ns                         },
+    { "other_time_ns", get_other_ns(totals, total_ns)   },
+    { "stages",        counters_to_json(totals)         },
+    { "tracks",        tracks                           },
+  };
+}
+
+void
+display_report(bool as_json) {
+  if (as_json) {
+    g_mm_stdio->puts(mtx::json::dump(nlohmann::json{ { "profile", create_report() } }, 2) + "\n");
+    g_mm_stdio->flush();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{s_mutex};
+
+  auto totals   = get_totals();
+  auto total_ns = get_elapsed_ns();
+  auto output   = (boost::format(Y("Profile for a total run time of %|1$.3f|s:\n")) % (total_ns / 1000000000.0)).str();
+
+  output += (boost::format("  %|1$-20s| %|2$12s| %|3$10s| %|4$7s|\n") % Y("Stage") % Y("Calls") % Y("Time (s)") % Y("Share")).str();
+  output += format_counters(totals, total_ns);
+  output += format_line(Y("other"), "", get_other_ns(totals, total_ns), total_ns);
+
+  for (auto const &pair : s_counters_by_track)
+    if (-1 != pair.first)
+      output += (boost::format(Y("Track number %1%:\n")) % pair.first).str() + format_counters(pair.second, total_ns);
+
+  g_mm_stdio->puts(output);
+  g_mm_stdio->flush();
+}
+
+}}
@@ -0,0 +1,93 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for lightweight performance counters
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_PROFILING_H
+#define MTX_COMMON_PROFILING_H
+
+#include "common/common_pch.h"
+
+#include <chrono>
+
+#include "common/json.h"
+
+namespace mtx { namespace profiling {
+
+// Profiling is disabled by default. While it's disabled the timers
+// don't even query the clock. Enabling it discards all counters
+// collected so far and restarts the clock for the total run time.
+
+enum class stage_e {
+  reader_read = 0,
+  packetizer_process,
+  apply_factory,
+  cluster_render,
+  cues_write,
+  read_wait,
+  write_wait,
+
+  num_stages,
+};
+
+void enable(bool enable);
+bool is_enabled();
+
+// Adds time to a stage, optionally attributed to a track (-1 for
+// none).
+void add(stage_e stage, int64_t track_num, int64_t duration_ns);
+
+// Measures the time between its construction and its destruction. The
+// time is exclusive: timers running on the same thread while this one
+// is active deduct their time from it. The time spent reading a file
+// from within a reader's read() is therefore accounted for as I/O
+// wait only, and a packetizer's time isn't counted for the reader
+// that called it.
+class scoped_timer_c {
+private:
+  stage_e m_stage;
+  int64_t m_track_num;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+  int64_t m_nested_ns{};
+  scoped_timer_c *m_parent{};
+
+public:
+  scoped_timer_c(stage_e stage, int64_t track_num = -1)
+    : m_stage{stage}
+    , m_track_num{track_num}
+    , m_active{is_enabled()}
+  {
+    if (m_active)
+      start();
+  }
+
+  ~scoped_timer_c() {
+    if (m_active)
+      stop();
+  }
+
+  scoped_timer_c(scoped_timer_c const &) = delete;
+  scoped_timer_c &operator =(scoped_timer_c const &) = delete;
+
+private:
+  void start();
+  void stop();
+};
+
+// The report covers the time since profiling was enabled. Time not
+// covered by any stage is reported as "other".
+nlohmann::json create_report();
+void display_report(bool as_json);
+
+}}
+
+#endif // MTX_COMMON_PROFILING_H
@@ -0,0 +1,188 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a lightweight replacement of boost::format
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/list_utils.h"
+#include "common/strings/fast_format.h"
+
+fast_format_c::fast_format_c(std::string const &format) {
+  parse(format);
+}
+
+void
+fast_format_c::parse(std::string const &format) {
+  auto directive = directive_t{};
+  auto pos       = 0u;
+  auto end       = format.length();
+
+  auto read_number = [&format, &pos, end]() -> int {
+    auto number = -1;
+
+    while ((pos < end) && std::isdigit(format[pos])) {
+      number = std::max(number, 0) * 10 + (format[pos] - '0');
+      ++pos;
+    }
+
+    return number;
+  };
+
+  while (pos < end) {
+    auto c = format[pos++];
+
+    if ('%' != c) {
+      directive.m_text += c;
+      continue;
+    }
+
+    if ((pos < end) && ('%' == format[pos])) {
+      directive.m_text += '%';
+      ++pos;
+      continue;
+    }
+
+    if ((pos < end) && ('|' == format[pos])) {
+      // %|N$[0][width][.precision]type|
+      ++pos;
+      directive.m_argument = read_number() - 1;
+
+      if ((0 > directive.m_argument) || (pos >= end) || ('$' != format[pos])) {
+        m_supported = false;
+        return;
+      }
+
+      ++pos;
+      if ((pos < end) && ('0' == format[pos])) {
+        directive.m_zero_pad = true;
+        ++pos;
+      }
+
+      directive.m_width = std::max(read_number(), 0);
+
+      if ((pos < end) && ('.' == format[pos])) {
+        ++pos;
+        directive.m_precision = std::max(read_number(), 0);
+      }
+
+      if (   ((pos + 1) >= end)
+          || !mtx::included_in(format[pos], 'd', 'x', 'X', 'f', 's')
+          || ('|' != format[pos + 1])) {
+        m_supported = false;
+        return;
+      }
+
+      directive.m_type  = format[pos];
+      pos              += 2;
+
+    } else {
+      // %N%
+      directive.m_argument = read_number() - 1;
+
+      if ((0 > directive.m_argument) || (pos >= end) || ('%' != format[pos])) {
+        m_supported = false;
+        return;
+      }
+
+      ++pos;
+    }
+
+    m_directives.push_back(directive);
+    directive = directive_t{};
+  }
+
+  m_directives.push_back(directive);
+}
+
+void
+fast_format_c::append(directive_t const &directive,
+                      arg_c const &arg) {
+  // Large enough for any 64-bit integer or a double formatted with
+  // "%.*f" for the precisions used in practice.
+  char buffer[400];
+  auto formatted = static_cast<char const *>(buffer);
+  auto length    = std::size_t{};
+  auto hex       = ('x' == directive.m_type) || ('X' == directive.m_type);
+
+  switch (arg.m_type) {
+    case arg_c::signed_integer:
+      length = hex ? std::snprintf(buffer, sizeof(buffer), 'x' == directive.m_type ? "%llx" : "%llX", static_cast<unsigned long long>(arg.m_signed))
+             :       std::snprintf(buffer, sizeof(buffer), "%lld",                                   static_cast<long long>(arg.m_signed));
+      break;
+
+    case arg_c::unsigned_integer:
+      length = hex ? std::snprintf(buffer, sizeof(buffer), 'x' == directive.m_type ? "%llx" : "%llX", static_cast<unsigned long long>(arg.m_unsigned))
+             :       std::snprintf(buffer, sizeof(buffer), "%llu",                                   static_cast<unsigned long long>(arg.m_unsigned));
+      break;
+
+    case arg_c::floating_point: {
+      // Mirror std::ostream: fixed notation only for 'f', otherwise the
+      // general notation with a default precision of six digits.
+      auto precision = directive.m_precision < 0 ? 6 : std::min(directive.m_precision, 300);
+      length         = std::snprintf(buffer, sizeof(buffer), 'f' == directive.m_type ? "%.*f" : "%.*g", precision, arg.m_double);
+      break;
+    }
+
+    case arg_c::character:
+      buffer[0] = arg.m_char;
+      length    = 1;
+      break;
+
+    case arg_c::string:
+      formatted = arg.m_string;
+      length    = arg.m_string_length;
+      if (0 <= directive.m_precision)
+        length = std::min<std::size_t>(length, directive.m_precision);
+      break;
+  }
+
+  if (arg_c::string != arg.m_type)
+    length = std::min(length, sizeof(buffer) - 1);
+
+  if (directive.m_width <= length) {
+    m_result.append(formatted, length);
+    return;
+  }
+
+  auto padding = directive.m_width - length;
+
+  if (!directive.m_zero_pad) {
+    m_result.append(padding, ' ');
+    m_result.append(formatted, length);
+    return;
+  }
+
+  // Zero padding goes between the sign and the digits.
+  auto is_number = (arg_c::string != arg.m_type) && (arg_c::character != arg.m_type);
+  if (is_number && length && (('-' == formatted[0]) || ('+' == formatted[0]))) {
+    m_result += formatted[0];
+    ++formatted;
+    --length;
+  }
+
+  m_result.append(padding, '0');
+  m_result.append(formatted, length);
+}
+
+std::string const &
+fast_format_c::format(std::initializer_list<arg_c> args) {
+  m_result.clear();
+
+  for (auto const &directive : m_directives) {
+    m_result += directive.m_text;
+
+    if ((0 <= directive.m_argument) && (static_cast<std::size_t>(directive.m_argument) < args.size()))
+      append(directive, *(args.begin() + directive.m_argument));
+  }
+
+  return m_result;
+}
@@ -0,0 +1,93 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for a lightweight replacement of boost::format
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_STRINGS_FAST_FORMAT_H
+#define MTX_COMMON_STRINGS_FAST_FORMAT_H
+
+#include "common/common_pch.h"
+
+// Formats arguments according to a boost::format style format string
+// that is parsed only once. It is meant for code that outputs the
+// same line for millions of elements, e.g. mkvinfo's summary mode.
+//
+// Only positional directives are understood: '%N%', '%|N$[0][width]
+// [.precision]type|' with type being one of 'd', 'x', 'X', 'f' or 's'
+// and '%%'. Callers must check is_supported() and fall back to
+// boost::format for anything else, e.g. for translations using other
+// directives.
+class fast_format_c {
+public:
+  class arg_c {
+  public:
+    enum type_e {
+      signed_integer,
+      unsigned_integer,
+      floating_point,
+      character,
+      string,
+    };
+
+    type_e m_type;
+    union {
+      int64_t m_signed;
+      uint64_t m_unsigned;
+      double m_double;
+      char m_char;
+    };
+    char const *m_string{};
+    std::size_t m_string_length{};
+
+  public:
+    arg_c(int value)                : m_type{signed_integer},   m_signed{value}   {}
+    arg_c(long value)               : m_type{signed_integer},   m_signed{value}   {}
+    arg_c(long long value)          : m_type{signed_integer},   m_signed{value}   {}
+    arg_c(unsigned int value)       : m_type{unsigned_integer}, m_unsigned{value} {}
+    arg_c(unsigned long value)      : m_type{unsigned_integer}, m_unsigned{value} {}
+    arg_c(unsigned long long value) : m_type{unsigned_integer}, m_unsigned{value} {}
+    arg_c(float value)              : m_type{floating_point},   m_double{value}   {}
+    arg_c(double value)             : m_type{floating_point},   m_double{value}   {}
+    arg_c(char value)               : m_type{character},        m_char{value}     {}
+    arg_c(std::string const &value) : m_type{string}, m_string{value.c_str()}, m_string_length{value.length()} {}
+    arg_c(char const *value)        : m_type{string}, m_string{value},         m_string_length{std::strlen(value)} {}
+  };
+
+protected:
+  struct directive_t {
+    std::string m_text;           // literal text output before the argument
+    int m_argument{-1};           // 0-based; -1 for trailing text only
+    char m_type{};
+    bool m_zero_pad{};
+    unsigned int m_width{};
+    int m_precision{-1};
+  };
+
+  std::vector<directive_t> m_directives;
+  bool m_supported{true};
+  std::string m_result;
+
+public:
+  explicit fast_format_c(std::string const &format);
+
+  bool is_supported() const {
+    return m_supported;
+  }
+
+  // The returned reference stays valid until the next call.
+  std::string const &format(std::initializer_list<arg_c> args);
+
+protected:
+  void parse(std::string const &format);
+  void append(directive_t const &directive, arg_c const &arg);
+};
+
+#endif  // MTX_COMMON_STRINGS_FAST_FORMAT_H
@@ -24,9 +24,8 @@
 std::string
 format_timestamp(int64_t timestamp,
                 unsigned int precision) {
-  static boost::format s_bf_format("%4%%|1$02d|:%|2$02d|:%|3$02d|");
-  static boost::format s_bf_decimals(".%|1$09d|");
-
+  // Formatted with snprintf() instead of boost::format as this is
+  // called for each frame in e.g. mkvinfo's summary mode.
   bool negative = 0 > timestamp;
   if (negative)
     timestamp *= -1;
@@ -38,25 +37,22 @@ format_timestamp(int64_t timestamp,
     timestamp += shift;
   }
 
-  auto result = (s_bf_format
-                 % ( timestamp / 60 / 60 / 1000000000)
-                 % ((timestamp      / 60 / 1000000000) % 60)
-                 % ((timestamp           / 1000000000) % 60)
-                 % (negative ? "-" : "")).str();
+  char buffer[64];
+  auto length = std::snprintf(buffer, sizeof(buffer), "%s%02lld:%02lld:%02lld",
+                              negative ? "-" : "",
+                              static_cast<long long>( timestamp / 60 / 60 / 1000000000),
+                              static_cast<long long>((timestamp      / 60 / 1000000000) % 60),
+                              static_cast<long long>((timestamp           / 1000000000) % 60));
 
   if (9 < precision)
     precision = 9;
 
   if (precision) {
-    auto decimals = (s_bf_decimals % (timestamp % 1000000000)).str();
-
-    if (decimals.length() > (precision + 1))
-      decimals.erase(precision + 1);
-
-    result += decimals;
+    std::snprintf(&buffer[length], sizeof(buffer) - length, ".%09lld", static_cast<long long>(timestamp % 1000000000));
+    length += precision + 1;
   }
 
-  return result;
+  return std::string(buffer, length);
 }
 
 std::string
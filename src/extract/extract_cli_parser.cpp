@@ -65,11 +65,13 @@ extract_cli_parser_c::init_parser() {
 
   add_section_header(YT("Track extraction"));
   add_information(YT("The first mode extracts some tracks to external files."));
-  OPT("c=charset",      set_charset,  YT("Convert text subtitles to this charset (default: UTF-8)."));
-  OPT("cuesheet",       set_cuesheet, YT("Also try to extract the cue sheet from the chapter information and tags for this track."));
-  OPT("blockadd=level", set_blockadd, YT("Keep only the BlockAdditions up to this level (default: keep all levels)"));
-  OPT("raw",            set_raw,      YT("Extract the data to a raw file."));
-  OPT("fullraw",        set_fullraw,  YT("Extract the data to a raw file including the CodecPrivate as a header."));
+  OPT("c=charset",       set_charset,  YT("Convert text subtitles to this charset (default: UTF-8)."));
+  OPT("cuesheet",        set_cuesheet, YT("Also try to extract the cue sheet from the chapter information and tags for this track."));
+  OPT("blockadd=level",  set_blockadd, YT("Keep only the BlockAdditions up to this level (default: keep all levels)"));
+  OPT("raw",             set_raw,      YT("Extract the data to a raw file."));
+  OPT("fullraw",         set_fullraw,  YT("Extract the data to a raw file including the CodecPrivate as a header."));
+  OPT("threads=n",       set_threads,  YT("Decode and write the extracted tracks on up to n threads in parallel (default: 1)."));
+  OPT("range=start-end", set_range,    YT("Only extract the frames between the timestamps 'start' and 'end'. Either may be omitted."));
   add_informational_option("TID:out", YT("Write track with the ID TID to the file 'out'."));
 
   add_section_header(YT("Example"));
@@ -178,6 +180,31 @@ extract_cli_parser_c::set_fullraw() {
   m_target_mode = track_spec_t::tm_full_raw;
 }
 
+void
+extract_cli_parser_c::set_threads() {
+  assert_mode(options_c::em_tracks);
+  if (!parse_number(m_next_arg, m_options.m_num_threads) || (1 > m_options.m_num_threads))
+    mxerror(boost::format(Y("Invalid number of threads in argument '%1%'.\n")) % m_next_arg);
+}
+
+void
+extract_cli_parser_c::set_range() {
+  assert_mode(options_c::em_tracks);
+
+  auto dash_pos = m_next_arg.find('-');
+  if (std::string::npos == dash_pos)
+    mxerror(boost::format(Y("Invalid time range in argument '%1%'.\n")) % m_next_arg);
+
+  auto start = m_next_arg.substr(0, dash_pos);
+  auto end   = m_next_arg.substr(dash_pos + 1);
+
+  if (   (start.empty() && end.empty())
+      || (!start.empty() && !parse_timestamp(start, m_options.m_range_start))
+      || (!end.empty()   && !parse_timestamp(end,   m_options.m_range_end))
+      || (m_options.m_range_start.valid() && m_options.m_range_end.valid() && !(m_options.m_range_start < m_options.m_range_end)))
+    mxerror(boost::format(Y("Invalid time range in argument '%1%'.\n")) % m_next_arg);
+}
+
 void
 extract_cli_parser_c::set_simple() {
   assert_mode(options_c::em_chapters);
@@ -282,11 +309,25 @@ extract_cli_parser_c::add_extraction_spec() {
   set_default_values();
 }
 
+void
+extract_cli_parser_c::check_for_incompatible_options() {
+  if (!m_options.m_range_start.valid() && !m_options.m_range_end.valid())
+    return;
+
+  // The chapters and tags needed for the cue sheet are usually stored
+  // after the last cluster which isn't read with a range.
+  for (auto const &track : m_options.m_tracks)
+    if (track.extract_cuesheet)
+      mxerror(Y("'--cuesheet' cannot be used together with '--range'.\n"));
+}
+
 options_c
 extract_cli_parser_c::run() {
   init_parser();
 
   parse_args();
 
+  check_for_incompatible_options();
+
   return m_options;
 }
@@ -48,11 +48,14 @@ protected:
   void set_blockadd();
   void set_raw();
   void set_fullraw();
+  void set_threads();
+  void set_range();
   void set_simple();
   void set_simple_language();
   void set_mode_or_extraction_spec();
   void set_extraction_mode();
   void add_extraction_spec();
+  void check_for_incompatible_options();
 };
 
 #endif // MTX_EXTRACT_EXTRACT_CLI_PARSER_H
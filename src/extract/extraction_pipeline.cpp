@@ -0,0 +1,184 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   handling extracted frames on worker threads
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "extract/extraction_pipeline.h"
+
+extraction_pipeline_c::extraction_pipeline_c(std::vector<xtr_base_c *> const &extractors,
+                                             unsigned int num_threads)
+  : m_num_clusters{}
+  , m_max_clusters{}
+  , m_finishing{}
+  , m_aborting{}
+{
+  // Extractors writing to the same file must not run concurrently.
+  auto groups = std::vector<xtr_base_c *>{};
+  auto root   = [](xtr_base_c *extractor) {
+    while (extractor->m_master)
+      extractor = extractor->m_master;
+    return extractor;
+  };
+
+  for (auto extractor : extractors)
+    if (groups.end() == std::find(groups.begin(), groups.end(), root(extractor)))
+      groups.push_back(root(extractor));
+
+  auto num_workers = std::max<std::size_t>(std::min<std::size_t>(num_threads, groups.size()), 1);
+  m_max_clusters   = 2 * num_workers + 2;
+
+  for (auto idx = 0u; idx < num_workers; ++idx)
+    m_workers.emplace_back(std::make_unique<worker_t>());
+
+  for (auto extractor : extractors) {
+    auto group_idx                    = std::find(groups.begin(), groups.end(), root(extractor)) - groups.begin();
+    m_worker_for_extractor[extractor] = m_workers[group_idx % num_workers].get();
+  }
+
+  for (auto &worker : m_workers)
+    worker->m_thread = std::thread{&extraction_pipeline_c::run_worker, this, std::ref(*worker)};
+}
+
+extraction_pipeline_c::~extraction_pipeline_c() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_aborting = !m_finishing;
+  }
+
+  stop_workers();
+}
+
+extraction_pipeline_c::cluster_cptr
+extraction_pipeline_c::adopt_cluster(KaxCluster *cluster) {
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_cluster_released.wait(lock, [this]() { return m_num_clusters < m_max_clusters; });
+    ++m_num_clusters;
+  }
+
+  return cluster_cptr{cluster, [this](KaxCluster *cluster_to_delete) {
+    delete cluster_to_delete;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    --m_num_clusters;
+    m_cluster_released.notify_one();
+  }};
+}
+
+void
+extraction_pipeline_c::add_frame(xtr_base_c &extractor,
+                                 cluster_cptr const &cluster,
+                                 xtr_frame_t const &f) {
+  add_job(job_t{ &extractor, cluster, f.frame, memory_cptr{}, f.additions, f.timecode, f.duration, f.bref, f.fref, f.keyframe, f.discardable, f.references_valid, f.discard_duration });
+}
+
+void
+extraction_pipeline_c::add_codec_state(xtr_base_c &extractor,
+                                       cluster_cptr const &cluster,
+                                       memory_cptr const &codec_state) {
+  add_job(job_t{ &extractor, cluster, memory_cptr{}, codec_state, nullptr, 0, 0, 0, 0, false, false, false, timestamp_c{} });
+}
+
+void
+extraction_pipeline_c::add_job(job_t &&job) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+
+  rethrow_worker_exception();
+
+  auto &worker = *m_worker_for_extractor[job.m_extractor];
+  worker.m_jobs.emplace_back(std::move(job));
+  worker.m_jobs_available.notify_one();
+}
+
+void
+extraction_pipeline_c::finish() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_finishing = true;
+  }
+
+  stop_workers();
+
+  std::lock_guard<std::mutex> lock{m_mutex};
+  rethrow_worker_exception();
+}
+
+void
+extraction_pipeline_c::stop_workers() {
+  for (auto &worker : m_workers)
+    worker->m_jobs_available.notify_one();
+
+  for (auto &worker : m_workers)
+    if (worker->m_thread.joinable())
+      worker->m_thread.join();
+}
+
+void
+extraction_pipeline_c::rethrow_worker_exception() {
+  for (auto &worker : m_workers)
+    if (worker->m_exception)
+      std::rethrow_exception(worker->m_exception);
+}
+
+void
+extraction_pipeline_c::run_worker(worker_t &worker) {
+  // Extractors report fatal errors via mxerror(). Exiting on a worker
+  // thread would destroy the pipeline from within one of its own
+  // threads. The error is thrown instead and rethrown on the main
+  // thread, which reports it there.
+  mtx::output::worker_messages_c worker_messages;
+
+  while (true) {
+    auto jobs    = std::deque<job_t>{};
+    auto discard = false;
+
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      worker.m_jobs_available.wait(lock, [this, &worker]() { return !worker.m_jobs.empty() || m_finishing || m_aborting; });
+
+      if (worker.m_jobs.empty())
+        return;
+
+      // Take everything queued so far. Releasing the clusters of
+      // handled jobs requires the mutex, so it mustn't be held then.
+      std::swap(jobs, worker.m_jobs);
+      discard = m_aborting || worker.m_exception;
+    }
+
+    if (discard)
+      continue;
+
+    for (auto &job : jobs) {
+      try {
+        handle_job(job);
+
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        worker.m_exception = std::current_exception();
+        break;
+      }
+
+      job.m_cluster.reset();
+    }
+  }
+}
+
+void
+extraction_pipeline_c::handle_job(job_t &job) {
+  if (job.m_codec_state) {
+    job.m_extractor->handle_codec_state(job.m_codec_state);
+    return;
+  }
+
+  auto f = xtr_frame_t{job.m_frame, job.m_additions, job.m_timecode, job.m_duration, job.m_bref, job.m_fref, job.m_keyframe, job.m_discardable, job.m_references_valid, job.m_discard_duration};
+  job.m_extractor->decode_and_handle_frame(f);
+}
@@ -0,0 +1,91 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   handling extracted frames on worker threads
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_EXTRACT_EXTRACTION_PIPELINE_H
+#define MTX_EXTRACT_EXTRACTION_PIPELINE_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <matroska/KaxCluster.h>
+
+#include "extract/xtr_base.h"
+
+using namespace libmatroska;
+
+// Hands the frames read from the clusters over to worker threads that
+// decode them and let the extractors write them. All frames of one
+// extractor are handled by the same worker in the order they were
+// added. Extractors writing to the same file share a worker.
+//
+// The frames point into the cluster they were read from. Clusters are
+// therefore adopted by the pipeline and only deleted once all of their
+// frames have been handled. The number of clusters alive at the same
+// time is limited so that the reader cannot run away from the workers.
+class extraction_pipeline_c {
+public:
+  using cluster_cptr = std::shared_ptr<KaxCluster>;
+
+protected:
+  struct job_t {
+    xtr_base_c *m_extractor;
+    cluster_cptr m_cluster;
+    memory_cptr m_frame, m_codec_state;
+    KaxBlockAdditions *m_additions;
+    int64_t m_timecode, m_duration, m_bref, m_fref;
+    bool m_keyframe, m_discardable, m_references_valid;
+    timestamp_c m_discard_duration;
+  };
+
+  struct worker_t {
+    std::thread m_thread;
+    std::deque<job_t> m_jobs;
+    std::condition_variable m_jobs_available;
+    std::exception_ptr m_exception;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_cluster_released;
+  std::vector<std::unique_ptr<worker_t>> m_workers;
+  std::unordered_map<xtr_base_c *, worker_t *> m_worker_for_extractor;
+  std::size_t m_num_clusters, m_max_clusters;
+  bool m_finishing, m_aborting;
+
+public:
+  extraction_pipeline_c(std::vector<xtr_base_c *> const &extractors, unsigned int num_threads);
+  ~extraction_pipeline_c();
+
+  cluster_cptr adopt_cluster(KaxCluster *cluster);
+
+  void add_frame(xtr_base_c &extractor, cluster_cptr const &cluster, xtr_frame_t const &f);
+  void add_codec_state(xtr_base_c &extractor, cluster_cptr const &cluster, memory_cptr const &codec_state);
+
+  // Waits until all frames have been handled and stops the workers.
+  // Rethrows the first exception a worker has caught. Errors reported
+  // by extractors via mxerror() are rethrown as mtx::output::error_x.
+  void finish();
+
+protected:
+  void add_job(job_t &&job);
+  void run_worker(worker_t &worker);
+  void handle_job(job_t &job);
+  void stop_workers();
+  void rethrow_worker_exception();
+};
+
+#endif // MTX_EXTRACT_EXTRACTION_PIPELINE_H
@@ -0,0 +1,103 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   restricting track extraction to a time range
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "extract/extraction_range.h"
+
+extraction_range_c::extraction_range_c(timestamp_c const &start,
+                                       timestamp_c const &end)
+  : m_start{start}
+  , m_end{end}
+{
+}
+
+timestamp_c const &
+extraction_range_c::get_start()
+  const {
+  return m_start;
+}
+
+timestamp_c const &
+extraction_range_c::get_end()
+  const {
+  return m_end;
+}
+
+boost::optional<extraction_range_c::seek_point_t>
+extraction_range_c::find_start_in_cues(std::vector<cue_point_t> const &cue_points,
+                                       std::vector<uint64_t> const &cluster_positions)
+  const {
+  if (!m_start.valid())
+    return {};
+
+  auto best_timestamp = timestamp_c{};
+  auto best_position  = uint64_t{};
+
+  for (auto const &cue_point : cue_points) {
+    if (   (cue_point.m_timestamp > m_start)
+        || (best_timestamp.valid() && (cue_point.m_timestamp < best_timestamp)))
+      continue;
+
+    if (!best_timestamp.valid() || (cue_point.m_timestamp > best_timestamp) || (cue_point.m_position < best_position)) {
+      best_timestamp = cue_point.m_timestamp;
+      best_position  = cue_point.m_position;
+    }
+  }
+
+  if (!best_timestamp.valid())
+    return {};
+
+  // In full parsing mode all clusters are indexed. Don't trust cues
+  // pointing somewhere else.
+  if (   (1 < cluster_positions.size())
+      && !brng::binary_search(cluster_positions, best_position)) {
+    mxwarn(Y("The cues don't point to the start of a cluster. The file will be read from the start.\n"));
+    return {};
+  }
+
+  return std::make_pair(best_position, best_timestamp);
+}
+
+boost::optional<extraction_range_c::seek_point_t>
+extraction_range_c::find_start_in_clusters(std::vector<uint64_t> const &cluster_positions,
+                                           std::function<boost::optional<timestamp_c>(uint64_t)> const &get_timestamp)
+  const {
+  if (!m_start.valid())
+    return {};
+
+  auto result = boost::optional<seek_point_t>{};
+  auto lower  = std::size_t{};
+  auto upper  = cluster_positions.size();
+
+  while (lower < upper) {
+    auto middle    = lower + (upper - lower) / 2;
+    auto timestamp = get_timestamp(cluster_positions[middle]);
+
+    if (!timestamp)
+      return {};
+
+    if (*timestamp <= m_start) {
+      result = std::make_pair(cluster_positions[middle], *timestamp);
+      lower  = middle + 1;
+    } else
+      upper  = middle;
+  }
+
+  return result;
+}
+
+bool
+extraction_range_c::is_done(timestamp_c const &cluster_timestamp)
+  const {
+  return m_end.valid() && (cluster_timestamp >= m_end);
+}
@@ -0,0 +1,155 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   restricting track extraction to a time range
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_EXTRACT_EXTRACTION_RANGE_H
+#define MTX_EXTRACT_EXTRACTION_RANGE_H
+
+#include "common/common_pch.h"
+
+#include <unordered_map>
+
+#include "common/timestamp.h"
+
+// The time range [start, end) requested by the user. Either end may be
+// invalid for a range starting at the beginning or lasting until the end
+// of the file.
+class extraction_range_c {
+public:
+  struct cue_point_t {
+    timestamp_c m_timestamp;
+    uint64_t m_position;
+  };
+
+  // Position of the cluster reading starts with and that cluster's
+  // timestamp.
+  using seek_point_t = std::pair<uint64_t, timestamp_c>;
+
+protected:
+  timestamp_c m_start, m_end;
+
+public:
+  extraction_range_c(timestamp_c const &start = timestamp_c{}, timestamp_c const &end = timestamp_c{});
+
+  timestamp_c const &get_start() const;
+  timestamp_c const &get_end() const;
+
+  // Returns the position of the last cue point at or before the range's
+  // start. If more than one cluster position is known then the cue
+  // point must point to one of them.
+  boost::optional<seek_point_t> find_start_in_cues(std::vector<cue_point_t> const &cue_points, std::vector<uint64_t> const &cluster_positions) const;
+
+  // Searches the clusters at the given positions for the last one
+  // starting at or before the range's start. The clusters must be
+  // sorted by their timestamps, which are read via get_timestamp.
+  boost::optional<seek_point_t> find_start_in_clusters(std::vector<uint64_t> const &cluster_positions,
+                                                       std::function<boost::optional<timestamp_c>(uint64_t)> const &get_timestamp) const;
+
+  // Nothing after a cluster starting at or after the range's end can be
+  // in the range.
+  bool is_done(timestamp_c const &cluster_timestamp) const;
+};
+
+// Decides for each track which of its frames are extracted. Frames at
+// or after the range's end are dropped. Each track starts with its last
+// key frame at or before the range's start so that video tracks can be
+// decoded from the first frame on. As that key frame is only known once
+// a later frame has been seen, the frames from the latest key frame on
+// are held until the first frame at or after the start arrives.
+//
+// Some muxers never set the key frame flag for audio or subtitle
+// tracks. Tracks without any key frame so far therefore start with
+// their first frame at or after the start unless require_keyframes()
+// has been called for them.
+template<typename Ttrack, typename Tframe>
+class extraction_range_filter_c {
+public:
+  enum class action_e {
+    skip,                       // drop the frame
+    hold,                       // pass the frame to hold()
+    handle,                     // handle the frames from take_held() first, then this one
+  };
+
+protected:
+  struct track_t {
+    bool m_started, m_keyframe_seen, m_requires_keyframes;
+    std::vector<Tframe> m_held;
+
+    track_t()
+      : m_started{}
+      , m_keyframe_seen{}
+      , m_requires_keyframes{}
+    {
+    }
+  };
+
+  timestamp_c m_start, m_end;
+  std::unordered_map<Ttrack, track_t> m_tracks;
+
+public:
+  extraction_range_filter_c(extraction_range_c const &range = extraction_range_c{})
+    : m_start{range.get_start()}
+    , m_end{range.get_end()}
+  {
+  }
+
+  // Video tracks cannot be decoded from anything but a key frame.
+  void require_keyframes(Ttrack const &track) {
+    m_tracks[track].m_requires_keyframes = true;
+  }
+
+  action_e add(Ttrack const &track, int64_t timestamp, bool keyframe) {
+    if (m_end.valid() && (timestamp >= m_end.to_ns()))
+      return action_e::skip;
+
+    if (!m_start.valid())
+      return action_e::handle;
+
+    auto &state = m_tracks[track];
+    if (state.m_started)
+      return action_e::handle;
+
+    state.m_keyframe_seen = state.m_keyframe_seen || keyframe;
+
+    if (timestamp >= m_start.to_ns()) {
+      if (keyframe && (timestamp == m_start.to_ns()))
+        state.m_held.clear();
+
+      // Without a key frame before the start the track can only start
+      // with the next key frame -- unless it doesn't flag key frames
+      // at all.
+      state.m_started = keyframe || !state.m_held.empty() || (!state.m_keyframe_seen && !state.m_requires_keyframes);
+      return state.m_started ? action_e::handle : action_e::skip;
+    }
+
+    if (keyframe)
+      state.m_held.clear();
+
+    return keyframe || !state.m_held.empty() ? action_e::hold : action_e::skip;
+  }
+
+  void hold(Ttrack const &track, Tframe frame) {
+    m_tracks[track].m_held.push_back(std::move(frame));
+  }
+
+  std::vector<Tframe> take_held(Ttrack const &track) {
+    auto itr = m_tracks.find(track);
+    if (itr == m_tracks.end())
+      return {};
+
+    auto held = std::move(itr->second.m_held);
+    itr->second.m_held.clear();
+
+    return held;
+  }
+};
+
+#endif // MTX_EXTRACT_EXTRACTION_RANGE_H
@@ -19,5 +19,6 @@ options_c::options_c()
   : m_simple_chapter_format(false)
   , m_parse_mode(kax_analyzer_c::parse_mode_fast)
   , m_extraction_mode(options_c::em_unknown)
+  , m_num_threads(1)
 {
 }
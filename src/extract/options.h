@@ -13,6 +13,8 @@
 
 #include "common/common_pch.h"
 
+#include "common/timestamp.h"
+
 class options_c {
 public:
   enum extraction_mode_e {
@@ -31,6 +33,8 @@ public:
   boost::optional<std::string> m_simple_chapter_language;
   kax_analyzer_c::parse_mode_e m_parse_mode;
   extraction_mode_e m_extraction_mode;
+  unsigned int m_num_threads;
+  timestamp_c m_range_start, m_range_end;
 
   std::vector<track_spec_t> m_tracks;
 
@@ -24,6 +24,8 @@
 #include <matroska/KaxBlockData.h>
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxClusterData.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxInfoData.h>
 #include <matroska/KaxSegment.h>
@@ -37,18 +39,39 @@
 #include "common/kax_file.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/strings/formatting.h"
+#include "extract/extraction_pipeline.h"
+#include "extract/extraction_range.h"
 #include "extract/mkvextract.h"
 #include "extract/xtr_base.h"
 
 using namespace libmatroska;
 
 static std::vector<xtr_base_c *> extractors;
+static std::unique_ptr<extraction_pipeline_c> s_pipeline;
+
+// Frames held back while looking for each track's last key frame
+// before the range's start. The cluster they were read from is gone by
+// the time they're handled; therefore they own copies of their data.
+struct held_frame_t {
+  memory_cptr m_frame;
+  std::shared_ptr<KaxBlockAdditions> m_additions;
+  int64_t m_timecode, m_duration, m_bref, m_fref;
+  bool m_keyframe, m_discardable, m_references_valid;
+  timestamp_c m_discard_duration;
+};
+
+using range_filter_c = extraction_range_filter_c<xtr_base_c *, held_frame_t>;
+
+static extraction_range_c s_range;
+static range_filter_c s_range_filter;
 
 // ------------------------------------------------------------------------
 
 static void
 create_extractors(KaxTracks &kax_tracks,
-                  std::vector<track_spec_t> &tracks) {
+                  std::vector<track_spec_t> &tracks,
+                  unsigned int num_threads) {
   size_t i;
   int64_t track_id = -1;
 
@@ -98,6 +121,9 @@ create_extractors(KaxTracks &kax_tracks,
 
     extractor->m_track_num = tnum;
 
+    if ('V' == codec_id[0])
+      s_range_filter.require_keyframes(extractor);
+
     // Has there another file been requested with the same name?
     xtr_base_c *master = nullptr;
     for (k = 0; k < extractors.size(); k++)
@@ -119,11 +145,57 @@ create_extractors(KaxTracks &kax_tracks,
   // Signal that all headers have been taken care of.
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->headers_done();
+
+  if ((1 < num_threads) && (1 < extractors.size()))
+    s_pipeline = std::make_unique<extraction_pipeline_c>(extractors, num_threads);
+}
+
+static void
+handle_frame(xtr_base_c &extractor,
+             xtr_frame_t &f,
+             extraction_pipeline_c::cluster_cptr const &cluster) {
+  if (s_pipeline)
+    s_pipeline->add_frame(extractor, cluster, f);
+  else
+    extractor.decode_and_handle_frame(f);
+}
+
+static void
+handle_held_frame(xtr_base_c &extractor,
+                  held_frame_t &held) {
+  auto f = xtr_frame_t{held.m_frame, held.m_additions.get(), held.m_timecode, held.m_duration, held.m_bref, held.m_fref, held.m_keyframe, held.m_discardable, held.m_references_valid, held.m_discard_duration};
+
+  // The pipeline only has to keep the copied block additions alive;
+  // an empty pointer sharing their ownership does just that.
+  handle_frame(extractor, f, extraction_pipeline_c::cluster_cptr{held.m_additions, static_cast<KaxCluster *>(nullptr)});
+}
+
+static void
+handle_frame_in_range(xtr_base_c &extractor,
+                      xtr_frame_t &f,
+                      bool keyframe,
+                      extraction_pipeline_c::cluster_cptr const &cluster) {
+  auto action = s_range_filter.add(&extractor, f.timecode, keyframe);
+
+  if (action == range_filter_c::action_e::skip)
+    return;
+
+  if (action == range_filter_c::action_e::hold) {
+    auto additions = f.additions ? std::shared_ptr<KaxBlockAdditions>{static_cast<KaxBlockAdditions *>(f.additions->Clone())} : std::shared_ptr<KaxBlockAdditions>{};
+    s_range_filter.hold(&extractor, held_frame_t{f.frame->clone(), additions, f.timecode, f.duration, f.bref, f.fref, f.keyframe, f.discardable, f.references_valid, f.discard_duration});
+    return;
+  }
+
+  for (auto &held : s_range_filter.take_held(&extractor))
+    handle_held_frame(extractor, held);
+
+  handle_frame(extractor, f, cluster);
 }
 
 static int64_t
 handle_blockgroup(KaxBlockGroup &blockgroup,
                   KaxCluster &cluster,
+                  extraction_pipeline_c::cluster_cptr const &pipelined_cluster,
                   int64_t tc_scale) {
   // Only continue if this block group actually contains a block.
   KaxBlock *block = FindChild<KaxBlock>(&blockgroup);
@@ -169,7 +241,10 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
   KaxCodecState *kcstate = FindChild<KaxCodecState>(&blockgroup);
   if (kcstate) {
     memory_cptr codec_state(new memory_c(kcstate->GetBuffer(), kcstate->GetSize(), false));
-    extractor->handle_codec_state(codec_state);
+    if (s_pipeline)
+      s_pipeline->add_codec_state(*extractor, pipelined_cluster, codec_state);
+    else
+      extractor->handle_codec_state(codec_state);
   }
 
   for (i = 0; i < block->NumberFrames(); i++) {
@@ -189,12 +264,12 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
     if (kdiscard_padding)
       discard_padding = timestamp_c::ns(kdiscard_padding->GetValue());
 
+    max_timecode = std::max(max_timecode, this_timecode);
+
     auto &data = block->GetBuffer(i);
     auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
     auto f     = xtr_frame_t{frame, kadditions, this_timecode, this_duration, bref, fref, false, false, true, discard_padding};
-    extractor->decode_and_handle_frame(f);
-
-    max_timecode = std::max(max_timecode, this_timecode);
+    handle_frame_in_range(*extractor, f, !bref && !fref, pipelined_cluster);
   }
 
   return max_timecode;
@@ -202,7 +277,8 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
 
 static int64_t
 handle_simpleblock(KaxSimpleBlock &simpleblock,
-                   KaxCluster &cluster) {
+                   KaxCluster &cluster,
+                   extraction_pipeline_c::cluster_cptr const &pipelined_cluster) {
   if (0 == simpleblock.NumberFrames())
     return - 1;
 
@@ -234,12 +310,12 @@ handle_simpleblock(KaxSimpleBlock &simpleblock,
       this_duration = duration / simpleblock.NumberFrames();
     }
 
+    max_timecode = std::max(max_timecode, this_timecode);
+
     auto &data = simpleblock.GetBuffer(i);
     auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
     auto f     = xtr_frame_t{frame, nullptr, this_timecode, this_duration, -1, -1, simpleblock.IsKeyframe(), simpleblock.IsDiscardable(), false, timestamp_c::ns(0)};
-    extractor->decode_and_handle_frame(f);
-
-    max_timecode = std::max(max_timecode, this_timecode);
+    handle_frame_in_range(*extractor, f, simpleblock.IsKeyframe(), pipelined_cluster);
   }
 
   return max_timecode;
@@ -249,6 +325,11 @@ static void
 close_extractors() {
   size_t i;
 
+  if (s_pipeline) {
+    s_pipeline->finish();
+    s_pipeline.reset();
+  }
+
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->finish_track();
 
@@ -342,13 +423,91 @@ handle_segment_info(EbmlMaster *info,
   file->set_timecode_scale(tc_scale);
 }
 
+static std::vector<kax_analyzer_data_c>
+get_indexed_clusters(kax_analyzer_c &analyzer) {
+  auto clusters = std::vector<kax_analyzer_data_c>{};
+  analyzer.with_elements(EBML_ID(KaxCluster), [&clusters](kax_analyzer_data_c const &data) { clusters.push_back(data); });
+
+  return clusters;
+}
+
+static std::vector<extraction_range_c::cue_point_t>
+read_cue_points(kax_analyzer_c &analyzer,
+                uint64_t tc_scale) {
+  auto cue_points = std::vector<extraction_range_c::cue_point_t>{};
+  auto cues_m     = analyzer.read_all(EBML_INFO(KaxCues));
+  auto cues       = dynamic_cast<KaxCues *>(cues_m.get());
+
+  if (!cues)
+    return cue_points;
+
+  auto segment_data_start_pos = analyzer.get_segment_data_start_pos();
+
+  for (auto const &elt : *cues) {
+    auto kcue_point = dynamic_cast<KaxCuePoint *>(elt);
+    auto ktime      = kcue_point ? FindChild<KaxCueTime>(*kcue_point) : nullptr;
+    if (!ktime)
+      continue;
+
+    for (auto const &pos_elt : *kcue_point) {
+      auto ktrack_pos = dynamic_cast<KaxCueTrackPositions *>(pos_elt);
+      auto kcluster   = ktrack_pos ? FindChild<KaxCueClusterPosition>(*ktrack_pos) : nullptr;
+      if (kcluster)
+        cue_points.push_back({ timestamp_c::ns(ktime->GetValue() * tc_scale), segment_data_start_pos + kcluster->GetValue() });
+    }
+  }
+
+  return cue_points;
+}
+
+static boost::optional<uint64_t>
+find_range_start_position(kax_analyzer_c &analyzer,
+                          uint64_t tc_scale) {
+  auto clusters          = get_indexed_clusters(analyzer);
+  auto cluster_positions = std::vector<uint64_t>{};
+
+  for (auto const &data : clusters)
+    cluster_positions.push_back(data.m_pos);
+
+  auto start = s_range.find_start_in_cues(read_cue_points(analyzer, tc_scale), cluster_positions);
+
+  // Without cues the clusters found by a full analysis are searched.
+  if (!start && (1 < clusters.size()))
+    start = s_range.find_start_in_clusters(cluster_positions, [&](uint64_t position) -> boost::optional<timestamp_c> {
+      auto idx     = brng::lower_bound(cluster_positions, position) - cluster_positions.begin();
+      auto cluster = analyzer.read_element(clusters[idx]);
+      if (!cluster)
+        return boost::none;
+
+      return timestamp_c::ns(FindChildValue<KaxClusterTimecode>(static_cast<KaxCluster *>(cluster.get())) * tc_scale);
+    });
+
+  if (!start) {
+    mxinfo(Y("Neither cues nor an index of all clusters are available. The file will be read from the start. "
+             "Using '--parse-fully' creates such an index.\n"));
+    return {};
+  }
+
+  mxinfo(boost::format(Y("Reading starts at the cluster with the timestamp %1%.\n")) % format_timestamp(start->second));
+
+  return start->first;
+}
+
 bool
 extract_tracks(const std::string &file_name,
                std::vector<track_spec_t> &tspecs,
-               kax_analyzer_c::parse_mode_e parse_mode) {
+               kax_analyzer_c::parse_mode_e parse_mode,
+               unsigned int num_threads,
+               timestamp_c const &range_start,
+               timestamp_c const &range_end) {
   if (tspecs.empty())
     mxerror(Y("Nothing to do.\n"));
 
+  s_range        = extraction_range_c{range_start, range_end};
+  s_range_filter = range_filter_c{s_range};
+
+  auto range_start_position = boost::optional<uint64_t>{};
+
   // open input file
   mm_io_cptr in;
   kax_file_cptr file;
@@ -379,8 +538,11 @@ extract_tracks(const std::string &file_name,
     if (tracks) {
       tracks_found = true;
       find_and_verify_track_uids(*tracks, tspecs);
-      create_extractors(*tracks, tspecs);
+      create_extractors(*tracks, tspecs, num_threads);
     }
+
+    if (range_start.valid() && tracks_found)
+      range_start_position = find_range_start_position(*analyzer, tc_scale);
   }
 
   try {
@@ -423,7 +585,13 @@ extract_tracks(const std::string &file_name,
     KaxChapters all_chapters;
     KaxTags all_tags;
 
-    while ((l1 = file->read_next_level1_element())) {
+    // Info and Tracks have already been handled via the analyzer.
+    if (range_start_position)
+      in->setFilePointer(*range_start_position);
+
+    auto range_done = false;
+
+    while (!range_done && (l1 = file->read_next_level1_element())) {
       if (Is<KaxInfo>(l1) && !segment_info_found) {
         segment_info_found = true;
         handle_segment_info(static_cast<EbmlMaster *>(l1), file.get(), tc_scale);
@@ -431,12 +599,22 @@ extract_tracks(const std::string &file_name,
       } else if (Is<KaxTracks>(l1) && !tracks_found) {
         tracks_found = true;
         find_and_verify_track_uids(*dynamic_cast<KaxTracks *>(l1), tspecs);
-        create_extractors(*dynamic_cast<KaxTracks *>(l1), tspecs);
+        create_extractors(*dynamic_cast<KaxTracks *>(l1), tspecs, num_threads);
 
       } else if (Is<KaxCluster>(l1)) {
         show_element(l1, 1, Y("Cluster"));
         KaxCluster *cluster = static_cast<KaxCluster *>(l1);
 
+        if (s_range.is_done(timestamp_c::ns(FindChildValue<KaxClusterTimecode>(cluster) * tc_scale))) {
+          range_done = true;
+          delete l1;
+          continue;
+        }
+
+        // The workers may still need the cluster's data after it has
+        // been parsed here. The pipeline deletes it once they're done.
+        auto pipelined_cluster = s_pipeline ? s_pipeline->adopt_cluster(cluster) : extraction_pipeline_c::cluster_cptr{};
+
         if (0 == verbose) {
           auto current_percentage = in->getFilePointer() * 100 / file_size;
 
@@ -463,11 +641,11 @@ extract_tracks(const std::string &file_name,
 
           if (Is<KaxBlockGroup>(el)) {
             show_element(el, 2, Y("Block group"));
-            max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
+            max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, pipelined_cluster, tc_scale);
 
           } else if (Is<KaxSimpleBlock>(el)) {
             show_element(el, 2, Y("SimpleBlock"));
-            max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
+            max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster, pipelined_cluster);
           }
 
           max_timecode = std::max(max_timecode, max_bg_timecode);
@@ -476,6 +654,9 @@ extract_tracks(const std::string &file_name,
         if (-1 != max_timecode)
           file->set_last_timecode(max_timecode);
 
+        if (pipelined_cluster)
+          l1 = nullptr;
+
       } else if (Is<KaxChapters>(l1)) {
         KaxChapters &chapters = *static_cast<KaxChapters *>(l1);
 
@@ -523,7 +704,15 @@ extract_tracks(const std::string &file_name,
     }
 
     return true;
+  } catch (mtx::output::error_x &ex) {
+    // An extractor running on a worker thread has failed.
+    s_pipeline.reset();
+    mxerror(ex.what());
+
+    return false;
+
   } catch (...) {
+    s_pipeline.reset();
     show_error(Y("Caught exception"));
 
     return false;
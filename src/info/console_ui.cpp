@@ -12,6 +12,7 @@
 
 #include "common/common_pch.h"
 
+#include "info/json_output.h"
 #include "info/mkvinfo.h"
 
 void
@@ -31,7 +32,10 @@ console_show_element(int level,
 
 void
 console_show_error(const std::string &error) {
-  mxinfo(boost::format("(%1%) %2%\n") % NAME % error);
+  if (json_output_enabled())
+    json_output({ { "type", "error" }, { "message", error } });
+  else
+    mxinfo(boost::format("(%1%) %2%\n") % NAME % error);
   mxexit(2);
 }
 
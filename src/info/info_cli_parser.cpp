@@ -35,17 +35,18 @@ info_cli_parser_c::init_parser() {
   add_section_header(YT("Options"));
 
 #if defined(HAVE_QT)
-  OPT("G|no-gui",        set_no_gui,        YT("Do not start the GUI."));
-  OPT("g|gui",           set_gui,           YT("Start the GUI (and open inname if it was given)."));
+  OPT("G|no-gui",               set_no_gui,        YT("Do not start the GUI."));
+  OPT("g|gui",                  set_gui,           YT("Start the GUI (and open inname if it was given)."));
 #endif
-  OPT("c|checksum",      set_checksum,      YT("Calculate and display checksums of frame contents."));
-  OPT("C|check-mode",    set_check_mode,    YT("Calculate and display checksums and use verbosity level 4."));
-  OPT("s|summary",       set_summary,       YT("Only show summaries of the contents, not each element."));
-  OPT("t|track-info",    set_track_info,    YT("Show statistics for each track in verbose mode."));
-  OPT("x|hexdump",       set_hexdump,       YT("Show the first 16 bytes of each frame as a hex dump."));
-  OPT("X|full-hexdump",  set_full_hexdump,  YT("Show all bytes of each frame as a hex dump."));
-  OPT("p|hex-positions", set_hex_positions, YT("Show positions in hexadecimal."));
-  OPT("z|size",          set_size,          YT("Show the size of each element including its header."));
+  OPT("c|checksum",             set_checksum,      YT("Calculate and display checksums of frame contents."));
+  OPT("C|check-mode",           set_check_mode,    YT("Calculate and display checksums and use verbosity level 4."));
+  OPT("s|summary",              set_summary,       YT("Only show summaries of the contents, not each element."));
+  OPT("t|track-info",           set_track_info,    YT("Show statistics for each track in verbose mode."));
+  OPT("x|hexdump",              set_hexdump,       YT("Show the first 16 bytes of each frame as a hex dump."));
+  OPT("X|full-hexdump",         set_full_hexdump,  YT("Show all bytes of each frame as a hex dump."));
+  OPT("p|hex-positions",        set_hex_positions, YT("Show positions in hexadecimal."));
+  OPT("z|size",                 set_size,          YT("Show the size of each element including its header."));
+  OPT("output-format=<format>", set_output_format, YT("Sets the output format to 'text' (default) or 'json'. JSON output consists of one JSON object per line."));
 
   add_common_options();
 
@@ -124,11 +125,28 @@ info_cli_parser_c::set_hex_positions() {
   m_options.m_hex_positions = true;
 }
 
+void
+info_cli_parser_c::set_output_format() {
+  auto format = balg::to_lower_copy(m_next_arg);
+
+  if (format == "text")
+    m_options.m_output_format = options_c::output_format_e::text;
+
+  else if (format == "json")
+    m_options.m_output_format = options_c::output_format_e::json;
+
+  else
+    mxerror(boost::format(Y("Invalid output format in '%1% %2%'.\n")) % m_current_arg % m_next_arg);
+}
+
 options_c
 info_cli_parser_c::run() {
   init_parser();
   parse_args();
 
+  if (m_options.m_use_gui && (options_c::output_format_e::json == m_options.m_output_format))
+    mxerror(Y("The JSON output format cannot be used together with the GUI.\n"));
+
   m_options.m_verbose = verbose;
   verbose             = 0;
 
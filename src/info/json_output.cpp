@@ -0,0 +1,150 @@
+/*
+   mkvinfo -- utility for gathering information about Matroska files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   JSON output for mkvinfo
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlBinary.h>
+#include <ebml/EbmlDate.h>
+#include <ebml/EbmlFloat.h>
+#include <ebml/EbmlMaster.h>
+#include <ebml/EbmlSInteger.h>
+#include <ebml/EbmlString.h>
+#include <ebml/EbmlUInteger.h>
+#include <ebml/EbmlUnicodeString.h>
+#include <matroska/KaxBlock.h>
+
+#include "common/checksums/base.h"
+#include "common/ebml.h"
+#include "common/math.h"
+#include "common/strings/editing.h"
+#include "common/strings/formatting.h"
+#include "info/json_output.h"
+#include "info/mkvinfo.h"
+
+using namespace libmatroska;
+
+namespace {
+
+void
+add_binary_data(nlohmann::json &json,
+                unsigned char const *buffer,
+                std::size_t size) {
+  if (g_options.m_calc_checksums)
+    json["adler32"] = mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, buffer, size);
+
+  if (g_options.m_show_hexdump)
+    json["hexdump"] = to_hex(buffer, std::min<std::size_t>(size, g_options.m_hexdump_max_size), true);
+}
+
+void
+add_block_data(nlohmann::json &json,
+               KaxInternalBlock &block) {
+  auto frames = nlohmann::json::array();
+
+  for (auto idx = 0u; idx < block.NumberFrames(); ++idx) {
+    auto &data  = block.GetBuffer(idx);
+    auto frame  = nlohmann::json{ { "size", data.Size() } };
+
+    add_binary_data(frame, data.Buffer(), data.Size());
+    frames.push_back(frame);
+  }
+
+  json["track_number"] = block.TrackNum();
+  json["timecode"]     = mtx::math::to_signed(block.GlobalTimecode());
+  json["frames"]       = frames;
+
+  if (Is<KaxSimpleBlock>(block)) {
+    json["keyframe"]    = static_cast<KaxSimpleBlock &>(block).IsKeyframe();
+    json["discardable"] = static_cast<KaxSimpleBlock &>(block).IsDiscardable();
+  }
+}
+
+void
+json_warning_error_handler(unsigned int level,
+                           std::string const &message) {
+  auto stripped = message;
+  strip(stripped, true);
+
+  json_output({
+    { "type",    MXMSG_WARNING == level ? "warning" : "error" },
+    { "message", stripped                                      },
+  });
+
+  if (MXMSG_ERROR == level)
+    mxexit(2);
+}
+
+}
+
+bool
+json_output_enabled() {
+  return options_c::output_format_e::json == g_options.m_output_format;
+}
+
+void
+json_output_init() {
+  set_mxmsg_handler(MXMSG_WARNING, json_warning_error_handler);
+  set_mxmsg_handler(MXMSG_ERROR,   json_warning_error_handler);
+}
+
+void
+json_output(nlohmann::json const &json) {
+  mxinfo(mtx::json::dump(json) + "\n");
+}
+
+nlohmann::json
+json_element(EbmlElement &element) {
+  auto json = nlohmann::json{
+    { "name",        EBML_NAME(&element)                                },
+    { "id",          EBML_ID_VALUE(static_cast<EbmlId const &>(element)) },
+    { "position",    element.GetElementPosition()                       },
+    { "header_size", element.HeadSize()                                 },
+  };
+
+  if (element.IsFiniteSize())
+    json["data_size"] = element.GetSize();
+  else
+    json["data_size"] = nullptr;
+
+  if (dynamic_cast<KaxInternalBlock *>(&element))
+    add_block_data(json, static_cast<KaxInternalBlock &>(element));
+
+  else if (dynamic_cast<EbmlMaster *>(&element)) {
+    auto children = nlohmann::json::array();
+    for (auto child : static_cast<EbmlMaster &>(element))
+      children.push_back(json_element(*child));
+
+    json["children"] = children;
+
+  } else if (dynamic_cast<EbmlUInteger *>(&element))
+    json["value"] = static_cast<EbmlUInteger &>(element).GetValue();
+
+  else if (dynamic_cast<EbmlSInteger *>(&element))
+    json["value"] = static_cast<EbmlSInteger &>(element).GetValue();
+
+  else if (dynamic_cast<EbmlFloat *>(&element))
+    json["value"] = static_cast<EbmlFloat &>(element).GetValue();
+
+  else if (dynamic_cast<EbmlUnicodeString *>(&element))
+    json["value"] = static_cast<EbmlUnicodeString &>(element).GetValueUTF8();
+
+  else if (dynamic_cast<EbmlString *>(&element))
+    json["value"] = static_cast<EbmlString &>(element).GetValue();
+
+  else if (dynamic_cast<EbmlDate *>(&element))
+    json["value"] = static_cast<EbmlDate &>(element).GetEpochDate();
+
+  else if (dynamic_cast<EbmlBinary *>(&element))
+    add_binary_data(json, static_cast<EbmlBinary &>(element).GetBuffer(), static_cast<EbmlBinary &>(element).GetSize());
+
+  return json;
+}
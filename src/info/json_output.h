@@ -0,0 +1,37 @@
+/*
+   mkvinfo -- utility for gathering information about Matroska files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for mkvinfo's JSON output
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_INFO_JSON_OUTPUT_H
+#define MTX_INFO_JSON_OUTPUT_H
+
+#include "common/common_pch.h"
+
+#include "common/json.h"
+
+namespace libebml {
+class EbmlElement;
+};
+
+// The JSON output is written as one JSON object per line as soon as
+// the corresponding data has been read so that memory usage doesn't
+// grow with the file size. Each object has a "type" key; see the
+// mkvinfo man page for the format.
+
+bool json_output_enabled();
+void json_output_init();
+void json_output(nlohmann::json const &json);
+
+// Converts an element and all of its children. Blocks must have been
+// connected to their cluster with SetParent() before.
+nlohmann::json json_element(libebml::EbmlElement &element);
+
+#endif // MTX_INFO_JSON_OUTPUT_H
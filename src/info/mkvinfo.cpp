@@ -63,6 +63,7 @@
 #include "common/endian.h"
 #include "common/fourcc.h"
 #include "common/hevc.h"
+#include "common/kax_block_parser.h"
 #include "common/kax_file.h"
 #include "common/math.h"
 #include "common/mm_io.h"
@@ -70,11 +71,13 @@
 #include "common/mpeg4_p10.h"
 #include "common/stereo_mode.h"
 #include "common/strings/editing.h"
+#include "common/strings/fast_format.h"
 #include "common/strings/formatting.h"
 #include "common/translation.h"
 #include "common/version.h"
 #include "common/xml/ebml_chapters_converter.h"
 #include "common/xml/ebml_tags_converter.h"
+#include "info/json_output.h"
 #include "info/mkvinfo.h"
 #include "info/info_cli_parser.h"
 
@@ -133,10 +136,13 @@ std::map<unsigned int, track_info_t> s_track_info;
 options_c g_options;
 static uint64_t s_tc_scale = TIMECODE_SCALE;
 std::vector<boost::format> g_common_boost_formats;
+std::vector<fast_format_c> g_common_fast_formats;
+static bool s_use_fast_formats = false;
 size_t s_mkvmerge_track_id = 0;
 
 #define BF_DO(n)                             g_common_boost_formats[n]
-#define BF_ADD(s)                            g_common_boost_formats.push_back(boost::format(s))
+#define BF_ADD(s)                            add_common_format(s)
+#define FF_DO(n)                             g_common_fast_formats[n]
 #define BF_SHOW_UNKNOWN_ELEMENT              BF_DO( 0)
 #define BF_EBMLVOID                          BF_DO( 1)
 #define BF_FORMAT_BINARY_1                   BF_DO( 2)
@@ -176,9 +182,23 @@ size_t s_mkvmerge_track_id = 0;
 #define BF_BLOCK_GROUP_DISCARD_PADDING       BF_DO(33)
 #define BF_AT_HEX                            BF_DO(34)
 
+// The summary lines are output once per frame. They're formatted with
+// fast_format_c unless a translation uses directives it doesn't know.
+#define FF_SUMMARY_POSITION                  FF_DO(19)
+#define FF_BLOCK_GROUP_SUMMARY_WITH_DURATION FF_DO(20)
+#define FF_BLOCK_GROUP_SUMMARY_NO_DURATION   FF_DO(21)
+#define FF_SIMPLE_BLOCK_SUMMARY              FF_DO(25)
+
+static void
+add_common_format(std::string const &format) {
+  g_common_boost_formats.push_back(boost::format(format));
+  g_common_fast_formats.emplace_back(format);
+}
+
 void
 init_common_boost_formats() {
   g_common_boost_formats.clear();
+  g_common_fast_formats.clear();
   BF_ADD(Y("(Unknown element: %1%; ID: 0x%2% size: %3%)"));                                                     //  0 -- BF_SHOW_UNKNOWN_ELEMENT
   BF_ADD(Y("EbmlVoid (size: %1%)"));                                                                            //  1 -- BF_EBMLVOID
   BF_ADD(Y("length %1%, data: %2%"));                                                                           //  2 -- BF_FORMAT_BINARY_1
@@ -214,6 +234,11 @@ init_common_boost_formats() {
   BF_ADD(Y(" size %1%"));                                                                                       // 32 -- BF_SIZE
   BF_ADD(Y("Discard padding: %|1$.3f|ms (%2%ns)"));                                                             // 33 -- BF_BLOCK_GROUP_DISCARD_PADDING
   BF_ADD(Y(" at 0x%|1$x|"));                                                                                    // 34 -- BF_AT_HEX
+
+  s_use_fast_formats = FF_SUMMARY_POSITION.is_supported()
+                    && FF_BLOCK_GROUP_SUMMARY_WITH_DURATION.is_supported()
+                    && FF_BLOCK_GROUP_SUMMARY_NO_DURATION.is_supported()
+                    && FF_SIMPLE_BLOCK_SUMMARY.is_supported();
 }
 
 std::string
@@ -274,7 +299,7 @@ _show_element(EbmlElement *l,
               bool skip,
               int level,
               const std::string &info) {
-  if (g_options.m_show_summary)
+  if (g_options.m_show_summary || json_output_enabled())
     return;
 
   ui_show_element(level, info,
@@ -1057,7 +1082,7 @@ handle_tracks(EbmlStream *&es,
         } else if (!is_global(es, l3, 3))
           show_unknown_element(l3, 3);
 
-      if (g_options.m_show_summary)
+      if (g_options.m_show_summary && !json_output_enabled())
         mxinfo(boost::format(Y("Track %1%: %2%, codec ID: %3%%4%%5%%6%\n"))
                % track->tnum
                % (  'a' == track->type ? Y("audio")
@@ -1251,6 +1276,183 @@ handle_silent_track(EbmlStream *&es,
       show_unknown_element(l3, 3);
 }
 
+static std::string
+format_summary_position(int64_t frame_pos) {
+  if (s_use_fast_formats)
+    return FF_SUMMARY_POSITION.format({ frame_pos });
+  return (BF_BLOCK_GROUP_SUMMARY_POSITION % frame_pos).str();
+}
+
+static void
+show_frame_summary_json(char frame_type,
+                        uint64_t track_number,
+                        int64_t timecode,
+                        int64_t duration,
+                        std::vector<int> const &frame_sizes,
+                        std::vector<uint32_t> const &frame_adlers,
+                        int64_t frame_pos) {
+  for (auto fidx = 0u; fidx < frame_sizes.size(); ++fidx) {
+    auto json = nlohmann::json{
+      { "type",         "frame"                     },
+      { "frame_type",   std::string(1, frame_type)  },
+      { "track_number", track_number                },
+      { "timecode",     timecode                    },
+      { "size",         frame_sizes[fidx]           },
+      { "adler32",      frame_adlers[fidx]          },
+      { "position",     frame_pos                   },
+    };
+
+    if (-1 != duration)
+      json["duration"] = duration;
+
+    json_output(json);
+
+    frame_pos += frame_sizes[fidx];
+  }
+}
+
+static void
+show_block_group_summary(unsigned int num_references,
+                         int64_t track_number,
+                         int64_t timecode,
+                         int64_t duration,
+                         std::vector<int> const &frame_sizes,
+                         std::vector<uint32_t> const &frame_adlers,
+                         std::vector<std::string> const &frame_hexdumps,
+                         int64_t frame_pos) {
+  auto frame_type  = num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I';
+
+  if (json_output_enabled()) {
+    show_frame_summary_json(frame_type, track_number, timecode, duration, frame_sizes, frame_adlers, frame_pos);
+    return;
+  }
+
+  auto timecode_ms = std::llround(timecode / 1000000.0);
+  auto timestamp   = format_timestamp(timecode, 3);
+  auto duration_ms = static_cast<float>(duration / 1000000.0);
+  std::string position;
+
+  for (auto fidx = 0u; fidx < frame_sizes.size(); ++fidx) {
+    if (1 <= g_options.m_verbose) {
+      position   = format_summary_position(frame_pos);
+      frame_pos += frame_sizes[fidx];
+    }
+
+    if (s_use_fast_formats && (-1 != duration))
+      mxinfo(FF_BLOCK_GROUP_SUMMARY_WITH_DURATION.format({ frame_type, track_number, timecode_ms, timestamp, duration_ms, frame_sizes[fidx], frame_adlers[fidx], frame_hexdumps[fidx], position }));
+
+    else if (s_use_fast_formats)
+      mxinfo(FF_BLOCK_GROUP_SUMMARY_NO_DURATION.format({ frame_type, track_number, timecode_ms, timestamp, frame_sizes[fidx], frame_adlers[fidx], frame_hexdumps[fidx], position }));
+
+    else if (-1 != duration)
+      mxinfo(BF_BLOCK_GROUP_SUMMARY_WITH_DURATION
+             % frame_type
+             % track_number
+             % timecode_ms
+             % timestamp
+             % duration_ms
+             % frame_sizes[fidx]
+             % frame_adlers[fidx]
+             % frame_hexdumps[fidx]
+             % position);
+    else
+      mxinfo(BF_BLOCK_GROUP_SUMMARY_NO_DURATION
+             % frame_type
+             % track_number
+             % timecode_ms
+             % timestamp
+             % frame_sizes[fidx]
+             % frame_adlers[fidx]
+             % frame_hexdumps[fidx]
+             % position);
+  }
+}
+
+static void
+show_simple_block_summary(char frame_type,
+                          uint64_t track_number,
+                          int64_t timecode_ns,
+                          std::vector<int> const &frame_sizes,
+                          std::vector<uint32_t> const &frame_adlers,
+                          int64_t frame_pos) {
+  if (json_output_enabled()) {
+    show_frame_summary_json(frame_type, track_number, timecode_ns, -1, frame_sizes, frame_adlers, frame_pos);
+    return;
+  }
+
+  auto timecode_ms = std::llround(static_cast<double>(timecode_ns) / 1000000.0);
+  auto timestamp   = format_timestamp(timecode_ns, 3);
+  std::string position;
+
+  for (auto fidx = 0u; fidx < frame_sizes.size(); ++fidx) {
+    if (1 <= g_options.m_verbose) {
+      position   = format_summary_position(frame_pos);
+      frame_pos += frame_sizes[fidx];
+    }
+
+    if (s_use_fast_formats)
+      mxinfo(FF_SIMPLE_BLOCK_SUMMARY.format({ frame_type, track_number, timecode_ms, timestamp, frame_sizes[fidx], frame_adlers[fidx], position }));
+
+    else
+      mxinfo(BF_SIMPLE_BLOCK_SUMMARY
+             % frame_type
+             % track_number
+             % timecode_ms
+             % timestamp
+             % frame_sizes[fidx]
+             % frame_adlers[fidx]
+             % position);
+  }
+}
+
+static void
+add_block_group_track_info(unsigned int num_references,
+                           int64_t track_number,
+                           int64_t timecode,
+                           int64_t duration,
+                           std::vector<int> const &frame_sizes) {
+  track_info_t &tinfo = s_track_info[track_number];
+
+  tinfo.m_blocks                                          += frame_sizes.size();
+  tinfo.m_blocks_by_ref_num[std::min(num_references, 2u)] += frame_sizes.size();
+  tinfo.m_min_timecode                                     = std::min(tinfo.m_min_timecode, timecode);
+  tinfo.m_size                                            += boost::accumulate(frame_sizes, 0);
+
+  if (!tinfo.max_timecode_unset() && (tinfo.m_max_timecode >= timecode))
+    return;
+
+  tinfo.m_max_timecode = timecode;
+
+  if (-1 == duration)
+    tinfo.m_add_duration_for_n_packets  = frame_sizes.size();
+  else {
+    tinfo.m_max_timecode               += duration;
+    tinfo.m_add_duration_for_n_packets  = 0;
+  }
+}
+
+static void
+add_simple_block_track_info(char frame_type,
+                            uint64_t track_number,
+                            int64_t timecode_ns,
+                            std::vector<int> const &frame_sizes) {
+  track_info_t &tinfo = s_track_info[track_number];
+
+  tinfo.m_blocks                                                               += frame_sizes.size();
+  tinfo.m_blocks_by_ref_num['I' == frame_type ? 0 : 'B' == frame_type ? 2 : 1] += frame_sizes.size();
+  tinfo.m_min_timecode                                                          = std::min(tinfo.m_min_timecode, timecode_ns);
+  tinfo.m_max_timecode                                                          = std::max(tinfo.max_timecode_unset() ? 0 : tinfo.m_max_timecode, timecode_ns);
+  tinfo.m_add_duration_for_n_packets                                            = frame_sizes.size();
+  tinfo.m_size                                                                 += boost::accumulate(frame_sizes, 0);
+}
+
+// Only the summary lines need the checksums if they aren't requested
+// explicitly.
+static bool
+need_frame_checksums() {
+  return g_options.m_calc_checksums || g_options.m_show_summary;
+}
+
 void
 handle_block_group(EbmlStream *&es,
                    EbmlElement *&l2,
@@ -1266,7 +1468,7 @@ handle_block_group(EbmlStream *&es,
   int64_t lf_tnum     = 0;
   int64_t frame_pos   = 0;
 
-  float bduration     = -1.0;
+  int64_t bduration   = -1;
 
   for (auto l3 : *static_cast<EbmlMaster *>(l2))
     if (Is<KaxBlock>(l3)) {
@@ -1275,7 +1477,7 @@ handle_block_group(EbmlStream *&es,
 
       lf_timecode = block.GlobalTimecode();
       lf_tnum     = block.TrackNum();
-      bduration   = -1.0;
+      bduration   = -1;
       frame_pos   = block.GetElementPosition() + block.ElementSize();
 
       show_element(l3, 3,
@@ -1287,14 +1489,14 @@ handle_block_group(EbmlStream *&es,
 
       for (size_t i = 0; i < block.NumberFrames(); ++i) {
         auto &data = block.GetBuffer(i);
-        auto adler = mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, data.Buffer(), data.Size());
+        auto adler = need_frame_checksums() ? mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, data.Buffer(), data.Size()) : 0;
 
         std::string adler_str;
         if (g_options.m_calc_checksums)
           adler_str = (BF_BLOCK_GROUP_BLOCK_ADLER % adler).str();
 
         std::string hex;
-        if (g_options.m_show_hexdump)
+        if (g_options.m_show_hexdump && !json_output_enabled())
           hex = create_hexdump(data.Buffer(), data.Size());
 
         show_element(nullptr, 4, BF_BLOCK_GROUP_BLOCK_FRAME % data.Size() % adler_str % hex);
@@ -1307,7 +1509,7 @@ handle_block_group(EbmlStream *&es,
 
     } else if (Is<KaxBlockDuration>(l3)) {
       auto duration = static_cast<KaxBlockDuration *>(l3)->GetValue();
-      bduration     = static_cast<double>(duration) * s_tc_scale / 1000000.0;
+      bduration     = duration * s_tc_scale;
       show_element(l3, 3, BF_BLOCK_GROUP_DURATION % (duration * s_tc_scale / 1000000) % (duration * s_tc_scale % 1000000));
 
     } else if (Is<KaxReferenceBlock>(l3)) {
@@ -1392,64 +1594,17 @@ handle_block_group(EbmlStream *&es,
     } else if (!is_global(es, l3, 3))
       show_unknown_element(l3, 3);
 
-  if (g_options.m_show_summary) {
-    std::string position;
-    size_t fidx;
-
-    for (fidx = 0; fidx < frame_sizes.size(); fidx++) {
-      if (1 <= g_options.m_verbose) {
-        position   = (BF_BLOCK_GROUP_SUMMARY_POSITION % frame_pos).str();
-        frame_pos += frame_sizes[fidx];
-      }
-
-      if (bduration != -1.0)
-        mxinfo(BF_BLOCK_GROUP_SUMMARY_WITH_DURATION
-               % (num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I')
-               % lf_tnum
-               % std::llround(lf_timecode / 1000000.0)
-               % format_timestamp(lf_timecode, 3)
-               % bduration
-               % frame_sizes[fidx]
-               % frame_adlers[fidx]
-               % frame_hexdumps[fidx]
-               % position);
-      else
-        mxinfo(BF_BLOCK_GROUP_SUMMARY_NO_DURATION
-               % (num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I')
-               % lf_tnum
-               % std::llround(lf_timecode / 1000000.0)
-               % format_timestamp(lf_timecode, 3)
-               % frame_sizes[fidx]
-               % frame_adlers[fidx]
-               % frame_hexdumps[fidx]
-               % position);
-    }
+  if (g_options.m_show_summary)
+    show_block_group_summary(num_references, lf_tnum, lf_timecode, bduration, frame_sizes, frame_adlers, frame_hexdumps, frame_pos);
 
-  } else if (g_options.m_verbose > 2)
+  else if (g_options.m_verbose > 2)
     show_element(nullptr, 2,
                  BF_BLOCK_GROUP_SUMMARY_V2
                  % (num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I')
                  % lf_tnum
                  % std::llround(lf_timecode / 1000000.0));
 
-  track_info_t &tinfo = s_track_info[lf_tnum];
-
-  tinfo.m_blocks                                          += frame_sizes.size();
-  tinfo.m_blocks_by_ref_num[std::min(num_references, 2u)] += frame_sizes.size();
-  tinfo.m_min_timecode                                     = std::min(tinfo.m_min_timecode, lf_timecode);
-  tinfo.m_size                                            += boost::accumulate(frame_sizes, 0);
-
-  if (!tinfo.max_timecode_unset() && (tinfo.m_max_timecode >= lf_timecode))
-    return;
-
-  tinfo.m_max_timecode = lf_timecode;
-
-  if (-1 == bduration)
-    tinfo.m_add_duration_for_n_packets  = frame_sizes.size();
-  else {
-    tinfo.m_max_timecode               += bduration * 1000000.0;
-    tinfo.m_add_duration_for_n_packets  = 0;
-  }
+  add_block_group_track_info(num_references, lf_tnum, lf_timecode, bduration, frame_sizes);
 }
 
 void
@@ -1462,10 +1617,9 @@ handle_simple_block(EbmlStream *&es,
   KaxSimpleBlock &block = *static_cast<KaxSimpleBlock *>(l2);
   block.SetParent(*cluster);
 
-  int64_t frame_pos   = block.GetElementPosition() + block.ElementSize();
-  auto timecode_ns    = mtx::math::to_signed(block.GlobalTimecode());
-  auto timecode_ms    = std::llround(static_cast<double>(timecode_ns) / 1000000.0);
-  track_info_t &tinfo = s_track_info[block.TrackNum()];
+  int64_t frame_pos = block.GetElementPosition() + block.ElementSize();
+  auto timecode_ns  = mtx::math::to_signed(block.GlobalTimecode());
+  auto timecode_ms  = std::llround(static_cast<double>(timecode_ns) / 1000000.0);
 
   std::string info;
   if (block.IsKeyframe())
@@ -1484,14 +1638,14 @@ handle_simple_block(EbmlStream *&es,
   int i;
   for (i = 0; i < (int)block.NumberFrames(); i++) {
     DataBuffer &data = block.GetBuffer(i);
-    uint32_t adler   = mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, data.Buffer(), data.Size());
+    uint32_t adler   = need_frame_checksums() ? mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, data.Buffer(), data.Size()) : 0;
 
     std::string adler_str;
     if (g_options.m_calc_checksums)
       adler_str = (BF_SIMPLE_BLOCK_ADLER % adler).str();
 
     std::string hex;
-    if (g_options.m_show_hexdump)
+    if (g_options.m_show_hexdump && !json_output_enabled())
       hex = create_hexdump(data.Buffer(), data.Size());
 
     show_element(nullptr, 3, BF_SIMPLE_BLOCK_FRAME % data.Size() % adler_str % hex);
@@ -1501,39 +1655,19 @@ handle_simple_block(EbmlStream *&es,
     frame_pos -= data.Size();
   }
 
-  if (g_options.m_show_summary) {
-    std::string position;
-    size_t fidx;
+  auto frame_type = block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P';
 
-    for (fidx = 0; fidx < frame_sizes.size(); fidx++) {
-      if (1 <= g_options.m_verbose) {
-        position   = (BF_SIMPLE_BLOCK_POSITION % frame_pos).str();
-        frame_pos += frame_sizes[fidx];
-      }
-
-      mxinfo(BF_SIMPLE_BLOCK_SUMMARY
-             % (block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P')
-             % block.TrackNum()
-             % timecode_ms
-             % format_timestamp(timecode_ns, 3)
-             % frame_sizes[fidx]
-             % frame_adlers[fidx]
-             % position);
-    }
+  if (g_options.m_show_summary)
+    show_simple_block_summary(frame_type, block.TrackNum(), timecode_ns, frame_sizes, frame_adlers, frame_pos);
 
-  } else if (g_options.m_verbose > 2)
+  else if (g_options.m_verbose > 2)
     show_element(nullptr, 2,
                  BF_SIMPLE_BLOCK_SUMMARY_V2
-                 % (block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P')
+                 % frame_type
                  % block.TrackNum()
                  % timecode_ms);
 
-  tinfo.m_blocks                                                                    += block.NumberFrames();
-  tinfo.m_blocks_by_ref_num[block.IsKeyframe() ? 0 : block.IsDiscardable() ? 2 : 1] += block.NumberFrames();
-  tinfo.m_min_timecode                                                                = std::min(tinfo.m_min_timecode, static_cast<int64_t>(timecode_ns));
-  tinfo.m_max_timecode                                                                = std::max(tinfo.max_timecode_unset() ? 0 : tinfo.m_max_timecode, static_cast<int64_t>(timecode_ns));
-  tinfo.m_add_duration_for_n_packets                                                  = block.NumberFrames();
-  tinfo.m_size                                                                       += boost::accumulate(frame_sizes, 0);
+  add_simple_block_track_info(frame_type, block.TrackNum(), timecode_ns, frame_sizes);
 }
 
 void
@@ -1576,6 +1710,180 @@ handle_cluster(EbmlStream *&es,
       show_unknown_element(l2, 2);
 }
 
+// Summary mode only needs the block headers, the frame sizes and
+// checksums. Instead of letting libebml build element trees for all of
+// a cluster's children the cluster is read into memory in one go and
+// walked directly. Returns false without having consumed anything if
+// the next element isn't a cluster or if its structure is anything but
+// simple (e.g. unknown sizes or invalid lacing). The caller then falls
+// back to the libebml based code.
+bool
+handle_cluster_fast(mm_io_c &in,
+                    uint64_t segment_end) {
+  struct block_t {
+    bool m_simple_block{}, m_block_found{};
+    mtx::kax::raw_block_t m_block;
+    unsigned int m_num_references{};
+    int64_t m_duration{-1};
+    int64_t m_frame_pos{};
+    std::vector<int> m_frame_sizes;
+    std::vector<unsigned char const *> m_frames;
+  };
+
+  static auto s_cluster_buffer = memory_c::alloc(0);
+  static auto s_blocks         = std::vector<block_t>{};
+
+  auto cluster_pos = in.getFilePointer();
+  segment_end      = std::min<uint64_t>(segment_end, in.get_size());
+  if (cluster_pos >= segment_end)
+    return false;
+
+  unsigned char header[12];
+  auto cluster     = mtx::kax::raw_element_t{};
+  auto header_size = in.read(header, std::min<uint64_t>(sizeof(header), segment_end - cluster_pos));
+
+  if (   !mtx::kax::read_raw_element_header(header, header_size, cluster)
+      || (EBML_ID_VALUE(EBML_ID(KaxCluster)) != cluster.m_id)
+      || (cluster.get_total_size() > (segment_end - cluster_pos))) {
+    in.setFilePointer(cluster_pos);
+    return false;
+  }
+
+  s_cluster_buffer->resize(cluster.m_data_size);
+  in.setFilePointer(cluster_pos + cluster.m_header_size);
+  if (in.read(s_cluster_buffer->get_buffer(), cluster.m_data_size) != cluster.m_data_size) {
+    in.setFilePointer(cluster_pos);
+    return false;
+  }
+
+  auto data           = s_cluster_buffer->get_buffer();
+  auto data_pos       = static_cast<int64_t>(cluster_pos + cluster.m_header_size);
+  auto cluster_tc     = uint64_t{};
+  auto cluster_tc_set = false;
+  auto num_blocks     = 0u;
+
+  auto add_block = [&num_blocks](bool simple_block) -> block_t & {
+    if (s_blocks.size() <= num_blocks)
+      s_blocks.resize(num_blocks + 1);
+
+    auto &block            = s_blocks[num_blocks++];
+    block.m_simple_block   = simple_block;
+    block.m_block_found    = false;
+    block.m_num_references = 0;
+    block.m_duration       = -1;
+    block.m_frame_sizes.clear();
+    block.m_frames.clear();
+
+    return block;
+  };
+
+  auto parse_block = [data, data_pos](block_t &block, std::size_t pos, mtx::kax::raw_element_t const &element) -> bool {
+    auto block_data = data + pos + element.m_header_size;
+    if (!block.m_block.parse(block_data, element.m_data_size))
+      return false;
+
+    block.m_block_found = true;
+    block.m_frame_pos   = data_pos + pos + element.get_total_size();
+
+    for (auto const &frame : block.m_block.m_frames) {
+      block.m_frames.push_back(block_data + frame.m_offset);
+      block.m_frame_sizes.push_back(frame.m_size);
+      block.m_frame_pos -= frame.m_size;
+    }
+
+    return true;
+  };
+
+  auto ok = true;
+
+  for (auto pos = std::size_t{}; ok && (pos < cluster.m_data_size);) {
+    auto l2 = mtx::kax::raw_element_t{};
+    if (!mtx::kax::read_raw_element(data + pos, cluster.m_data_size - pos, l2)) {
+      ok = false;
+      break;
+    }
+
+    if ((EBML_ID_VALUE(EBML_ID(KaxClusterTimecode)) == l2.m_id) && !cluster_tc_set) {
+      cluster_tc     = mtx::kax::read_raw_uint(data + pos + l2.m_header_size, l2.m_data_size);
+      cluster_tc_set = true;
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxSimpleBlock)) == l2.m_id)
+      ok = parse_block(add_block(true), pos, l2);
+
+    else if (EBML_ID_VALUE(EBML_ID(KaxBlockGroup)) == l2.m_id) {
+      auto &block = add_block(false);
+
+      for (std::size_t l3_pos = pos + l2.m_header_size, l3_end = pos + l2.get_total_size(); ok && (l3_pos < l3_end);) {
+        auto l3 = mtx::kax::raw_element_t{};
+        if (!mtx::kax::read_raw_element(data + l3_pos, l3_end - l3_pos, l3)) {
+          ok = false;
+          break;
+        }
+
+        if (EBML_ID_VALUE(EBML_ID(KaxBlock)) == l3.m_id) {
+          block.m_duration = -1;
+          ok               = parse_block(block, l3_pos, l3);
+
+        } else if (EBML_ID_VALUE(EBML_ID(KaxBlockDuration)) == l3.m_id)
+          block.m_duration = mtx::kax::read_raw_uint(data + l3_pos + l3.m_header_size, l3.m_data_size) * s_tc_scale;
+
+        else if (EBML_ID_VALUE(EBML_ID(KaxReferenceBlock)) == l3.m_id)
+          ++block.m_num_references;
+
+        l3_pos += l3.get_total_size();
+      }
+    }
+
+    pos += l2.get_total_size();
+  }
+
+  if (!ok) {
+    in.setFilePointer(cluster_pos);
+    return false;
+  }
+
+  auto frame_adlers   = std::vector<uint32_t>{};
+  auto frame_hexdumps = std::vector<std::string>{};
+
+  for (auto idx = 0u; idx < num_blocks; ++idx) {
+    // The timecode is calculated the same way
+    // KaxCluster::GetBlockGlobalTimecode() does. Block groups without
+    // a block are counted for track 0 at timecode 0 just like
+    // handle_block_group() does.
+    auto &block       = s_blocks[idx];
+    auto num_frames   = block.m_frames.size();
+    auto track_number = uint64_t{};
+    auto timecode     = int64_t{};
+
+    if (block.m_block_found) {
+      track_number = block.m_block.m_track_number;
+      timecode     = static_cast<int64_t>(block.m_block.m_relative_timecode) * static_cast<int64_t>(s_tc_scale) + static_cast<int64_t>(cluster_tc * s_tc_scale);
+    }
+
+    frame_adlers.resize(num_frames);
+    frame_hexdumps.resize(num_frames);
+
+    for (auto frame_idx = 0u; frame_idx < num_frames; ++frame_idx) {
+      frame_adlers[frame_idx] = mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, block.m_frames[frame_idx], block.m_frame_sizes[frame_idx]);
+      if (g_options.m_show_hexdump && !block.m_simple_block && !json_output_enabled())
+        frame_hexdumps[frame_idx] = create_hexdump(block.m_frames[frame_idx], block.m_frame_sizes[frame_idx]);
+    }
+
+    if (block.m_simple_block) {
+      auto frame_type = block.m_block.is_keyframe() ? 'I' : block.m_block.is_discardable() ? 'B' : 'P';
+
+      show_simple_block_summary(frame_type, track_number, timecode, block.m_frame_sizes, frame_adlers, block.m_frame_pos);
+      add_simple_block_track_info(frame_type, track_number, timecode, block.m_frame_sizes);
+
+    } else {
+      show_block_group_summary(block.m_num_references, track_number, timecode, block.m_duration, block.m_frame_sizes, frame_adlers, frame_hexdumps, block.m_frame_pos);
+      add_block_group_track_info(block.m_num_references, track_number, timecode, block.m_duration, block.m_frame_sizes);
+    }
+  }
+
+  return true;
+}
+
 void
 handle_elements_rec(EbmlStream *es,
                     int level,
@@ -1651,16 +1959,25 @@ handle_ebml_head(EbmlElement *l0,
                  EbmlStream *es) {
   show_element(l0, 0, Y("EBML head"));
 
+  auto json_head = nlohmann::json{};
+  if (json_output_enabled()) {
+    json_head         = json_element(*l0);
+    json_head["type"] = "ebml_head";
+  }
+
   while (in_parent(l0)) {
     int upper_lvl_el = 0;
     EbmlElement *e   = es->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true);
 
     if (!e)
-      return;
+      break;
 
     e->ReadData(*in);
 
-    if (Is<EVersion>(e))
+    if (json_output_enabled())
+      json_head["children"].push_back(json_element(*e));
+
+    else if (Is<EVersion>(e))
       show_element(e, 1, boost::format(Y("EBML version: %1%"))             % static_cast<EbmlUInteger *>(e)->GetValue());
 
     else if (Is<EReadVersion>(e))
@@ -1687,6 +2004,33 @@ handle_ebml_head(EbmlElement *l0,
     e->SkipData(*es, EBML_CONTEXT(e));
     delete e;
   }
+
+  if (json_output_enabled())
+    json_output(json_head);
+}
+
+// Outputs a level 1 element other than a cluster including all of its
+// children as a single JSON line. The segment information and the
+// tracks are still handled by their regular functions as the timecode
+// scale and the track list are needed later on. Just like in text mode
+// the entries of seek heads and cues are only output with -v -v.
+void
+handle_level1_json(EbmlStream *&es,
+                   int &upper_lvl_el,
+                   EbmlElement *&l1) {
+  if (Is<KaxInfo>(l1))
+    handle_info(es, upper_lvl_el, l1);
+
+  else if (Is<KaxTracks>(l1))
+    handle_tracks(es, upper_lvl_el, l1);
+
+  auto json    = json_element(*l1);
+  json["type"] = "element";
+
+  if ((g_options.m_verbose < 2) && Is<KaxSeekHead, KaxCues>(l1))
+    json.erase("children");
+
+  json_output(json);
 }
 
 void
@@ -1705,13 +2049,36 @@ handle_segment(EbmlElement *l0,
   else
     show_element(l0, 0, boost::format(Y("Segment, size %1%")) % l0->GetSize());
 
+  if (json_output_enabled()) {
+    auto json    = json_element(*l0);
+    json["type"] = "segment";
+    json.erase("children");
+
+    json_output(json);
+  }
+
   // Prevent reporting "first timecode after resync":
   kax_file->set_timecode_scale(-1);
 
-  while ((l1 = kax_file->read_next_level1_element())) {
+  static debugging_option_c s_debug_slow_summary{"mkvinfo_slow_summary"};
+  auto fast_summary = g_options.m_show_summary && !g_options.m_use_gui && !s_debug_slow_summary;
+
+  while (true) {
+    if (fast_summary && handle_cluster_fast(*in, kax_file->get_segment_end())) {
+      if (!in_parent(l0))
+        break;
+      continue;
+    }
+
+    if (!(l1 = kax_file->read_next_level1_element()))
+      break;
+
     std::shared_ptr<EbmlElement> af_l1(l1);
 
-    if (Is<KaxInfo>(l1))
+    if (json_output_enabled() && !Is<KaxCluster>(l1))
+      handle_level1_json(es, upper_lvl_el, l1);
+
+    else if (Is<KaxInfo>(l1))
       handle_info(es, upper_lvl_el, l1);
 
     else if (Is<KaxTracks>(l1))
@@ -1722,10 +2089,24 @@ handle_segment(EbmlElement *l0,
 
     else if (Is<KaxCluster>(l1)) {
       show_element(l1, 1, Y("Cluster"));
-      if ((g_options.m_verbose == 0) && !g_options.m_show_summary)
+      if ((g_options.m_verbose == 0) && !g_options.m_show_summary) {
+        if (json_output_enabled()) {
+          auto json    = json_element(*l1);
+          json["type"] = "element";
+          json.erase("children");
+          json_output(json);
+        }
         return;
+      }
+
       handle_cluster(es, upper_lvl_el, l1, file_size);
 
+      if (json_output_enabled() && !g_options.m_show_summary) {
+        auto json    = json_element(*l1);
+        json["type"] = "element";
+        json_output(json);
+      }
+
     } else if (Is<KaxCues>(l1))
       handle_cues(es, upper_lvl_el, l1);
 
@@ -1766,6 +2147,18 @@ display_track_info() {
     int64_t duration  = tinfo.m_max_timecode - tinfo.m_min_timecode;
     duration         += tinfo.m_add_duration_for_n_packets * track->default_duration;
 
+    if (json_output_enabled()) {
+      json_output({
+        { "type",         "track_statistics"                                                                   },
+        { "track_number", track->tnum                                                                          },
+        { "blocks",       tinfo.m_blocks                                                                       },
+        { "size",         tinfo.m_size                                                                         },
+        { "duration",     duration                                                                             },
+        { "bitrate",      static_cast<uint64_t>(duration == 0 ? 0 : tinfo.m_size * 8000000000.0 / duration) },
+      });
+      continue;
+    }
+
     mxinfo(boost::format(Y("Statistics for track number %1%: number of blocks: %2%; size in bytes: %3%; duration in seconds: %4%; approximate bitrate in bits/second: %5%\n"))
            % track->tnum
            % tinfo.m_blocks
@@ -1853,6 +2246,9 @@ int
 console_main() {
   set_process_priority(-1);
 
+  if (json_output_enabled())
+    json_output_init();
+
   if (g_options.m_file_name.empty())
     mxerror(Y("No file name given.\n"));
 
@@ -23,5 +23,6 @@ options_c::options_c()
   , m_hex_positions{}
   , m_hexdump_max_size(16)
   , m_verbose(0)
+  , m_output_format{output_format_e::text}
 {
 }
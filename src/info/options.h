@@ -15,9 +15,15 @@
 
 class options_c {
 public:
+  enum class output_format_e {
+    text,
+    json,
+  };
+
   std::string m_file_name;
   bool m_use_gui, m_calc_checksums, m_show_summary, m_show_hexdump, m_show_size, m_show_track_info, m_hex_positions;
   int m_hexdump_max_size, m_verbose;
+  output_format_e m_output_format;
 public:
   options_c();
 };
@@ -2198,7 +2198,10 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
   }
 
   try {
-    KaxCluster *cluster = m_in_file->read_next_cluster();
+    // The frames handed over to the packetizers borrow their data from
+    // the cluster which is therefore kept alive until the last of them
+    // has been rendered.
+    auto cluster = std::shared_ptr<KaxCluster>{m_in_file->read_next_cluster()};
     if (!cluster) {
       flush_packetizers();
 
@@ -2206,7 +2209,7 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
       return FILE_STATUS_DONE;
     }
 
-    auto cluster_tc = FindChildValue<KaxClusterTimecode>(cluster);
+    auto cluster_tc = FindChildValue<KaxClusterTimecode>(cluster.get());
     cluster->InitTimecode(cluster_tc, m_tc_scale);
 
     if (-1 == m_first_timecode) {
@@ -2229,8 +2232,6 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
         process_block_group(cluster, static_cast<KaxBlockGroup *>(element));
     }
 
-    delete cluster;
-
   } catch (...) {
     mxwarn(boost::format("%1% %2% %3%\n")
            % (boost::format(Y("%1%: an unknown exception occurred.")) % "kax_reader_c::read()")
@@ -2243,7 +2244,7 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
 }
 
 void
-kax_reader_c::process_simple_block(KaxCluster *cluster,
+kax_reader_c::process_simple_block(std::shared_ptr<KaxCluster> const &cluster,
                                    KaxSimpleBlock *block_simple) {
   int64_t block_duration = -1;
   int64_t block_bref     = VFT_IFRAME;
@@ -2296,7 +2297,7 @@ kax_reader_c::process_simple_block(KaxCluster *cluster,
     size_t i;
     for (i = 0; block_simple->NumberFrames() > i; ++i) {
       DataBuffer &data_buffer = block_simple->GetBuffer(i);
-      memory_cptr data(new memory_c(data_buffer.Buffer(), data_buffer.Size(), false));
+      auto data               = memory_c::borrow(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
       packet_cptr packet(new packet_t(data, m_last_timecode + i * frame_duration, block_duration, block_bref, block_fref));
 
@@ -2307,7 +2308,7 @@ kax_reader_c::process_simple_block(KaxCluster *cluster,
     size_t i;
     for (i = 0; i < block_simple->NumberFrames(); i++) {
       DataBuffer &data_buffer = block_simple->GetBuffer(i);
-      memory_cptr data(new memory_c(data_buffer.Buffer(), data_buffer.Size(), false));
+      auto data               = memory_c::borrow(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
       if (('s' == block_track->type) && ('t' == block_track->sub_type)) {
@@ -2327,7 +2328,8 @@ kax_reader_c::process_simple_block(KaxCluster *cluster,
 }
 
 void
-kax_reader_c::process_block_group_common(KaxBlockGroup *block_group,
+kax_reader_c::process_block_group_common(std::shared_ptr<KaxCluster> const &cluster,
+                                         KaxBlockGroup *block_group,
                                          packet_t *packet,
                                          kax_track_t &block_track) {
   auto codec_state     = FindChild<KaxCodecState>(block_group);
@@ -2349,7 +2351,7 @@ kax_reader_c::process_block_group_common(KaxBlockGroup *block_group,
 
     auto blockmore     = static_cast<KaxBlockMore *>(child);
     auto blockadd_data = &GetChild<KaxBlockAdditional>(*blockmore);
-    auto blockadded    = std::make_shared<memory_c>(blockadd_data->GetBuffer(), blockadd_data->GetSize(), false);
+    auto blockadded    = memory_c::borrow(cluster, blockadd_data->GetBuffer(), blockadd_data->GetSize());
     block_track.content_decoder.reverse(blockadded, CONTENT_ENCODING_SCOPE_BLOCK);
 
     packet->data_adds.push_back(blockadded);
@@ -2357,7 +2359,7 @@ kax_reader_c::process_block_group_common(KaxBlockGroup *block_group,
 }
 
 void
-kax_reader_c::process_block_group(KaxCluster *cluster,
+kax_reader_c::process_block_group(std::shared_ptr<KaxCluster> const &cluster,
                                   KaxBlockGroup *block_group) {
   auto block = FindChild<KaxBlock>(block_group);
   if (!block)
@@ -2431,13 +2433,13 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
     size_t i;
     for (i = 0; i < block->NumberFrames(); i++) {
       auto &data_buffer = block->GetBuffer(i);
-      auto data         = std::make_shared<memory_c>(data_buffer.Buffer(), data_buffer.Size(), false);
+      auto data         = memory_c::borrow(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
       auto packet                = std::make_shared<packet_t>(data, m_last_timecode + i * frame_duration, block_duration, block_bref, block_fref);
       packet->duration_mandatory = duration;
 
-      process_block_group_common(block_group, packet.get(), *block_track);
+      process_block_group_common(cluster, block_group, packet.get(), *block_track);
 
       static_cast<passthrough_packetizer_c *>(PTZR(block_track->ptzr))->process(packet);
     }
@@ -2452,14 +2454,14 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
 
   for (auto block_idx = 0u, num_frames = block->NumberFrames(); block_idx < num_frames; ++block_idx) {
     auto &data_buffer = block->GetBuffer(block_idx);
-    auto data         = std::make_shared<memory_c>(data_buffer.Buffer(), data_buffer.Size(), false);
+    auto data         = memory_c::borrow(cluster, data_buffer.Buffer(), data_buffer.Size());
     block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
     if (('s' == block_track->type) && ('t' == block_track->sub_type)) {
       if ((2 < data->get_size()) || ((0 < data->get_size()) && (' ' != *data->get_buffer()) && (0 != *data->get_buffer()) && !iscr(*data->get_buffer()))) {
         auto packet = std::make_shared<packet_t>(data, m_last_timecode, block_duration, block_bref, block_fref);
 
-        process_block_group_common(block_group, packet.get(), *block_track);
+        process_block_group_common(cluster, block_group, packet.get(), *block_track);
 
         PTZR(block_track->ptzr)->process(packet);
       }
@@ -2470,7 +2472,7 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
       if ((duration) && !duration->GetValue())
         packet->duration_mandatory = true;
 
-      process_block_group_common(block_group, packet.get(), *block_track);
+      process_block_group_common(cluster, block_group, packet.get(), *block_track);
 
       PTZR(block_track->ptzr)->process(packet);
     }
@@ -326,9 +326,9 @@ protected:
   virtual void read_deferred_level1_elements(KaxSegment &segment);
   virtual void find_level1_elements_via_analyzer();
 
-  virtual void process_simple_block(KaxCluster *cluster, KaxSimpleBlock *block_simple);
-  virtual void process_block_group(KaxCluster *cluster, KaxBlockGroup *block_group);
-  virtual void process_block_group_common(KaxBlockGroup *block_group, packet_t *packet, kax_track_t &track);
+  virtual void process_simple_block(std::shared_ptr<KaxCluster> const &cluster, KaxSimpleBlock *block_simple);
+  virtual void process_block_group(std::shared_ptr<KaxCluster> const &cluster, KaxBlockGroup *block_group);
+  virtual void process_block_group_common(std::shared_ptr<KaxCluster> const &cluster, KaxBlockGroup *block_group, packet_t *packet, kax_track_t &track);
 
   void init_l1_position_storage(deferred_positions_t &storage);
   virtual bool has_deferred_element_been_processed(deferred_l1_type_e type, int64_t position);
@@ -59,6 +59,8 @@
 
 #define TS_PACKET_SIZE     188
 #define TS_MAX_PACKET_SIZE 204
+#define TS_NUM_PIDS        8192
+#define TS_PACKETS_PER_BATCH 1024
 
 #define TS_PAT_PID         0x0000
 #define TS_SDT_PID         0x0011
@@ -144,8 +146,7 @@ track_c::send_to_packetizer() {
              % pid % pes_payload_size_to_read % pes_payload_read->get_size() % timestamp_to_use % m_previous_timestamp);
 
   if (use_packet) {
-    auto bytes_to_skip = std::min<size_t>(pes_payload_read->get_size(), skip_packet_data_bytes);
-    process(std::make_shared<packet_t>(memory_c::clone(pes_payload_read->get_buffer() + bytes_to_skip, pes_payload_read->get_size() - bytes_to_skip), timestamp_to_use.to_ns(-1)));
+    process(std::make_shared<packet_t>(pes_payload_read->extract(skip_packet_data_bytes), timestamp_to_use.to_ns(-1)));
 
     f.m_packet_sent_to_packetizer = true;
   }
@@ -948,6 +949,8 @@ file_t::file_t(mm_io_cptr const &in)
   , m_validate_pat_crc{true}
   , m_validate_pmt_crc{true}
   , m_has_audio_or_video_track{}
+  , m_packet_batch_fill{}
+  , m_packet_batch_pos{}
 {
 }
 
@@ -967,6 +970,15 @@ file_t::reset_processing_state(processing_state_e new_state) {
   m_state = new_state;
   m_last_non_subtitle_pts.reset();
   m_last_non_subtitle_dts.reset();
+  m_pid_to_track.clear();
+  m_packet_batch_fill = 0;
+  m_packet_batch_pos  = 0;
+}
+
+int64_t
+file_t::get_current_packet_position()
+  const {
+  return m_in->getFilePointer() - (m_packet_batch_fill - m_packet_batch_pos) - m_detected_packet_size;
 }
 
 bool
@@ -1853,7 +1865,7 @@ reader_c::parse_pes(track_c &track) {
   }
 
   if (m_debug_packet) {
-    mxdebug(boost::format("parse_pes: PES info at file position %1% (file num %2%):\n") % (f.m_in->getFilePointer() - f.m_detected_packet_size) % track.m_file_num);
+    mxdebug(boost::format("parse_pes: PES info at file position %1% (file num %2%):\n") % f.get_current_packet_position() % track.m_file_num);
     mxdebug(boost::format("parse_pes:    stream_id = %1% PID = %2%\n") % static_cast<unsigned int>(pes_header->stream_id) % track.pid);
     mxdebug(boost::format("parse_pes:    PES_packet_length = %1%, PES_header_data_length = %2%, data starts at %3%\n") % pes_size % static_cast<unsigned int>(pes_header->pes_header_data_length) % to_skip);
     mxdebug(boost::format("parse_pes:    PTS? %1% (%5% processed %6%) DTS? (%7% processed %8%) %2% ESCR = %3% ES_rate = %4%\n")
@@ -2362,24 +2374,56 @@ reader_c::read(generic_packetizer_c *requested_ptzr,
 
   f.m_packet_sent_to_packetizer = false;
 
-  unsigned char buf[TS_MAX_PACKET_SIZE + 1];
+  if (f.m_pid_to_track.empty())
+    build_pid_to_track_table();
 
   while (!f.m_packet_sent_to_packetizer) {
-    if (f.m_in->read(buf, f.m_detected_packet_size) != static_cast<unsigned int>(f.m_detected_packet_size))
+    auto packet = read_next_packet_from_batch();
+    if (!packet)
       return finish();
 
-    if (buf[0] != 0x47) {
-      if (resync(f.m_in->getFilePointer() - f.m_detected_packet_size))
-        continue;
-      return finish();
-    }
-
-    parse_packet(buf);
+    parse_packet(packet);
   }
 
   return FILE_STATUS_MOREDATA;
 }
 
+unsigned char *
+reader_c::read_next_packet_from_batch() {
+  auto &f          = file();
+  auto packet_size = f.m_detected_packet_size;
+
+  while (true) {
+    if ((f.m_packet_batch_pos + packet_size) > f.m_packet_batch_fill) {
+      // A trailing partial packet is dropped, just like a short read
+      // of a single packet ends the file.
+      if (!f.m_packet_batch)
+        f.m_packet_batch = memory_c::alloc(TS_PACKETS_PER_BATCH * TS_MAX_PACKET_SIZE);
+
+      f.m_packet_batch_pos  = 0;
+      f.m_packet_batch_fill = 0;
+      f.m_packet_batch_fill = f.m_in->read(f.m_packet_batch->get_buffer(), TS_PACKETS_PER_BATCH * packet_size);
+
+      if (f.m_packet_batch_fill < packet_size)
+        return nullptr;
+    }
+
+    auto packet = f.m_packet_batch->get_buffer() + f.m_packet_batch_pos;
+
+    if (0x47 == packet[0]) {
+      f.m_packet_batch_pos += packet_size;
+      return packet;
+    }
+
+    auto packet_position  = f.m_in->getFilePointer() - (f.m_packet_batch_fill - f.m_packet_batch_pos);
+    f.m_packet_batch_pos  = 0;
+    f.m_packet_batch_fill = 0;
+
+    if (!resync(packet_position))
+      return nullptr;
+  }
+}
+
 bfs::path
 reader_c::find_file(bfs::path const &source_file,
                     std::string const &sub_directory,
@@ -2491,11 +2535,29 @@ reader_c::resync(int64_t start_at) {
   return false;
 }
 
+void
+reader_c::build_pid_to_track_table() {
+  // Neither the tracks nor their packetizers change anymore once
+  // muxing has started.
+  auto &f = file();
+  if (processing_state_e::muxing != f.m_state)
+    return;
+
+  auto table = std::vector<track_ptr>(TS_NUM_PIDS);
+  for (auto pid = 0u; pid < TS_NUM_PIDS; ++pid)
+    table[pid] = find_track_for_pid(pid);
+
+  f.m_pid_to_track = std::move(table);
+}
+
 track_ptr
 reader_c::find_track_for_pid(uint16_t pid)
   const {
   auto &f = *m_files[m_current_file];
 
+  if (!f.m_pid_to_track.empty())
+    return f.m_pid_to_track[pid & (TS_NUM_PIDS - 1)];
+
   for (auto const &track : m_tracks) {
     if (   (track->m_file_num != m_current_file)
         || (track->pid        != pid))
@@ -389,7 +389,13 @@ public:
 struct file_t {
   mm_io_cptr m_in;
 
-  std::unordered_map<uint16_t, track_ptr> m_pid_to_track_map;
+  // Direct lookup by PID (0..8191) while muxing. Built once the
+  // packetizers have been created; empty otherwise.
+  std::vector<track_ptr> m_pid_to_track;
+
+  // While muxing, packets are read from the file in large batches.
+  memory_cptr m_packet_batch;
+  std::size_t m_packet_batch_fill, m_packet_batch_pos;
   std::unordered_map<uint16_t, bool> m_ignored_pids, m_pmt_pid_seen;
   std::vector<generic_packetizer_c *> m_packetizers;
   std::vector<program_t> m_programs;
@@ -412,6 +418,7 @@ struct file_t {
   int64_t get_queued_bytes() const;
   void reset_processing_state(processing_state_e new_state);
   bool all_pmts_found() const;
+  int64_t get_current_packet_position() const;
 };
 using file_cptr = std::shared_ptr<file_t>;
 
@@ -456,6 +463,8 @@ private:
   void read_headers_for_file(std::size_t file_num);
 
   track_ptr find_track_for_pid(uint16_t pid) const;
+  void build_pid_to_track_table();
+  unsigned char *read_next_packet_from_batch();
   std::pair<unsigned char *, std::size_t> determine_ts_payload_start(packet_header_t *hdr) const;
   void setup_initial_tracks();
 
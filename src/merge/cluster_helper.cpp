@@ -17,6 +17,7 @@
 #include "common/ebml.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
 #include "common/translation.h"
@@ -378,6 +379,8 @@ cluster_helper_c::must_duration_be_set(render_groups_c *rg,
 
 int
 cluster_helper_c::render() {
+  mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::cluster_render};
+
   std::vector<render_groups_cptr> render_groups;
   kax_cues_with_cleanup_c cues;
   cues.SetGlobalTimecodeScale(g_timecode_scale);
@@ -554,6 +557,10 @@ cluster_helper_c::render() {
       m->cluster->Render(*m->out, cues);
       m->bytes_in_file += m->cluster->ElementSize();
 
+      // Hand each complete cluster over to the consumer right away.
+      if (g_live_output)
+        m->out->flush();
+
       if (g_kax_sh_cues)
         g_kax_sh_cues->IndexThis(*m->cluster, *g_kax_segment);
 
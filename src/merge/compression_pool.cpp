@@ -0,0 +1,94 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   the packet compression worker pool
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/compression_pool.h"
+
+compression_pool_c::compression_pool_c(unsigned int num_threads)
+  : m_stopping{}
+{
+  for (auto idx = 0u; idx < std::max(num_threads, 1u); ++idx)
+    m_workers.emplace_back([this]() { run_worker(); });
+}
+
+compression_pool_c::~compression_pool_c() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stopping = true;
+  }
+
+  m_jobs_available.notify_all();
+
+  for (auto &worker : m_workers)
+    worker.join();
+}
+
+std::future<compression_pool_c::result_t>
+compression_pool_c::compress(compression_method_e method,
+                             std::vector<memory_cptr> const &buffers) {
+  auto job    = job_t{ method, buffers, std::promise<result_t>{} };
+  auto result = job.m_promise.get_future();
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_jobs.emplace_back(std::move(job));
+  }
+
+  m_jobs_available.notify_one();
+
+  return result;
+}
+
+void
+compression_pool_c::run_worker() {
+  // Declared first so that the messages the compressors emit when
+  // they're destroyed are captured, too. They're dropped as there's
+  // no job left to return them with.
+  mtx::output::worker_messages_c worker_messages{true};
+  std::map<compression_method_e, compressor_ptr> compressors;
+
+  while (true) {
+    job_t job;
+
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_jobs_available.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+      // Jobs still queued when the pool is destroyed aren't needed
+      // anymore.
+      if (m_stopping)
+        return;
+
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+
+    try {
+      auto &compressor = compressors[job.m_method];
+      if (!compressor)
+        compressor = compressor_c::create(job.m_method);
+
+      auto result = result_t{};
+      for (auto const &buffer : job.m_buffers)
+        result.m_buffers.emplace_back(compressor->compress(buffer));
+
+      result.m_messages = worker_messages.take_messages();
+      job.m_promise.set_value(result);
+
+    } catch (...) {
+      worker_messages.take_messages();
+      job.m_promise.set_exception(std::current_exception());
+    }
+  }
+}
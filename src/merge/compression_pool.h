@@ -0,0 +1,72 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for the packet compression worker pool
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_COMPRESSION_POOL_H
+#define MTX_MERGE_COMPRESSION_POOL_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "common/compression.h"
+
+// Compresses buffers on worker threads. Each worker creates
+// compressors of its own as compressors such as zlib's keep their
+// stream state between calls. Only methods without per-track
+// configuration may be used, e.g. zlib but not header removal.
+//
+// The caller keeps the futures in the order in which it needs the
+// results; the pool itself doesn't guarantee any order of completion.
+//
+// The compressors' messages aren't output on the worker threads but
+// returned along with the result. Their errors are thrown as
+// mtx::output::error_x by the future's get().
+class compression_pool_c {
+public:
+  struct result_t {
+    std::vector<memory_cptr> m_buffers;
+    std::vector<mtx::output::message_t> m_messages;
+  };
+
+protected:
+  struct job_t {
+    compression_method_e m_method{COMPRESSION_UNSPECIFIED};
+    std::vector<memory_cptr> m_buffers;
+    std::promise<result_t> m_promise;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_jobs_available;
+  std::deque<job_t> m_jobs;
+  std::vector<std::thread> m_workers;
+  bool m_stopping;
+
+public:
+  explicit compression_pool_c(unsigned int num_threads);
+  ~compression_pool_c();
+
+  // The result contains the compressed buffers in the same order as
+  // 'buffers'. Compression errors are rethrown by the future's get().
+  // The messages must be output by the caller, e.g. with
+  // mtx::output::replay().
+  std::future<result_t> compress(compression_method_e method, std::vector<memory_cptr> const &buffers);
+
+protected:
+  void run_worker();
+};
+
+#endif  // MTX_MERGE_COMPRESSION_POOL_H
@@ -18,6 +18,7 @@
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/profiling.h"
 #include "merge/cluster_helper.h"
 #include "merge/cues.h"
 #include "merge/generic_packetizer.h"
@@ -78,6 +79,8 @@ cues_c::write(mm_io_c &out,
   if (!m_points.size() || !g_cue_writing_requested)
     return;
 
+  mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::cues_write};
+
   // auto start = mtx::sys::get_current_time_millis();
   sort();
   // auto end_sort = mtx::sys::get_current_time_millis();
@@ -86,14 +89,17 @@ cues_c::write(mm_io_c &out,
   // be set for indexing in g_kax_sh_main. Necessary because there's
   // no API function to force the position to a certain value; nor is
   // there a different API function in KaxSeekHead for adding anything
-  // by ID and position manually.
-  out.save_pos();
-  kax_cues_position_dummy_c cues_dummy;
-  cues_dummy.Render(out);
-  out.restore_pos();
-
-  // Write meta seek information if it is not disabled.
-  seek_head.IndexThis(cues_dummy, *g_kax_segment);
+  // by ID and position manually. In live mode there's no meta seek
+  // element, and the output cannot seek back either.
+  if (!g_live_output) {
+    out.save_pos();
+    kax_cues_position_dummy_c cues_dummy;
+    cues_dummy.Render(out);
+    out.restore_pos();
+
+    // Write meta seek information if it is not disabled.
+    seek_head.IndexThis(cues_dummy, *g_kax_segment);
+  }
 
   // Forcefully write the correct head and copy its content from the
   // temporary storage location.
@@ -18,6 +18,7 @@
 
 #include "common/file_types.h"
 #include "common/mm_mpls_multi_file_io_fwd.h"
+#include "common/mm_sequential_read_io.h"
 #include "merge/output_control.h"
 
 class generic_reader_c;
@@ -52,6 +53,10 @@ struct filelist_t {
   size_t playlist_index{}, playlist_previous_filelist_id{};
   mm_mpls_multi_file_io_cptr playlist_mpls_in;
 
+  // Sources that cannot seek can only be opened once. Probing and the
+  // reader share this instance.
+  std::shared_ptr<mm_sequential_read_io_c> sequential_in;
+
   timestamp_c restricted_timecode_min, restricted_timecode_max;
 
   filelist_t()
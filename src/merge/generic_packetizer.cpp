@@ -28,10 +28,12 @@
 #include "common/container.h"
 #include "common/ebml.h"
 #include "common/hacks.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "common/unique_numbers.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "merge/cluster_helper.h"
+#include "merge/compression_pool.h"
 #include "merge/filelist.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
@@ -62,6 +64,7 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
   , m_free_refs{-1}
   , m_next_free_refs{-1}
   , m_enqueued_bytes{}
+  , m_num_bytes_copied{}
   , m_safety_last_timecode{}
   , m_safety_last_duration{}
   , m_track_entry{}
@@ -354,6 +357,9 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
 }
 
 generic_packetizer_c::~generic_packetizer_c() {
+  static debugging_option_c s_debug{"packet_copies"};
+
+  mxdebug_if(s_debug, boost::format("packet_copies: '%1%' track %2%: %3% packets, %4% bytes copied\n") % m_ti.m_fname % m_ti.m_id % m_num_packets % m_num_bytes_copied);
 }
 
 void
@@ -1254,12 +1260,29 @@ generic_packetizer_c::fix_headers() {
   m_track_entry->SetGlobalTimecodeScale((int64_t)g_timecode_scale);
 }
 
+static compression_pool_c &
+compression_pool() {
+  static compression_pool_c s_pool{static_cast<unsigned int>(std::max(g_num_threads - 1, 1))};
+  return s_pool;
+}
+
 void
 generic_packetizer_c::compress_packet(packet_t &packet) {
   if (!m_compressor) {
     return;
   }
 
+  // zlib compression is expensive but doesn't depend on the track, so
+  // it's done on worker threads if more than one thread may be used.
+  // The packet stays in the queue; get_packet() waits for the result.
+  if ((1 < g_num_threads) && (COMPRESSION_ZLIB == m_compressor->get_method())) {
+    auto buffers = std::vector<memory_cptr>{ packet.data };
+    brng::copy(packet.data_adds, std::back_inserter(buffers));
+
+    packet.pending_compression = compression_pool().compress(COMPRESSION_ZLIB, buffers);
+    return;
+  }
+
   try {
     packet.data = m_compressor->compress(packet.data);
     size_t i;
@@ -1271,6 +1294,28 @@ generic_packetizer_c::compress_packet(packet_t &packet) {
   }
 }
 
+void
+generic_packetizer_c::finish_compression(packet_t &packet) {
+  if (!packet.pending_compression.valid())
+    return;
+
+  try {
+    auto result = packet.pending_compression.get();
+
+    mtx::output::replay(result.m_messages);
+
+    packet.data = result.m_buffers[0];
+    for (auto idx = 0u; packet.data_adds.size() > idx; ++idx)
+      packet.data_adds[idx] = result.m_buffers[idx + 1];
+
+  } catch (mtx::compression_x &e) {
+    mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Compression failed: %1%\n")) % e.error());
+
+  } catch (mtx::output::error_x &e) {
+    mxerror(e.what());
+  }
+}
+
 void
 generic_packetizer_c::account_enqueued_bytes(packet_t &packet,
                                              int64_t factor) {
@@ -1292,9 +1337,9 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
       && (pack->data_adds.size()  > static_cast<size_t>(m_htrack_max_add_block_ids)))
     pack->data_adds.resize(m_htrack_max_add_block_ids);
 
-  pack->data->grab();
+  grab_packet_data(pack->data);
   for (auto &data_add : pack->data_adds)
-    data_add->grab();
+    grab_packet_data(data_add);
 
   pack->source = this;
 
@@ -1309,6 +1354,15 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
     m_deferred_packets.push_back(pack);
 }
 
+void
+generic_packetizer_c::grab_packet_data(memory_cptr &data) {
+  if (!data || data->keeps_buffer_alive())
+    return;
+
+  m_num_bytes_copied += data->get_size();
+  data->grab();
+}
+
 #define ADJUST_TIMECODE(x) (int64_t)((x + m_correction_timecode_offset + m_append_timecode_offset) * m_ti.m_tcsync.numerator / m_ti.m_tcsync.denominator) + m_ti.m_tcsync.displacement
 
 void
@@ -1365,10 +1419,15 @@ generic_packetizer_c::add_packet2(packet_cptr pack) {
   pack->timecode_before_factory = pack->timecode;
 
   m_packet_queue.push_back(pack);
-  if (!m_timestamp_factory || (TFA_IMMEDIATE == m_timestamp_factory_application_mode))
-    apply_factory_once(pack);
-  else
-    apply_factory();
+
+  {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::apply_factory, get_track_num()};
+
+    if (!m_timestamp_factory || (TFA_IMMEDIATE == m_timestamp_factory_application_mode))
+      apply_factory_once(pack);
+    else
+      apply_factory();
+  }
 
   after_packet_timestamped(*pack);
 
@@ -1390,6 +1449,8 @@ generic_packetizer_c::get_packet() {
   packet_cptr pack = m_packet_queue.front();
   m_packet_queue.pop_front();
 
+  finish_compression(*pack);
+
   pack->output_order_timecode = timestamp_c::ns(pack->assigned_timecode - std::max(m_codec_delay.to_ns(0), m_seek_pre_roll.to_ns(0)));
 
   account_enqueued_bytes(*pack, -1);
@@ -1591,9 +1652,14 @@ generic_packetizer_c::contains_gap() {
 
 void
 generic_packetizer_c::flush() {
-  flush_impl();
+  {
+    mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::packetizer_process, get_track_num()};
+    flush_impl();
+  }
 
   m_has_been_flushed = true;
+
+  mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::apply_factory, get_track_num()};
   apply_factory();
 }
 
@@ -1672,9 +1738,16 @@ generic_packetizer_c::create_track_number() {
 
 file_status_e
 generic_packetizer_c::read(bool force) {
+  mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::reader_read, get_track_num()};
   return m_reader->read(this, force);
 }
 
+int
+generic_packetizer_c::process(packet_cptr packet) {
+  mtx::profiling::scoped_timer_c timer{mtx::profiling::stage_e::packetizer_process, get_track_num()};
+  return process_impl(packet);
+}
+
 void
 generic_packetizer_c::prevent_lacing() {
   m_prevent_lacing = true;
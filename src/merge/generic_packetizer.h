@@ -50,7 +50,7 @@ protected:
   std::deque<packet_cptr> m_packet_queue, m_deferred_packets;
   int m_next_packet_wo_assigned_timecode;
 
-  int64_t m_free_refs, m_next_free_refs, m_enqueued_bytes;
+  int64_t m_free_refs, m_next_free_refs, m_enqueued_bytes, m_num_bytes_copied;
   int64_t m_safety_last_timecode, m_safety_last_duration;
 
   KaxTrackEntry *m_track_entry;
@@ -111,6 +111,7 @@ public:
   }
   virtual void add_packet(packet_cptr packet);
   virtual void add_packet2(packet_cptr pack);
+  void grab_packet_data(memory_cptr &data);
   virtual void process_deferred_packets();
 
   virtual packet_cptr get_packet();
@@ -125,6 +126,11 @@ public:
   inline int64_t get_queued_bytes() const {
     return m_enqueued_bytes;
   }
+  // Number of bytes of packet payloads that had to be copied because
+  // the reader didn't hand over buffers that stay valid.
+  inline int64_t get_num_bytes_copied() const {
+    return m_num_bytes_copied;
+  }
 
   inline void set_free_refs(int64_t free_refs) {
     m_free_refs      = m_next_free_refs;
@@ -135,10 +141,18 @@ public:
   }
   virtual void set_headers();
   virtual void fix_headers();
+  // Number of bytes by which this track's header is expected to grow
+  // after it has been written for the first time, e.g. because the
+  // codec private data is only known once the first frames have been
+  // parsed.
+  virtual int64_t get_expected_header_growth() const {
+    return 0;
+  }
   inline int process(packet_t *packet) {
     return process(packet_cptr(packet));
   }
-  virtual int process(packet_cptr packet) = 0;
+  int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet) = 0;
 
   virtual void set_cue_creation(cue_strategy_e create_cue_data) {
     m_ti.m_cues = create_cue_data;
@@ -287,6 +301,7 @@ protected:
   virtual void show_experimental_status_version(std::string const &codec_id);
 
   virtual void compress_packet(packet_t &packet);
+  void finish_compression(packet_t &packet);
   virtual void account_enqueued_bytes(packet_t &packet, int64_t factor);
 };
 
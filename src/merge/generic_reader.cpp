@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include "common/list_utils.h"
+#include "common/mm_sequential_read_io.h"
 #include "common/strings/formatting.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
@@ -435,6 +436,11 @@ generic_reader_c::display_identification_results_as_text() {
 
 void
 generic_reader_c::display_identification_results_as_json() {
+  display_json_output(get_identification_results_as_json());
+}
+
+nlohmann::json
+generic_reader_c::get_identification_results_as_json() {
   auto verbose_info_to_object = [](mtx::id::verbose_info_t const &verbose_info) -> nlohmann::json {
     auto object = nlohmann::json{};
     for (auto const &property : verbose_info)
@@ -494,7 +500,7 @@ generic_reader_c::display_identification_results_as_json() {
       };
   }
 
-  display_json_output(json);
+  return json;
 }
 
 std::string
@@ -540,6 +546,11 @@ generic_reader_c::set_probe_range_percentage(int64_rational_c const &probe_range
   s_probe_range_percentage = probe_range_percentage;
 }
 
+int64_rational_c const &
+generic_reader_c::get_probe_range_percentage() {
+  return s_probe_range_percentage;
+}
+
 int64_t
 generic_reader_c::calculate_probe_range(int64_t file_size,
                                         int64_t fixed_minimum)
@@ -550,6 +561,12 @@ generic_reader_c::calculate_probe_range(int64_t file_size,
   auto probe_range = boost::rational_cast<int64_t>(factor * file_size);
   auto to_use      = std::max(fixed_minimum, probe_range);
 
+  // Sources that cannot seek only allow going back to the start from
+  // within their window.
+  auto sequential_in = dynamic_cast<mm_sequential_read_io_c *>(m_in.get());
+  if (sequential_in)
+    to_use = std::min<int64_t>(to_use, sequential_in->get_window_size() / 2);
+
   mxdebug_if(s_debug,
              boost::format("calculate_probe_range: calculated %1% based on file size %2% fixed minimum %3% percentage %4%/%5% percentage of size %6%\n")
              % to_use % file_size % fixed_minimum % s_probe_range_percentage.numerator() % s_probe_range_percentage.denominator() % probe_range);
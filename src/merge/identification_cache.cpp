@@ -0,0 +1,166 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   cache for identification results
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#if !defined(SYS_WINDOWS)
+# include <sys/stat.h>
+# include <sys/types.h>
+#endif
+
+#include "common/checksums/base.h"
+#include "common/mm_io_x.h"
+#include "common/strings/formatting.h"
+#include "common/version.h"
+#include "merge/identification_cache.h"
+
+static debugging_option_c s_debug{"identification_cache"};
+
+identification_cache_c::identification_cache_c(bfs::path const &directory)
+  : m_directory{directory}
+{
+}
+
+boost::optional<nlohmann::json>
+identification_cache_c::build_key(std::string const &file_name,
+                                  nlohmann::json const &options)
+  const {
+  auto path = bfs::system_complete(bfs::path{file_name});
+  auto ec   = boost::system::error_code{};
+
+  if (!bfs::is_regular_file(path, ec) || ec)
+    return boost::none;
+
+  auto size = bfs::file_size(path, ec);
+  if (ec)
+    return boost::none;
+
+  auto modification_time = bfs::last_write_time(path, ec);
+  if (ec)
+    return boost::none;
+
+  auto key = nlohmann::json{
+    { "file_name",         path.string()                                                                },
+    { "size",              size                                                                         },
+    { "modification_time", static_cast<int64_t>(modification_time)                                      },
+    { "version",           get_version_info("mkvmerge", static_cast<version_info_flags_e>(vif_full | vif_untranslated)) },
+    { "options",           options                                                                      },
+  };
+
+#if !defined(SYS_WINDOWS)
+  // Sub-second modification times and the inode number catch files
+  // that have been replaced or rewritten in place quickly.
+  struct stat st;
+  if (0 != ::stat(g_cc_local_utf8->native(path.string()).c_str(), &st))
+    return boost::none;
+
+# if defined(SYS_APPLE)
+  key["modification_time_ns"] = static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+# else
+  key["modification_time_ns"] = static_cast<int64_t>(st.st_mtim.tv_nsec);
+# endif
+  key["device"]               = static_cast<uint64_t>(st.st_dev);
+  key["inode"]                = static_cast<uint64_t>(st.st_ino);
+#endif
+
+  return key;
+}
+
+bfs::path
+identification_cache_c::entry_path(nlohmann::json const &key)
+  const {
+  auto serialized = mtx::json::dump(key);
+  auto hash       = mtx::checksum::calculate(mtx::checksum::algorithm_e::md5, serialized.c_str(), serialized.size());
+
+  return m_directory / (to_hex(hash, true) + ".json");
+}
+
+boost::optional<nlohmann::json>
+identification_cache_c::fetch(std::string const &file_name,
+                              nlohmann::json const &options)
+  const {
+  auto key = build_key(file_name, options);
+  if (!key)
+    return boost::none;
+
+  auto path = entry_path(*key);
+
+  try {
+    auto ec = boost::system::error_code{};
+    if (!bfs::exists(path, ec) || ec) {
+      mxdebug_if(s_debug, boost::format("fetch: no entry for %1% in %2%\n") % file_name % path.string());
+      return boost::none;
+    }
+
+    auto content = mm_file_io_c::slurp(path.string());
+    auto entry   = mtx::json::parse(std::string{reinterpret_cast<char const *>(content->get_buffer()), content->get_size()});
+
+    // Guard against hash collisions and entries from other programs.
+    if ((entry["key"] != *key) || !entry["identification"].is_object()) {
+      mxdebug_if(s_debug, boost::format("fetch: key mismatch for %1% in %2%\n") % file_name % path.string());
+      return boost::none;
+    }
+
+    mxdebug_if(s_debug, boost::format("fetch: using entry for %1% from %2%\n") % file_name % path.string());
+
+    return entry["identification"];
+
+  } catch (std::exception &ex) {
+    mxdebug_if(s_debug, boost::format("fetch: reading %1% failed: %2%\n") % path.string() % ex.what());
+  }
+
+  return boost::none;
+}
+
+void
+identification_cache_c::store(std::string const &file_name,
+                              nlohmann::json const &options,
+                              nlohmann::json const &identification)
+  const {
+  auto key = build_key(file_name, options);
+  if (!key)
+    return;
+
+  auto path      = entry_path(*key);
+  auto temp_path = m_directory / bfs::unique_path("%%%%-%%%%-%%%%-%%%%.tmp");
+  auto ec        = boost::system::error_code{};
+
+  try {
+    bfs::create_directories(m_directory, ec);
+
+    auto content = mtx::json::dump(nlohmann::json{
+      { "key",            *key           },
+      { "identification", identification },
+    });
+
+    {
+      mm_file_io_c out{temp_path.string(), MODE_CREATE};
+      out.write(content.c_str(), content.size());
+    }
+
+    // Readers either see the old entry, no entry or the complete new
+    // one, but never a partially written file.
+    bfs::rename(temp_path, path, ec);
+    if (!ec) {
+      mxdebug_if(s_debug, boost::format("store: stored entry for %1% in %2%\n") % file_name % path.string());
+      return;
+    }
+
+    mxdebug_if(s_debug, boost::format("store: renaming %1% to %2% failed: %3%\n") % temp_path.string() % path.string() % ec.message());
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxdebug_if(s_debug, boost::format("store: writing %1% failed: %2%\n") % temp_path.string() % ex);
+  }
+
+  bfs::remove(temp_path, ec);
+}
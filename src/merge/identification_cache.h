@@ -0,0 +1,45 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   cache for identification results
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_IDENTIFICATION_CACHE_H
+#define MTX_MERGE_IDENTIFICATION_CACHE_H
+
+#include "common/common_pch.h"
+
+#include "common/json.h"
+
+// Stores the JSON identification results of source files in a
+// directory so that identifying an unchanged file again doesn't
+// require running the readers.
+//
+// An entry is only used if the file's path, size, modification time,
+// device & inode number, the mkvmerge version and the options that
+// influence identification are the same. Each entry is a file of its
+// own that is written to a temporary file first and then renamed.
+// Several mkvmerge processes can therefore share one cache directory.
+class identification_cache_c {
+protected:
+  bfs::path m_directory;
+
+public:
+  identification_cache_c(bfs::path const &directory);
+
+  boost::optional<nlohmann::json> fetch(std::string const &file_name, nlohmann::json const &options) const;
+  void store(std::string const &file_name, nlohmann::json const &options, nlohmann::json const &identification) const;
+
+protected:
+  boost::optional<nlohmann::json> build_key(std::string const &file_name, nlohmann::json const &options) const;
+  bfs::path entry_path(nlohmann::json const &key) const;
+};
+
+#endif  // MTX_MERGE_IDENTIFICATION_CACHE_H
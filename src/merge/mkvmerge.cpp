@@ -46,11 +46,14 @@
 #include "common/extern_data.h"
 #include "common/file_types.h"
 #include "common/fs_sys_helpers.h"
+#include "common/hacks.h"
 #include "common/iso639.h"
 #include "common/kax_analyzer.h"
 #include "common/list_utils.h"
 #include "common/mm_io.h"
 #include "common/mm_mpls_multi_file_io.h"
+#include "common/mm_multi_file_io.h"
+#include "common/profiling.h"
 #include "common/segmentinfo.h"
 #include "common/split_arg_parsing.h"
 #include "common/strings/formatting.h"
@@ -63,6 +66,7 @@
 #include "merge/cluster_helper.h"
 #include "merge/filelist.h"
 #include "merge/generic_reader.h"
+#include "merge/identification_cache.h"
 #include "merge/output_control.h"
 #include "merge/reader_detection_and_creation.h"
 #include "merge/track_info.h"
@@ -117,6 +121,9 @@ set_usage() {
                   "                           put at most n milliseconds of data into each\n"
                   "                           cluster.\n");
   usage_text += Y("  --no-cues                Do not write the cue data (the index).\n");
+  usage_text += Y("  --live                   Write the destination file strictly sequentially\n"
+                  "                           so that it can be a pipe. Use '-' as the file\n"
+                  "                           name for the standard output.\n");
   usage_text += Y("  --clusters-in-meta-seek  Write meta seek data for clusters.\n");
   usage_text += Y("  --no-date                Do not write the 'date' field in the segment\n"
                   "                           information headers.\n");
@@ -125,6 +132,15 @@ set_usage() {
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
   usage_text += Y("  --disable-track-statistics-tags\n"
                   "                           Do not write tags with track statistics.\n");
+  usage_text += Y("  --threads <n>            Use up to n threads. With more than one thread\n"
+                  "                           the source files are read ahead and the\n"
+                  "                           destination file is written on background\n"
+                  "                           threads. zlib compression is done on worker\n"
+                  "                           threads, too. Demultiplexing and packetizing\n"
+                  "                           stay on the main thread.\n");
+  usage_text += Y("  --profile <format>       Measure the time spent in the main stages for\n"
+                  "                           each track and output a report in the given\n"
+                  "                           format ('text' or 'json') at the end.\n");
   usage_text +=   "\n";
   usage_text += Y(" File splitting, linking, appending and concatenating (more global options):\n");
   usage_text += Y("  --split <d[K,M,G]|HH:MM:SS|s>\n"
@@ -337,6 +353,9 @@ set_usage() {
   usage_text += Y("  -F, --identification-format <format>\n"
                   "                           Set the identification results format\n"
                   "                           ('text', 'verbose-text', 'json').\n");
+  usage_text += Y("  --identification-cache <directory>\n"
+                  "                           Store JSON identification results in this\n"
+                  "                           directory and re-use them for unchanged files.\n");
   usage_text += Y("  --probe-range-percentage <percent>\n"
                   "                           Sets maximum size to probe for tracks in percent\n"
                   "                           of the total file size for certain file types\n"
@@ -457,11 +476,17 @@ display_unsupported_file_type(filelist_t const &file) {
   mxerror(boost::format(Y("The type of file '%1%' is not supported.\n")) % file.name);
 }
 
+static std::unique_ptr<identification_cache_c> s_identification_cache;
+static bool s_profiling_report_as_json = false;
+
 /** \brief Identify a file type and its contents
 
    This function called for \c --identify. It sets up dummy track info
    data for the reader, probes the input file, creates the file reader
    and calls its identify function.
+
+   If \c --identification-cache is used, the results are looked up in
+   and stored in that cache.
 */
 static void
 identify(std::string &filename) {
@@ -481,6 +506,26 @@ identify(std::string &filename) {
   file.name           = filename;
   file.all_names.push_back(filename);
 
+  // Everything besides the file itself that can change the result.
+  auto const &probe_range = generic_reader_c::get_probe_range_percentage();
+  auto cache_options      = nlohmann::json{
+    { "disable_multi_file",     file.ti->m_disable_multi_file                                                   },
+    { "probe_range_percentage", (boost::format("%1%/%2%") % probe_range.numerator() % probe_range.denominator()).str() },
+    { "ui_locale",              translation_c::get_active_translation().get_locale()                            },
+  };
+
+  if (s_identification_cache) {
+    auto cached = s_identification_cache->fetch(filename, cache_options);
+    if (cached) {
+      // The same file may have been identified under a different name,
+      // e.g. a relative one.
+      (*cached)["file_name"] = filename;
+      mxinfo(boost::format("%1%\n") % mtx::json::dump(*cached, 2));
+      g_files.clear();
+      return;
+    }
+  }
+
   get_file_type(file);
 
   if (FILE_TYPE_IS_UNKNOWN == file.type)
@@ -489,7 +534,27 @@ identify(std::string &filename) {
   create_readers();
 
   file.reader->identify();
-  file.reader->display_identification_results();
+
+  if (s_identification_cache) {
+    auto json = add_warnings_and_errors_to_json(file.reader->get_identification_results_as_json());
+
+    // The cache key only covers the file itself. Results that depend
+    // on other files (playlists, multi-file sequences) could therefore
+    // become stale unnoticed. Warnings are usually about the current
+    // circumstances and must not be reported again as if they had just
+    // been emitted.
+    auto cacheable = !file.is_playlist
+                  && !std::dynamic_pointer_cast<mm_multi_file_io_c>(file.reader->m_in)
+                  && json["warnings"].empty()
+                  && json["errors"].empty();
+
+    if (cacheable)
+      s_identification_cache->store(filename, cache_options, json);
+
+    mxinfo(boost::format("%1%\n") % mtx::json::dump(json, 2));
+
+  } else
+    file.reader->display_identification_results();
 
   g_files.clear();
 }
@@ -2141,6 +2206,31 @@ parse_arg_probe_range(boost::optional<std::string> next_arg) {
   generic_reader_c::set_probe_range_percentage(probe_range_percentage);
 }
 
+static void
+parse_arg_threads(boost::optional<std::string> next_arg) {
+  if (!next_arg)
+    mxerror(Y("'--threads' lacks the number of threads.\n"));
+
+  if (!parse_number(*next_arg, g_num_threads) || (1 > g_num_threads))
+    mxerror(boost::format(Y("Invalid number of threads in '--threads %1%'.\n")) % *next_arg);
+}
+
+static void
+parse_arg_profile(std::string const &format) {
+  auto next_arg = balg::to_lower_copy(format);
+
+  if (next_arg == "text")
+    s_profiling_report_as_json = false;
+
+  else if (next_arg == "json")
+    s_profiling_report_as_json = true;
+
+  else
+    mxerror(boost::format(Y("Invalid profiling report format in '--profile %1%'.\n")) % format);
+
+  mtx::profiling::enable(true);
+}
+
 static void
 handle_identification_args(std::vector<std::string> &args) {
   auto identification_command = boost::optional<std::string>{};
@@ -2158,6 +2248,10 @@ handle_identification_args(std::vector<std::string> &args) {
       parse_arg_probe_range(next_arg);
       args.erase(this_arg_itr, next_arg_itr + 1);
 
+    } else if (*this_arg_itr == "--threads") {
+      parse_arg_threads(next_arg);
+      args.erase(this_arg_itr, next_arg_itr + 1);
+
     } else
       ++this_arg_itr;
   }
@@ -2192,6 +2286,14 @@ handle_identification_args(std::vector<std::string> &args) {
     if (mtx::included_in(this_arg, "-F", "--identification-format"))
       parse_arg_identification_format(sit, sit_end);
 
+    else if (this_arg == "--identification-cache") {
+      if ((sit + 1) == sit_end)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      s_identification_cache = std::make_unique<identification_cache_c>(bfs::system_complete(bfs::path{*(sit + 1)}));
+      ++sit;
+    }
+
     else if (file_to_identify)
       mxerror(boost::format(Y("The argument '%1%' is not allowed in identification mode.\n")) % this_arg);
 
@@ -2202,6 +2304,9 @@ handle_identification_args(std::vector<std::string> &args) {
   if (!file_to_identify)
     mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % *identification_command);
 
+  if (s_identification_cache && (identification_output_format_e::json != g_identification_output_format))
+    mxerror(Y("'--identification-cache' can only be used together with the JSON identification format.\n"));
+
   identify(*file_to_identify);
   mxexit();
 }
@@ -2235,6 +2340,12 @@ parse_args(std::vector<std::string> args) {
 
   }
 
+  // Keep messages out of the destination data if that is written to
+  // the standard output.
+  for (auto idx = 1u; idx < args.size(); ++idx)
+    if (mtx::included_in(args[idx - 1], "-o", "--output") && (args[idx] == "-"))
+      redirect_stdio(std::make_shared<mm_stdio_c>(stderr));
+
   mxinfo(boost::format("%1%\n") % get_version_info("mkvmerge", vif_full));
 
   // Now parse options that are needed right at the beginning.
@@ -2364,6 +2475,9 @@ parse_args(std::vector<std::string> args) {
     } else if (this_arg == "--no-cues")
       g_write_cues = false;
 
+    else if (this_arg == "--live")
+      g_live_output = true;
+
     else if (this_arg == "--no-date")
       g_write_date = false;
 
@@ -2379,6 +2493,14 @@ parse_args(std::vector<std::string> args) {
     else if (this_arg == "--disable-track-statistics-tags")
       g_no_track_statistics_tags = true;
 
+    else if (this_arg == "--profile") {
+      if (no_next_arg)
+        mxerror(Y("'--profile' lacks the format.\n"));
+
+      parse_arg_profile(next_arg);
+      sit++;
+    }
+
     else if (this_arg == "--attachment-description") {
       if (no_next_arg)
         mxerror(Y("'--attachment-description' lacks the description.\n"));
@@ -2903,6 +3025,12 @@ parse_args(std::vector<std::string> args) {
   if (!g_cluster_helper->splitting() && !g_no_linking)
     mxwarn(Y("'--link' is only useful in combination with '--split'.\n"));
 
+  if ((g_outfile == "-") && !g_live_output)
+    mxerror(Y("Writing to the standard output is only supported in live mode ('--live').\n"));
+
+  if (g_live_output && (g_cluster_helper->splitting() || !g_splitting_by_chapters_arg.empty()))
+    mxerror(Y("'--live' cannot be used together with '--split'.\n"));
+
   if (!inputs_found && g_files.empty())
     mxerror(Y("No source files were given.\n"));
 }
@@ -3080,6 +3208,8 @@ main(int argc,
 
   parse_args(args);
 
+  mtx::mem::pool::enable(hack_engaged(ENGAGE_MEMORY_POOLS));
+
   int64_t start = mtx::sys::get_current_time_millis();
 
   add_filelists_for_playlists();
@@ -3119,5 +3249,10 @@ main(int argc,
 
   cleanup();
 
+  if (mtx::profiling::is_enabled())
+    mtx::profiling::display_report(s_profiling_report_as_json);
+
+  mtx::mem::pool::dump_statistics();
+
   mxexit();
 }
@@ -56,6 +56,7 @@
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
 #include "common/mm_io_x.h"
+#include "common/mm_sequential_write_io.h"
 #include "common/mm_write_buffer_io.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
@@ -68,6 +69,8 @@
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
 #include "merge/output_control.h"
+#include "merge/packetizer_queue.h"
+#include "merge/track_headers_space.h"
 #include "merge/webm.h"
 
 using namespace libmatroska;
@@ -110,6 +113,8 @@ bool g_no_linking                           = true;
 bool g_use_durations                        = false;
 bool g_no_track_statistics_tags             = false;
 bool g_write_date                           = true;
+bool g_live_output                          = false;
+int g_num_threads                           = 1;
 
 double g_timecode_scale                     = TIMECODE_SCALE;
 timecode_scale_mode_e g_timecode_scale_mode = TIMECODE_SCALE_MODE_NORMAL;
@@ -187,6 +192,12 @@ static std::unique_ptr<EbmlHead> s_head;
 static std::string s_muxing_app, s_writing_app;
 static boost::posix_time::ptime s_writing_date;
 
+// Packetizers holding a packet, ordered by the packet's output order
+// timestamp, and packetizers that have to be pulled for a new packet
+// or have to re-evaluate their status during the next pass.
+static packetizer_queue_c s_packetizer_queue;
+static std::set<std::size_t> s_idle_packetizers;
+
 static auto s_required_matroska_version      = 1u;
 static auto s_required_matroska_read_version = 1u;
 
@@ -241,29 +252,32 @@ sighandler(int /* signum */) {
     cues_c::get().write(*s_out, *g_kax_sh_main);
   mxinfo(Y(" done\n"));
 
-  mxinfo(Y("The file is being fixed, part 2/4..."));
-  // Now re-render the kax_duration and fill in the biggest timecode
-  // as the file's duration.
-  s_out->save_pos(s_kax_duration->GetElementPosition());
-  s_kax_duration->SetValue(calculate_file_duration());
-  s_kax_duration->Render(*s_out);
-  s_out->restore_pos();
-  mxinfo(Y(" done\n"));
-
-  mxinfo(Y("The file is being fixed, part 3/4..."));
-  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
-    g_kax_sh_main->UpdateSize();
-    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
-      mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. %1%\n")) % BUGMSG);
-  }
-  mxinfo(Y(" done\n"));
+  // In live mode nothing written so far can be changed anymore.
+  if (!g_live_output) {
+    mxinfo(Y("The file is being fixed, part 2/4..."));
+    // Now re-render the kax_duration and fill in the biggest timecode
+    // as the file's duration.
+    s_out->save_pos(s_kax_duration->GetElementPosition());
+    s_kax_duration->SetValue(calculate_file_duration());
+    s_kax_duration->Render(*s_out);
+    s_out->restore_pos();
+    mxinfo(Y(" done\n"));
+
+    mxinfo(Y("The file is being fixed, part 3/4..."));
+    if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+      g_kax_sh_main->UpdateSize();
+      if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+        mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. %1%\n")) % BUGMSG);
+    }
+    mxinfo(Y(" done\n"));
 
-  mxinfo(Y("The file is being fixed, part 4/4..."));
-  // Set the correct size for the segment.
-  if (g_kax_segment->ForceSize(s_out->getFilePointer() - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
-    g_kax_segment->OverwriteHead(*s_out);
+    mxinfo(Y("The file is being fixed, part 4/4..."));
+    // Set the correct size for the segment.
+    if (g_kax_segment->ForceSize(s_out->getFilePointer() - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+      g_kax_segment->OverwriteHead(*s_out);
 
-  mxinfo(Y(" done\n"));
+    mxinfo(Y(" done\n"));
+  }
 
   // Manually close s_out because cleanup() will discard any remaining
   // write buffer content in s_out.
@@ -478,7 +492,9 @@ set_required_matroska_read_version(unsigned int required_read_version) {
 
 static void
 render_ebml_head(mm_io_c *out) {
-  if (!hack_engaged(ENGAGE_NO_CUE_DURATION) || !hack_engaged(ENGAGE_NO_CUE_RELATIVE_POSITION))
+  // The head cannot be updated in live mode. Declare the highest
+  // version any of the elements written later might require.
+  if (g_live_output || !hack_engaged(ENGAGE_NO_CUE_DURATION) || !hack_engaged(ENGAGE_NO_CUE_RELATIVE_POSITION))
     set_required_matroska_version(4);
 
   if (!hack_engaged(ENGAGE_NO_SIMPLE_BLOCKS))
@@ -498,7 +514,7 @@ void
 rerender_ebml_head() {
   mm_io_c *out = g_cluster_helper->get_output();
 
-  if (!out || !s_head)
+  if (!out || !s_head || g_live_output)
     return;
 
   out->save_pos(s_head->GetElementPosition());
@@ -542,6 +558,17 @@ generate_segment_uids() {
   s_seguid_next.generate_random();
 }
 
+static int64_t
+get_expected_track_header_growth() {
+  auto growth = int64_t{};
+
+  for (auto &ptzr : g_packetizers)
+    if (ptzr.packetizer)
+      growth += ptzr.packetizer->get_expected_header_growth();
+
+  return growth;
+}
+
 /** \brief Render the basic EBML and Matroska headers
 
    Renders the segment information and track headers. Also reserves
@@ -555,10 +582,14 @@ render_headers(mm_io_c *out) {
 
     s_kax_infos = std::make_unique<KaxInfo>();
 
-    s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
+    // The duration is unknown in live mode and can only be set after
+    // the fact otherwise.
+    if (!g_live_output) {
+      s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
 
-    s_kax_duration->SetValue(0.0);
-    s_kax_infos->PushElement(*s_kax_duration);
+      s_kax_duration->SetValue(0.0);
+      s_kax_infos->PushElement(*s_kax_duration);
+    }
 
     if (s_muxing_app.empty()) {
       auto info_data = get_default_segment_info_data("mkvmerge");
@@ -634,13 +665,20 @@ render_headers(mm_io_c *out) {
       g_previous_segment_filename.clear();
     }
 
+    // In live mode the segment's size stays unknown, and there's no
+    // meta seek element as it could never be filled in.
+    if (g_live_output)
+      g_kax_segment->SetSizeInfinite(true);
+
     g_kax_segment->WriteHead(*out, 8);
 
     // Reserve some space for the meta seek stuff.
     g_kax_sh_main = std::make_unique<KaxSeekHead>();
-    s_kax_sh_void = std::make_unique<EbmlVoid>();
-    s_kax_sh_void->SetSize(4096);
-    s_kax_sh_void->Render(*out);
+    if (!g_live_output) {
+      s_kax_sh_void = std::make_unique<EbmlVoid>();
+      s_kax_sh_void->SetSize(4096);
+      s_kax_sh_void->Render(*out);
+    }
 
     if (g_write_meta_seek_for_clusters)
       g_kax_sh_cues = std::make_unique<KaxSeekHead>();
@@ -677,10 +715,19 @@ render_headers(mm_io_c *out) {
       g_kax_tracks->Render(*out, false);
       g_kax_sh_main->IndexThis(*g_kax_tracks, *g_kax_segment);
 
+      if (g_live_output)
+        return;
+
       // Reserve some small amount of space for header changes by the
-      // packetizers.
+      // packetizers plus what they expect to add later on so that
+      // re-rendering the track headers doesn't require moving all the
+      // data written in between.
+      auto expected_growth = get_expected_track_header_growth();
+
+      mxdebug_if(s_debug_rerender_track_headers, boost::format("[rerender] render_headers: expected track header growth %1%\n") % expected_growth);
+
       s_void_after_track_headers = std::make_unique<EbmlVoid>();
-      s_void_after_track_headers->SetSize(1024 + full_header_size - g_kax_tracks->ElementSize(false));
+      s_void_after_track_headers->SetSize(calculate_initial_void_after_track_headers(full_header_size, g_kax_tracks->ElementSize(false), expected_growth));
       s_void_after_track_headers->Render(*out);
     }
 
@@ -841,6 +888,15 @@ shrink_void_and_rerender_track_headers(int64_t new_void_size) {
 */
 void
 rerender_track_headers() {
+  if (g_live_output) {
+    static auto s_warning_shown = false;
+    if (!s_warning_shown)
+      mxwarn(Y("The track headers would have to be updated with information that is only known after some of the content has been read. "
+               "This is not possible in live mode as the headers have already been written. Some players might not be able to play the file.\n"));
+    s_warning_shown = true;
+    return;
+  }
+
   g_kax_tracks->UpdateSize(false);
 
   auto position_before    = s_out->getFilePointer();
@@ -848,21 +904,16 @@ rerender_track_headers() {
   auto new_tracks_end_pos = g_kax_tracks->GetElementPosition() + g_kax_tracks->ElementSize();
   auto data_start_pos     = s_void_after_track_headers->GetElementPosition() + s_void_after_track_headers->ElementSize(true);
   auto data_size          = file_size_before - data_start_pos;
-  auto new_void_size      = data_start_pos >= (new_tracks_end_pos + 4) ? data_start_pos - new_tracks_end_pos : 1024;
+  auto rerender           = calculate_track_headers_rerender(new_tracks_end_pos, data_start_pos, data_size, g_kax_tracks->ElementSize());
 
   mxdebug_if(s_debug_rerender_track_headers,
-             boost::format("[rerender] track_headers: new_tracks_end_pos %1% data_start_pos %2% data_size %3% old void at %4% size %5% new_void_size %6%\n")
-             % new_tracks_end_pos % data_start_pos % data_size % s_void_after_track_headers->GetElementPosition() % s_void_after_track_headers->ElementSize(true) % new_void_size);
+             boost::format("[rerender] track_headers: new_tracks_end_pos %1% data_start_pos %2% data_size %3% old void at %4% size %5% new_void_size %6% relocation %7%\n")
+             % new_tracks_end_pos % data_start_pos % data_size % s_void_after_track_headers->GetElementPosition() % s_void_after_track_headers->ElementSize(true) % rerender.m_void_size % rerender.m_relocation);
 
-  if (data_size  && (new_tracks_end_pos >= (data_start_pos - 3))) {
-    auto delta      = 1024 + new_tracks_end_pos - data_start_pos;
-    data_start_pos += delta;
-    new_void_size   = 1024;
+  if (rerender.m_relocation)
+    relocate_written_data(data_start_pos, rerender.m_relocation);
 
-    relocate_written_data(data_start_pos - delta, delta);
-  }
-
-  shrink_void_and_rerender_track_headers(new_void_size);
+  shrink_void_and_rerender_track_headers(rerender.m_void_size);
 
   mxdebug_if(s_debug_rerender_track_headers,
              boost::format("[rerender] track_headers:   position_before %1% file_size_before %2% (diff %3%) position_after %4% file_size_after %5% (diff %6%) void now at %7% size %8%\n")
@@ -1283,7 +1334,8 @@ add_tags_from_cue_chapters() {
  */
 static void
 render_chapter_void_placeholder() {
-  if ((0 >= s_max_chapter_size) && (chapter_generation_mode_e::none == g_cluster_helper->get_chapter_generation_mode()))
+  // Chapters are written at the end in live mode.
+  if (g_live_output || ((0 >= s_max_chapter_size) && (chapter_generation_mode_e::none == g_cluster_helper->get_chapter_generation_mode())))
     return;
 
   auto size           = s_max_chapter_size + (chapter_generation_mode_e::none == g_cluster_helper->get_chapter_generation_mode() ? 100 : 1000);
@@ -1334,7 +1386,16 @@ create_next_output_file() {
 
   // Open the output file.
   try {
-    s_out = !g_cluster_helper->discarding() ? mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024) : mm_io_cptr{ new mm_null_io_c{this_outfile} };
+    if (g_cluster_helper->discarding())
+      s_out = mm_io_cptr{ new mm_null_io_c{this_outfile} };
+
+    else if (g_live_output)
+      // Keep the buffer small so that the data reaches the consumer in
+      // a timely manner. It is flushed after each cluster anyway.
+      s_out = std::make_shared<mm_write_buffer_io_c>(mm_sequential_write_io_c::open(this_outfile), 128 * 1024);
+
+    else
+      s_out = mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024, 1 < g_num_threads);
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % this_outfile % ex);
   }
@@ -1468,44 +1529,13 @@ set_track_statistics_tags(KaxTags *tags) {
   return tags;
 }
 
-/** \brief Finishes and closes the current file
+/** \brief Updates the segment information with values known at the end
 
-   Renders the data that is generated during the muxing run. The cues
-   and meta seek information are rendered at the end. If splitting is
-   active the chapters are stripped to those that actually lie in this
-   file and rendered at the front.  The segment duration and the
-   segment size are set to their actual values.
+   Fills in the file's duration and adds or removes the 'next segment
+   UID'.
 */
-void
-finish_file(bool last_file,
-            bool create_new_file,
-            bool previously_discarding) {
-  if (g_kax_chapters && !previously_discarding)
-    add_chapters_for_current_part();
-
-  if (!last_file && !create_new_file)
-    return;
-
-  run_before_file_finished_packetizer_hooks();
-
-  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
-  if (do_output)
-    mxinfo("\n");
-
-  // Render the track headers a second time if the user has requested that.
-  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
-    auto second_tracks = clone(g_kax_tracks);
-    second_tracks->Render(*s_out);
-    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
-  }
-
-  // Render the cues.
-  if (g_write_cues && g_cue_writing_requested) {
-    if (do_output)
-      mxinfo(Y("The cue entries (the index) are being written...\n"));
-    cues_c::get().write(*s_out, *g_kax_sh_main);
-  }
-
+static void
+finish_segment_info(bool last_file) {
   // Now re-render the s_kax_duration and fill in the biggest timecode
   // as the file's duration.
   s_out->save_pos(s_kax_duration->GetElementPosition());
@@ -1556,6 +1586,49 @@ finish_file(bool last_file,
     }
   }
   s_out->restore_pos();
+}
+
+/** \brief Finishes and closes the current file
+
+   Renders the data that is generated during the muxing run. The cues
+   and meta seek information are rendered at the end. If splitting is
+   active the chapters are stripped to those that actually lie in this
+   file and rendered at the front.  The segment duration and the
+   segment size are set to their actual values.
+*/
+void
+finish_file(bool last_file,
+            bool create_new_file,
+            bool previously_discarding) {
+  if (g_kax_chapters && !previously_discarding)
+    add_chapters_for_current_part();
+
+  if (!last_file && !create_new_file)
+    return;
+
+  run_before_file_finished_packetizer_hooks();
+
+  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
+  if (do_output)
+    mxinfo("\n");
+
+  // Render the track headers a second time if the user has requested that.
+  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
+    auto second_tracks = clone(g_kax_tracks);
+    second_tracks->Render(*s_out);
+    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
+  }
+
+  // Render the cues.
+  if (g_write_cues && g_cue_writing_requested) {
+    if (do_output)
+      mxinfo(Y("The cue entries (the index) are being written...\n"));
+    cues_c::get().write(*s_out, *g_kax_sh_main);
+  }
+
+  // Nothing written before can be modified in live mode.
+  if (!g_live_output)
+    finish_segment_info(last_file);
 
   // Render the segment info a second time if the user has requested that.
   if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
@@ -1610,7 +1683,7 @@ finish_file(bool last_file,
     s_kax_as.reset();
   }
 
-  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+  if (!g_live_output && (g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
     g_kax_sh_main->UpdateSize();
     if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
@@ -1619,9 +1692,12 @@ finish_file(bool last_file,
 
   // Set the correct size for the segment.
   int64_t final_file_size = s_out->getFilePointer();
-  if (g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+  if (!g_live_output && g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
     g_kax_segment->OverwriteHead(*s_out);
 
+  // Close the file explicitly so that errors writing the remaining
+  // buffered or queued data are reported. The destructor ignores them.
+  s_out->close();
   s_out.reset();
 
   g_kax_segment.reset();
@@ -1783,6 +1859,8 @@ append_track(packetizer_t &ptzr,
   ptzr.file                            = amap.src_file_id;
   ptzr.status                          = FILE_STATUS_MOREDATA;
 
+  s_idle_packetizers.insert(&ptzr - &g_packetizers[0]);
+
   // Fix the globally stored video packetizer reference so that
   // decisions based on a packet's source such as when to render a new
   // cluster continue working.
@@ -1941,8 +2019,30 @@ check_and_handle_end_of_input_after_pulling(packetizer_t &ptzr) {
   file.old_num_unfinished_packetizers = file.num_unfinished_packetizers;
 }
 
+static void
+requeue_packetizer(std::size_t idx,
+                   bool had_packet) {
+  auto &ptzr = g_packetizers[idx];
+
+  if (ptzr.pack && !had_packet)
+    s_packetizer_queue.push(ptzr.pack->output_order_timecode, idx);
+
+  // Packetizers without a packet must be pulled again unless they've
+  // run dry. Holding packetizers must be visited during the next
+  // pass even if they have a packet so that their status is reset.
+  auto is_idle = ptzr.pack ? (FILE_STATUS_HOLDING      == ptzr.status)
+               :             (FILE_STATUS_DONE_AND_DRY != ptzr.status);
+
+  if (is_idle)
+    s_idle_packetizers.insert(idx);
+}
+
 static bool
 force_pull_packetizers_of_fully_held_files() {
+  auto holding = brng::find_if(s_idle_packetizers, [](std::size_t idx) { return FILE_STATUS_HOLDING == g_packetizers[idx].status; });
+  if (holding == s_idle_packetizers.end())
+    return false;
+
   std::unordered_map<generic_reader_c *, bool> fully_held_files;
 
   for (auto &ptzr : g_packetizers) {
@@ -1957,24 +2057,44 @@ force_pull_packetizers_of_fully_held_files() {
   }
 
   auto force_pulled = false;
-  for (auto &ptzr : g_packetizers)
-    if (fully_held_files[ptzr.packetizer->m_reader] && !ptzr.packetizer->packet_available()) {
-      ptzr.old_status = ptzr.status;
-      ptzr.status     = ptzr.packetizer->read(true);
-      force_pulled    = true;
+  for (auto idx = 0u, num_packetizers = static_cast<unsigned int>(g_packetizers.size()); idx < num_packetizers; ++idx) {
+    auto &ptzr = g_packetizers[idx];
 
-      if (!ptzr.pack)
-        ptzr.pack = ptzr.packetizer->get_packet();
+    if (!fully_held_files[ptzr.packetizer->m_reader] || ptzr.packetizer->packet_available())
+      continue;
 
-      check_and_handle_end_of_input_after_pulling(ptzr);
-    }
+    auto had_packet = !!ptzr.pack;
+
+    ptzr.old_status = ptzr.status;
+    ptzr.status     = ptzr.packetizer->read(true);
+    force_pulled    = true;
+
+    if (!ptzr.pack)
+      ptzr.pack = ptzr.packetizer->get_packet();
+
+    check_and_handle_end_of_input_after_pulling(ptzr);
+    requeue_packetizer(idx, had_packet);
+  }
 
   return force_pulled;
 }
 
+/** \brief Pull packets from all packetizers that need one
+
+   Only packetizers whose packet has been consumed or whose status
+   requires re-evaluation are visited. All others still hold a packet
+   and are queued in \c s_packetizer_queue already. The packetizers are
+   visited in the order of \c g_packetizers just like before.
+*/
 static void
 pull_packetizers_for_packets() {
-  for (auto &ptzr : g_packetizers) {
+  auto idle_packetizers = std::move(s_idle_packetizers);
+  s_idle_packetizers.clear();
+
+  for (auto idx : idle_packetizers) {
+    auto &ptzr      = g_packetizers[idx];
+    auto had_packet = !!ptzr.pack;
+
     if (FILE_STATUS_HOLDING == ptzr.status)
       ptzr.status = FILE_STATUS_MOREDATA;
 
@@ -1993,25 +2113,27 @@ pull_packetizers_for_packets() {
       ptzr.pack = ptzr.packetizer->get_packet();
 
     check_and_handle_end_of_input_after_pulling(ptzr);
+    requeue_packetizer(idx, had_packet);
   }
 }
 
 static packetizer_t *
 select_winning_packetizer() {
-  packetizer_t *winner = nullptr;
+  if (s_packetizer_queue.empty())
+    return nullptr;
 
-  for (auto &ptzr : g_packetizers) {
-    if (!ptzr.pack)
-      continue;
+  return &g_packetizers[s_packetizer_queue.top()];
+}
 
-    if (!winner || !winner->pack)
-      winner = &ptzr;
+static void
+release_winning_packetizer(packetizer_t &winner) {
+  auto idx = static_cast<std::size_t>(&winner - &g_packetizers[0]);
 
-    else if (ptzr.pack && (ptzr.pack->output_order_timecode < winner->pack->output_order_timecode))
-      winner = &ptzr;
-  }
+  assert(s_packetizer_queue.top() == idx);
 
-  return winner;
+  s_packetizer_queue.pop();
+  winner.pack.reset();
+  s_idle_packetizers.insert(idx);
 }
 
 static void
@@ -2030,6 +2152,12 @@ discard_queued_packets() {
 */
 void
 main_loop() {
+  s_packetizer_queue.clear();
+  s_idle_packetizers.clear();
+
+  for (auto idx = 0u; idx < g_packetizers.size(); ++idx)
+    s_idle_packetizers.insert(idx);
+
   // Let's go!
   while (1) {
     // Step 1: Make sure a packet is available for each output
@@ -2051,7 +2179,7 @@ main_loop() {
       // rendered automatically.
       g_cluster_helper->add_packet(pack);
 
-      winner->pack.reset();
+      release_winning_packetizer(*winner);
 
       // If splitting by parts is active and the last part has been
       // processed fully then we can finish up.
@@ -2080,6 +2208,8 @@ main_loop() {
 */
 static void
 destroy_readers() {
+  s_packetizer_queue.clear();
+  s_idle_packetizers.clear();
   g_files.clear();
   g_packetizers.clear();
 }
@@ -173,6 +173,7 @@ extern generic_packetizer_c *g_video_packetizer;
 
 extern bool g_write_cues, g_cue_writing_requested, g_write_date;
 extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags;
+extern bool g_live_output;
 
 extern bool g_identifying;
 extern identification_output_format_e g_identification_output_format;
@@ -185,6 +186,7 @@ extern int g_max_blocks_per_cluster;
 extern int g_default_tracks[3], g_default_tracks_priority[3];
 
 extern int g_split_max_num_files;
+extern int g_num_threads;
 extern std::string g_splitting_by_chapters_arg;
 
 extern append_mode_e g_append_mode;
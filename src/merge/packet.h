@@ -16,7 +16,10 @@
 
 #include "common/common_pch.h"
 
+#include <future>
+
 #include "common/timestamp.h"
+#include "merge/compression_pool.h"
 
 namespace libmatroska {
   class KaxBlock;
@@ -67,6 +70,11 @@ struct packet_t {
 
   std::vector<packet_extension_cptr> extensions;
 
+  // Set while the data and data adds are being compressed on a worker
+  // thread. The result contains the compressed data followed by the
+  // compressed data adds.
+  std::future<compression_pool_c::result_t> pending_compression;
+
   packet_t()
     : group{}
     , block{}
@@ -149,6 +157,17 @@ struct packet_t {
   ~packet_t() {
   }
 
+  // Packets are created and destroyed for each frame. Their memory is
+  // recycled once they've been rendered if the memory pools are
+  // enabled.
+  static void *operator new(size_t size) {
+    return mtx::mem::object_pool_c<packet_t>::allocate(size);
+  }
+
+  static void operator delete(void *p, size_t size) {
+    mtx::mem::object_pool_c<packet_t>::release(p, size);
+  }
+
   bool
   has_timecode()
     const {
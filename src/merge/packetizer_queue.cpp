@@ -0,0 +1,56 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   the packetizer priority queue
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/packetizer_queue.h"
+
+void
+packetizer_queue_c::push(timestamp_c const &timestamp,
+                         std::size_t idx) {
+  m_heap.push_back({ timestamp, idx });
+  std::push_heap(m_heap.begin(), m_heap.end(), std::greater<entry_t>{});
+}
+
+void
+packetizer_queue_c::pop() {
+  assert(!m_heap.empty());
+
+  std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<entry_t>{});
+  m_heap.pop_back();
+}
+
+void
+packetizer_queue_c::clear() {
+  m_heap.clear();
+}
+
+std::size_t
+packetizer_queue_c::top()
+  const {
+  assert(!m_heap.empty());
+
+  return m_heap.front().m_idx;
+}
+
+std::size_t
+packetizer_queue_c::size()
+  const {
+  return m_heap.size();
+}
+
+bool
+packetizer_queue_c::empty()
+  const {
+  return m_heap.empty();
+}
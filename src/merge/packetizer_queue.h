@@ -0,0 +1,49 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   class definition for the packetizer priority queue
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_PACKETIZER_QUEUE_H
+#define MTX_MERGE_PACKETIZER_QUEUE_H
+
+#include "common/common_pch.h"
+
+#include "common/timestamp.h"
+
+// Min-heap of packetizer indexes keyed on the output order timestamp
+// of the packet each packetizer currently holds. Ties are broken by
+// the packetizer's index so that the winner is always the same one a
+// linear scan over all packetizers would select.
+class packetizer_queue_c {
+protected:
+  struct entry_t {
+    timestamp_c m_timestamp;
+    std::size_t m_idx;
+
+    bool operator >(entry_t const &other) const {
+      return  (m_timestamp >  other.m_timestamp)
+          || ((m_timestamp == other.m_timestamp) && (m_idx > other.m_idx));
+    }
+  };
+
+  std::vector<entry_t> m_heap;
+
+public:
+  void push(timestamp_c const &timestamp, std::size_t idx);
+  void pop();
+  void clear();
+
+  std::size_t top() const;
+  std::size_t size() const;
+  bool empty() const;
+};
+
+#endif  // MTX_MERGE_PACKETIZER_QUEUE_H
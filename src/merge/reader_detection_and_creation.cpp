@@ -12,9 +12,17 @@
 
 #include "common/common_pch.h"
 
+#include <atomic>
+#include <thread>
+
 // #include "common/logger.h"
+#include "common/hacks.h"
+#include "common/mm_mmap_io.h"
+#include "common/mm_probe_io.h"
 #include "common/mm_mpls_multi_file_io.h"
+#include "common/mm_read_ahead_io.h"
 #include "common/mm_read_buffer_io.h"
+#include "common/mm_sequential_read_io.h"
 #include "common/strings/formatting.h"
 #include "common/xml/xml.h"
 #include "input/r_aac.h"
@@ -57,6 +65,7 @@
 #include "input/r_webvtt.h"
 #include "merge/filelist.h"
 #include "merge/input_x.h"
+#include "merge/output_control.h"
 #include "merge/reader_detection_and_creation.h"
 
 static std::vector<bfs::path>
@@ -68,17 +77,78 @@ file_names_to_paths(const std::vector<std::string> &file_names) {
   return paths;
 }
 
+// Reading ahead only pays off for readers consuming their file front to
+// back. Others such as the MP4 or AVI readers jump between the chunks
+// listed in their indexes, and each jump would discard the data read
+// ahead.
+static bool
+reads_sequentially(file_type_e type) {
+  switch (type) {
+    case FILE_TYPE_AAC:
+    case FILE_TYPE_AC3:
+    case FILE_TYPE_AVC_ES:
+    case FILE_TYPE_DIRAC:
+    case FILE_TYPE_DTS:
+    case FILE_TYPE_FLAC:
+    case FILE_TYPE_FLV:
+    case FILE_TYPE_HEVC_ES:
+    case FILE_TYPE_IVF:
+    case FILE_TYPE_MATROSKA:
+    case FILE_TYPE_MP3:
+    case FILE_TYPE_MPEG_ES:
+    case FILE_TYPE_MPEG_PS:
+    case FILE_TYPE_MPEG_TS:
+    case FILE_TYPE_OGM:
+    case FILE_TYPE_TRUEHD:
+    case FILE_TYPE_VC1:
+    case FILE_TYPE_WAV:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
 static mm_io_cptr
-open_input_file(filelist_t &file) {
+open_input_file(filelist_t &file,
+                bool read_ahead = false) {
   try {
-    if (file.all_names.size() == 1)
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(file.name), 1 << 17));
+    mm_io_c *in = nullptr;
+
+    // Pipes and the standard input buffer the start of the data
+    // themselves. Reading ahead is not possible as they cannot seek.
+    if ((file.all_names.size() == 1) && mm_sequential_read_io_c::is_sequential_source(file.name)) {
+      if (!file.sequential_in)
+        file.sequential_in = std::make_shared<mm_sequential_read_io_c>(mm_sequential_read_io_c::open_source(file.name));
+
+      file.sequential_in->setFilePointer(0);
+      return file.sequential_in;
+    }
+
+    if (file.all_names.size() == 1) {
+      // A memory-mapped file is served from memory already. Buffering
+      // or reading ahead would only add copies.
+      if (hack_engaged(ENGAGE_MEMORY_MAPPED_INPUT)) {
+        auto mapped = mm_file_io_c::open(file.name);
+        if (std::dynamic_pointer_cast<mm_mmap_io_c>(mapped))
+          return mapped;
+      }
+
+      in = new mm_file_io_c(file.name);
+    }
 
     else {
       std::vector<bfs::path> paths = file_names_to_paths(file.all_names);
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_multi_file_io_c(paths, file.name), 1 << 17));
+      in = new mm_multi_file_io_c(paths, file.name);
     }
 
+    // Let a background thread fetch the following blocks from disk
+    // while the main thread is busy parsing.
+    if (read_ahead)
+      in = new mm_read_ahead_io_c(in);
+
+    return mm_io_cptr(new mm_read_buffer_io_c(in, 1 << 17));
+
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file.name % ex);
     return mm_io_cptr{};
@@ -116,10 +186,11 @@ do_probe(Tio &io,
 }
 
 static file_type_e
-detect_text_file_formats(filelist_t const &file) {
+detect_text_file_formats(filelist_t const &file,
+                         mm_probe_io_c::window_cptr const &window) {
   auto text_io = mm_text_io_cptr{};
   try {
-    text_io        = std::make_shared<mm_text_io_c>(new mm_file_io_c(file.name));
+    text_io        = std::make_shared<mm_text_io_c>(window ? static_cast<mm_io_c *>(new mm_probe_io_c{window}) : static_cast<mm_io_c *>(new mm_file_io_c(file.name)));
     auto text_size = text_io->get_size();
 
     if (do_probe<webvtt_reader_c>(text_io, text_size))
@@ -147,20 +218,112 @@ detect_text_file_formats(filelist_t const &file) {
   return FILE_TYPE_IS_UNKNOWN;
 }
 
+using probe_t = std::pair<file_type_e, std::function<bool(mm_io_c *)>>;
+
+/** \brief Run probes and return the type of the first one that succeeds
+
+   The result is the same as if the probes were run one after the other
+   in the given order. With more than one thread allowed and a factory
+   for independent I/O objects the probes are distributed over several
+   threads. Probes following one that has already succeeded aren't
+   started anymore.
+
+   Messages emitted by probes running on worker threads are collected
+   and output afterwards on the calling thread for all probes up to the
+   deciding one, in the order of the probes. Errors don't terminate the
+   program on the worker threads but are reported that way as well.
+*/
+static boost::optional<file_type_e>
+run_probes(std::vector<probe_t> const &probes,
+           mm_io_c *io,
+           std::function<mm_io_cptr()> const &io_factory) {
+  auto num_threads = std::min<std::size_t>(g_num_threads, probes.size());
+
+  if (!io_factory || (2 > num_threads)) {
+    for (auto const &probe : probes)
+      if (probe.second(io))
+        return probe.first;
+
+    return boost::none;
+  }
+
+  auto num_probes = probes.size();
+  auto exceptions = std::vector<std::exception_ptr>(num_probes);
+  auto messages   = std::vector<std::vector<mtx::output::message_t>>(num_probes);
+  std::atomic<std::size_t> next_probe{0}, decided_by{num_probes};
+
+  auto worker = [&]() {
+    auto worker_io = io_factory();
+
+    while (true) {
+      auto idx = next_probe++;
+      if ((idx >= num_probes) || (idx > decided_by))
+        return;
+
+      mtx::output::worker_messages_c worker_messages{true};
+
+      try {
+        auto result   = probes[idx].second(worker_io.get());
+        messages[idx] = worker_messages.get_messages();
+
+        if (!result)
+          continue;
+
+      } catch (...) {
+        messages[idx]   = worker_messages.get_messages();
+        exceptions[idx] = std::current_exception();
+      }
+
+      auto current = decided_by.load();
+      while ((idx < current) && !decided_by.compare_exchange_weak(current, idx))
+        ;
+    }
+  };
+
+  auto threads = std::vector<std::thread>{};
+  for (auto idx = 0u; idx < num_threads; ++idx)
+    threads.emplace_back(worker);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  auto idx = decided_by.load();
+
+  for (auto replay_idx = 0u; (replay_idx <= idx) && (replay_idx < num_probes); ++replay_idx)
+    mtx::output::replay(messages[replay_idx]);
+
+  if (idx >= num_probes)
+    return boost::none;
+
+  if (exceptions[idx])
+    std::rethrow_exception(exceptions[idx]);
+
+  return probes[idx].first;
+}
+
 /** \brief Probe the file type
 
    Opens the input file and calls the \c probe_file function for each known
    file reader class. Uses \c mm_text_io_c for subtitle probing.
+
+   The start of the file is read only once into a window shared by all
+   probes. The probes for file types that can be detected by their
+   magic numbers are run first. The remaining heuristic probes may run
+   in parallel (see \c run_probes).
 */
 static std::pair<file_type_e, int64_t>
 get_file_type_internal(filelist_t &file) {
   mm_io_cptr af_io = open_input_file(file);
-  mm_io_c *io      = af_io.get();
-  int64_t size     = std::min(io->get_size(), static_cast<int64_t>(1 << 25));
+  int64_t size     = std::min(af_io->get_size(), static_cast<int64_t>(1 << 25));
+  auto window      = std::make_shared<mm_probe_io_c::window_c>(af_io, size);
+  auto probe_io    = mm_io_cptr{new mm_probe_io_c{window}};
+  mm_io_c *io      = probe_io.get();
 
   auto is_playlist = !file.is_playlist && open_playlist_file(file, io);
-  if (is_playlist)
+  if (is_playlist) {
     io = file.playlist_mpls_in.get();
+    window.reset();
+  }
 
   // File types that can be detected unambiguously but are not supported
   if (do_probe<aac_adif_reader_c>(io, size))
@@ -207,27 +370,23 @@ get_file_type_internal(filelist_t &file) {
     return { FILE_TYPE_DIRAC, size };
 
   // All text file types (subtitles).
-  auto type = detect_text_file_formats(file);
+  auto type = detect_text_file_formats(file, window);
 
   if (FILE_TYPE_IS_UNKNOWN != type)
     return { type, size };
 
+  auto probes = std::vector<probe_t>{};
+
   // File types that are mis-detected sometimes
-  if (do_probe<dts_reader_c>(io, size, true))
-    return { FILE_TYPE_DTS, size };
-  if (do_probe<mtx::mpeg_ts::reader_c>(io, size))
-    return { FILE_TYPE_MPEG_TS, size };
-  if (do_probe<mpeg_ps_reader_c>(io, size))
-    return { FILE_TYPE_MPEG_PS, size };
+  probes.emplace_back(FILE_TYPE_DTS,     [size](mm_io_c *in) { return do_probe<dts_reader_c>(in, size, true); });
+  probes.emplace_back(FILE_TYPE_MPEG_TS, [size](mm_io_c *in) { return do_probe<mtx::mpeg_ts::reader_c>(in, size); });
+  probes.emplace_back(FILE_TYPE_MPEG_PS, [size](mm_io_c *in) { return do_probe<mpeg_ps_reader_c>(in, size); });
 
   // Try raw audio formats and require eight consecutive frames at the
   // start of the file.
-  if (do_probe<mp3_reader_c>(io, size, 128 * 1024, 8, true))
-    return { FILE_TYPE_MP3, size };
-  if (do_probe<ac3_reader_c>(io, size, 128 * 1024, 8, true))
-    return { FILE_TYPE_AC3, size };
-  if (do_probe<aac_reader_c>(io, size, 128 * 1024, 8, true))
-    return { FILE_TYPE_AAC, size };
+  probes.emplace_back(FILE_TYPE_MP3, [size](mm_io_c *in) { return do_probe<mp3_reader_c>(in, size, 128 * 1024, 8, true); });
+  probes.emplace_back(FILE_TYPE_AC3, [size](mm_io_c *in) { return do_probe<ac3_reader_c>(in, size, 128 * 1024, 8, true); });
+  probes.emplace_back(FILE_TYPE_AAC, [size](mm_io_c *in) { return do_probe<aac_reader_c>(in, size, 128 * 1024, 8, true); });
 
   // File types which are the same in raw format and in other container formats.
   // Detection requires 20 or more consecutive packets.
@@ -235,39 +394,27 @@ get_file_type_internal(filelist_t &file) {
   static int const s_probe_num_required_consecutive_packets1 = 64;
 
   for (auto probe_size : s_probe_sizes1) {
-    if (do_probe<mp3_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets1))
-      return { FILE_TYPE_MP3, size };
-    if (do_probe<ac3_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets1))
-      return { FILE_TYPE_AC3, size };
-    if (do_probe<aac_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets1))
-      return { FILE_TYPE_AAC, size };
+    probes.emplace_back(FILE_TYPE_MP3, [size, probe_size](mm_io_c *in) { return do_probe<mp3_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets1); });
+    probes.emplace_back(FILE_TYPE_AC3, [size, probe_size](mm_io_c *in) { return do_probe<ac3_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets1); });
+    probes.emplace_back(FILE_TYPE_AAC, [size, probe_size](mm_io_c *in) { return do_probe<aac_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets1); });
   }
 
   // More file types with detection issues.
-  if (do_probe<truehd_reader_c>(io, size))
-    return { FILE_TYPE_TRUEHD, size };
-  if (do_probe<dts_reader_c>(io, size))
-    return { FILE_TYPE_DTS, size };
-  if (do_probe<vobbtn_reader_c>(io, size))
-    return { FILE_TYPE_VOBBTN, size };
+  probes.emplace_back(FILE_TYPE_TRUEHD, [size](mm_io_c *in) { return do_probe<truehd_reader_c>(in, size); });
+  probes.emplace_back(FILE_TYPE_DTS,    [size](mm_io_c *in) { return do_probe<dts_reader_c>(in, size); });
+  probes.emplace_back(FILE_TYPE_VOBBTN, [size](mm_io_c *in) { return do_probe<vobbtn_reader_c>(in, size); });
 
   // Try some more of the raw audio formats before trying elementary
   // stream video formats (MPEG 1/2, AVC/h.264, HEVC/h.265; those
   // often enough simply work). However, require that the first frame
   // starts at the beginning of the file.
-  if (do_probe<mp3_reader_c>(io, size, 32 * 1024, 1, true))
-    return { FILE_TYPE_MP3, size };
-  if (do_probe<ac3_reader_c>(io, size, 32 * 1024, 1, true))
-    return { FILE_TYPE_AC3, size };
-  if (do_probe<aac_reader_c>(io, size, 32 * 1024, 1, true))
-    return { FILE_TYPE_AAC, size };
+  probes.emplace_back(FILE_TYPE_MP3, [size](mm_io_c *in) { return do_probe<mp3_reader_c>(in, size, 32 * 1024, 1, true); });
+  probes.emplace_back(FILE_TYPE_AC3, [size](mm_io_c *in) { return do_probe<ac3_reader_c>(in, size, 32 * 1024, 1, true); });
+  probes.emplace_back(FILE_TYPE_AAC, [size](mm_io_c *in) { return do_probe<aac_reader_c>(in, size, 32 * 1024, 1, true); });
 
-  if (do_probe<mpeg_es_reader_c>(io, size))
-    return { FILE_TYPE_MPEG_ES, size };
-  if (do_probe<avc_es_reader_c>(io, size))
-    return { FILE_TYPE_AVC_ES, size };
-  if (do_probe<hevc_es_reader_c>(io, size))
-    return { FILE_TYPE_HEVC_ES, size };
+  probes.emplace_back(FILE_TYPE_MPEG_ES, [size](mm_io_c *in) { return do_probe<mpeg_es_reader_c>(in, size); });
+  probes.emplace_back(FILE_TYPE_AVC_ES,  [size](mm_io_c *in) { return do_probe<avc_es_reader_c>(in, size); });
+  probes.emplace_back(FILE_TYPE_HEVC_ES, [size](mm_io_c *in) { return do_probe<hevc_es_reader_c>(in, size); });
 
   // File types which are the same in raw format and in other container formats.
   // Detection requires 20 or more consecutive packets.
@@ -275,19 +422,23 @@ get_file_type_internal(filelist_t &file) {
   static int const s_probe_num_required_consecutive_packets2 = 20;
 
   for (auto probe_size : s_probe_sizes2) {
-    if (do_probe<mp3_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets2))
-      return { FILE_TYPE_MP3, size };
-    else if (do_probe<ac3_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets2))
-      return { FILE_TYPE_AC3, size };
-    else if (do_probe<aac_reader_c>(io, size, probe_size, s_probe_num_required_consecutive_packets2))
-      return { FILE_TYPE_AAC, size };
+    probes.emplace_back(FILE_TYPE_MP3, [size, probe_size](mm_io_c *in) { return do_probe<mp3_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets2); });
+    probes.emplace_back(FILE_TYPE_AC3, [size, probe_size](mm_io_c *in) { return do_probe<ac3_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets2); });
+    probes.emplace_back(FILE_TYPE_AAC, [size, probe_size](mm_io_c *in) { return do_probe<aac_reader_c>(in, size, probe_size, s_probe_num_required_consecutive_packets2); });
   }
 
   // File types that are mis-detected sometimes and that aren't supported
-  if (do_probe<dv_reader_c>(io, size))
-    return { FILE_TYPE_DV, size };
+  probes.emplace_back(FILE_TYPE_DV, [size](mm_io_c *in) { return do_probe<dv_reader_c>(in, size); });
+
+  // Playlists are probed through their own I/O object which cannot be
+  // shared between threads.
+  auto io_factory = std::function<mm_io_cptr()>{};
+  if (window)
+    io_factory = [&window]() { return mm_io_cptr{new mm_probe_io_c{window}}; };
 
-  return { FILE_TYPE_IS_UNKNOWN, size };
+  auto result = run_probes(probes, io, io_factory);
+
+  return { result ? *result : FILE_TYPE_IS_UNKNOWN, size };
 }
 
 void
@@ -313,7 +464,11 @@ create_readers() {
 
   for (auto &file : g_files) {
     try {
-      mm_io_cptr input_file = file->playlist_mpls_in ? std::static_pointer_cast<mm_io_c>(file->playlist_mpls_in) : open_input_file(*file);
+      mm_io_cptr input_file = file->playlist_mpls_in ? std::static_pointer_cast<mm_io_c>(file->playlist_mpls_in) : open_input_file(*file, !g_identifying && (1 < g_num_threads) && reads_sequentially(file->type));
+
+      // The reader may read beyond the data buffered for probing.
+      if (file->sequential_in)
+        file->sequential_in->enable_streaming();
 
       switch (file->type) {
         case FILE_TYPE_AAC:
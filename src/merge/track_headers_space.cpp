@@ -0,0 +1,40 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   space reserved for growing track headers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/track_headers_space.h"
+
+int64_t
+calculate_initial_void_after_track_headers(int64_t full_size,
+                                           int64_t rendered_size,
+                                           int64_t expected_growth) {
+  return g_track_headers_min_reserve + full_size - rendered_size + expected_growth;
+}
+
+track_headers_rerender_t
+calculate_track_headers_rerender(int64_t new_tracks_end_pos,
+                                 int64_t data_start_pos,
+                                 int64_t data_size,
+                                 int64_t tracks_size) {
+  if (data_start_pos >= (new_tracks_end_pos + 4))
+    return { 0, data_start_pos - new_tracks_end_pos };
+
+  // Nothing has been written after the void yet.
+  if (!data_size)
+    return { 0, g_track_headers_min_reserve };
+
+  auto headroom = std::max<int64_t>(g_track_headers_min_reserve, tracks_size);
+
+  return { headroom + new_tracks_end_pos - data_start_pos, headroom };
+}
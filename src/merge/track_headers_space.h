@@ -0,0 +1,71 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   space reserved for growing track headers
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_TRACK_HEADERS_SPACE_H
+#define MTX_MERGE_TRACK_HEADERS_SPACE_H
+
+#include "common/common_pch.h"
+
+// The track headers are written before any frame has been parsed. A
+// void after them leaves room for changes the packetizers make later
+// on. If the re-rendered headers don't fit in front of the data
+// written after the void anymore then all of that data must be moved.
+
+// Space for header changes that aren't announced by the packetizers.
+int64_t const g_track_headers_min_reserve = 1024;
+
+// Sizes by which the track headers of codecs whose codec private data
+// is created from the first frames are expected to grow. They aren't
+// limits; larger codec private data only means that the data written
+// so far has to be moved.
+//
+// avcC: 11 bytes of fixed fields and a 2 byte length per parameter
+// set. One SPS with VUI and HRD parameters and one PPS with scaling
+// matrices each stay below 200 bytes in practice; the rest is left for
+// streams with several parameter sets.
+int64_t const g_expected_avcc_size  = 1024;
+// hvcC: 23 bytes of fixed fields, 3 bytes per NALU array and a 2 byte
+// length per NALU. VPS, SPS and PPS take a few hundred bytes even with
+// VUI, HRD parameters and scaling lists. The user data SEI NALUs are
+// stored as well; encoders such as x265 put their settings in there,
+// which usually takes one to one and a half kilobytes.
+int64_t const g_expected_hevcc_size = 2048;
+// MPEG-1/2: a sequence header with both quantizer matrices is 140
+// bytes. The sequence extension, sequence display extension and GOP
+// header add 30 bytes. The rest is room for user data.
+int64_t const g_expected_mpeg1_2_codec_private_size = 512;
+// MPEG-4 part 2: the visual object sequence, visual object and video
+// object layer headers take about 30 bytes, up to 128 bytes more with
+// quantizer matrices, plus encoder identification in user data.
+int64_t const g_expected_mpeg4_p2_codec_private_size = 512;
+
+struct track_headers_rerender_t {
+  // Number of bytes by which the data following the void must be
+  // moved; 0 if the new track headers fit.
+  int64_t m_relocation;
+  // Size of the void after the re-rendered track headers
+  int64_t m_void_size;
+};
+
+// Size of the void written after the track headers the first time.
+// full_size includes elements with default values that aren't
+// rendered yet.
+int64_t calculate_initial_void_after_track_headers(int64_t full_size, int64_t rendered_size, int64_t expected_growth);
+
+// The void following the re-rendered track headers needs at least
+// four bytes. Otherwise the data is moved so that as much space as the
+// track headers take up themselves is left, making it unlikely that
+// further growth requires moving again.
+track_headers_rerender_t calculate_track_headers_rerender(int64_t new_tracks_end_pos, int64_t data_start_pos, int64_t data_size, int64_t tracks_size);
+
+#endif // MTX_MERGE_TRACK_HEADERS_SPACE_H
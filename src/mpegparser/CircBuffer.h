@@ -90,6 +90,18 @@ public:
     return read_ptr;
   }
 
+  //Returns a pointer to the byte at position i and in "contiguous" the
+  //number of bytes that can be accessed from there before the buffer wraps.
+  binary* GetContiguousPtr(unsigned int i, uint32_t& contiguous){
+    uint32_t bbw = bytes_before_wrap_read();
+    if(i < bbw){
+      contiguous = bbw - i;
+      return read_ptr + i;
+    }
+    contiguous = buf_capacity - (i - bbw);
+    return m_buf + (i - bbw);
+  }
+
   binary& operator[](unsigned int i){
     if(i > bytes_in_buf){
       return read_ptr[0];
@@ -22,6 +22,8 @@
 
 #include "common/common_pch.h"
 
+#include "common/mpeg.h"
+
 #include "MPEGVideoBuffer.h"
 #include <cstring>
 
@@ -37,30 +39,43 @@ MPEG2PictureHeader::MPEG2PictureHeader() {
   memset(this, 0, sizeof(*this));
 }
 
+static inline bool IsWantedStartCode(binary code){
+  return (code == MPEG_VIDEO_SEQUENCE_START_CODE)
+      || (code == MPEG_VIDEO_GOP_START_CODE)
+      || (code == MPEG_VIDEO_PICTURE_START_CODE);
+}
+
 int32_t MPEGVideoBuffer::FindStartCode(uint32_t startPos){
-  //How many bytes can we look through?
-  uint32_t window = myBuffer->GetLength() - startPos;
+  uint32_t length = myBuffer->GetLength();
 
-  if(window < 4) //Make sure we have enough bytes to search.
+  if((startPos + 4) > length) //Make sure we have enough bytes to search.
     return -1;
 
-  for(unsigned int i = startPos; i < (startPos + window - 3); i++){
-    CircBuffer& buf = *myBuffer;
-    binary a,b,c,d;
-    a = buf[i];
-    b = buf[i+1];
-    c = buf[i+2];
-    d = buf[i+3];
-    if((a == 0x00) && (b == 0x00) && (c == 0x01)){
-      switch(d){
-        case MPEG_VIDEO_SEQUENCE_START_CODE:
-        case MPEG_VIDEO_GOP_START_CODE:
-        case MPEG_VIDEO_PICTURE_START_CODE:
-          return i;  //Return our position if we found
-          //one of the codes we want
+  //Start codes may begin at any position before "last".
+  uint32_t last = length - 3;
+  uint32_t i = startPos;
+  CircBuffer& buf = *myBuffer;
 
-      }
+  while(i < last){
+    uint32_t contiguous = 0;
+    binary* ptr = buf.GetContiguousPtr(i, contiguous);
+    contiguous = std::min(contiguous, length - i);
+
+    //Search the part before the buffer wraps with the shared start
+    //code finder. All four bytes have to be located in that part.
+    if(contiguous >= 4){
+      binary* end = ptr + contiguous - 1;
+      for(binary* p = mtx::mpeg::find_start_code(ptr, end); p != end; p = mtx::mpeg::find_start_code(p + 1, end))
+        if(IsWantedStartCode(p[3]))
+          return i + (p - ptr);
+      i += contiguous - 3;
     }
+
+    //Start codes crossing the wrap are checked byte by byte.
+    uint32_t segmentEnd = std::min(i + std::min<uint32_t>(contiguous, 3), last);
+    for(; i < segmentEnd; i++)
+      if((buf[i] == 0x00) && (buf[i+1] == 0x00) && (buf[i+2] == 0x01) && IsWantedStartCode(buf[i+3]))
+        return i;
   }
 
   //If we get here we have no _wanted_ start code found.
@@ -79,10 +94,13 @@ void MPEGVideoBuffer::UpdateState(){
     if(test != -1)  //We found a new startcode
       chunkStart = test;
   }
-  if(chunkEnd == -1){
-    test = FindStartCode(chunkStart+4);
+  if(chunkEnd == -1 && chunkStart != -1){
+    uint32_t searchStart = std::max<uint32_t>(chunkStart + 4, searchResumePos);
+    test = FindStartCode(searchStart);
     if(test != -1)  //We found a new startcode
       chunkEnd = test;
+    else if(myBuffer->GetLength() >= 3) //the last three bytes may start one
+      searchResumePos = std::max<uint32_t>(searchStart, myBuffer->GetLength() - 3);
   }
   if(chunkStart == -1 || chunkEnd == -1){
     state = MPEG2_BUFFER_STATE_NEED_MORE_DATA;
@@ -104,6 +122,7 @@ MPEGChunk * MPEGVideoBuffer::ReadChunk(){
     myBuffer->Read(chunkData, chunkLength);
     chunkStart = 0; //we read up to the next start code
     chunkEnd = -1;
+    searchResumePos = 0;
     UpdateState();
     myChunk = new MPEGChunk(chunkData, chunkLength);
     return myChunk;
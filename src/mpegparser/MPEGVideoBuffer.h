@@ -133,6 +133,7 @@ private:
   MPEG2BufferState_e state;
   int32_t chunkStart;
   int32_t chunkEnd;
+  uint32_t searchResumePos; //everything before it has been searched for chunkEnd
   void UpdateState();
   int32_t FindStartCode(uint32_t startPos = 0);
 public:
@@ -141,6 +142,7 @@ public:
     state = MPEG2_BUFFER_STATE_EMPTY;
     chunkStart = -1;
     chunkEnd = -1;
+    searchResumePos = 0;
   }
 
   ~MPEGVideoBuffer(){
@@ -111,7 +111,7 @@ aac_packetizer_c::process_headerless(packet_cptr packet) {
 }
 
 int
-aac_packetizer_c::process(packet_cptr packet) {
+aac_packetizer_c::process_impl(packet_cptr packet) {
   m_timestamp_calculator.add_timestamp(packet);
 
   if (m_mode == mode_e::headerless)
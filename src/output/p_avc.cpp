@@ -90,7 +90,7 @@ mpeg4_p10_es_video_packetizer_c::add_extra_data(memory_cptr data) {
 }
 
 int
-mpeg4_p10_es_video_packetizer_c::process(packet_cptr packet) {
+mpeg4_p10_es_video_packetizer_c::process_impl(packet_cptr packet) {
   try {
     if (packet->has_timecode())
       m_parser.add_timecode(packet->timecode);
@@ -45,7 +45,7 @@ hdmv_pgs_packetizer_c::set_headers() {
 }
 
 int
-hdmv_pgs_packetizer_c::process(packet_cptr packet) {
+hdmv_pgs_packetizer_c::process_impl(packet_cptr packet) {
   if (!m_aggregate_packets) {
     add_packet(packet);
     return FILE_STATUS_MOREDATA;
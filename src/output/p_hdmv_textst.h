@@ -24,7 +24,7 @@ public:
   hdmv_textst_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, memory_cptr const &dialog_style_segment);
   virtual ~hdmv_textst_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void set_headers();
 
   virtual translatable_string_c get_format_name() const {
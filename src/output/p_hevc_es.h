@@ -17,6 +17,7 @@
 
 #include "common/hevc.h"
 #include "merge/generic_packetizer.h"
+#include "merge/track_headers_space.h"
 
 class hevc_es_video_packetizer_c: public generic_packetizer_c {
 protected:
@@ -27,11 +28,16 @@ protected:
 public:
   hevc_es_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti);
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void add_extra_data(memory_cptr data);
   virtual void set_headers();
   virtual void set_container_default_field_duration(int64_t default_duration);
   virtual unsigned int get_nalu_size_length() const;
+  virtual int64_t get_expected_header_growth() const {
+    // The codec private data is only created from the first parameter
+    // sets found in the bitstream.
+    return g_expected_hevcc_size;
+  }
 
   virtual void flush_frames();
 
@@ -174,7 +174,7 @@ mpeg1_2_video_packetizer_c::remove_stuffing_bytes_and_handle_sequence_headers(pa
 }
 
 int
-mpeg1_2_video_packetizer_c::process(packet_cptr packet) {
+mpeg1_2_video_packetizer_c::process_impl(packet_cptr packet) {
   if (0.0 > m_fps)
     extract_fps(packet->data->get_buffer(), packet->data->get_size());
 
@@ -190,11 +190,11 @@ mpeg1_2_video_packetizer_c::process_framed(packet_cptr packet) {
     return FILE_STATUS_MOREDATA;
 
   if (4 > packet->data->get_size())
-    return generic_video_packetizer_c::process(packet);
+    return generic_video_packetizer_c::process_impl(packet);
 
   remove_stuffing_bytes_and_handle_sequence_headers(packet);
 
-  return generic_video_packetizer_c::process(packet);
+  return generic_video_packetizer_c::process_impl(packet);
 }
 
 int
@@ -232,7 +232,7 @@ mpeg1_2_video_packetizer_c::process_unframed(packet_cptr packet) {
 
       remove_stuffing_bytes_and_handle_sequence_headers(new_packet);
 
-      generic_video_packetizer_c::process(new_packet);
+      generic_video_packetizer_c::process_impl(new_packet);
 
       frame->data = nullptr;
       state       = m_parser.GetState();
@@ -245,7 +245,7 @@ mpeg1_2_video_packetizer_c::process_unframed(packet_cptr packet) {
 void
 mpeg1_2_video_packetizer_c::flush_impl() {
   m_parser.SetEOS();
-  generic_packetizer_c::process(new packet_t(new memory_c((unsigned char *)"", 0, false)));
+  process_impl(packet_cptr(new packet_t(new memory_c((unsigned char *)"", 0, false))));
 }
 
 void
@@ -17,6 +17,7 @@
 #include "common/common_pch.h"
 
 #include "common/mpeg1_2.h"
+#include "merge/track_headers_space.h"
 #include "output/p_generic_video.h"
 #include "mpegparser/M2VParser.h"
 
@@ -32,7 +33,12 @@ public:
   mpeg1_2_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, int version, double fps, int width, int height, int dwidth, int dheight, bool framed);
   virtual ~mpeg1_2_video_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
+  virtual int64_t get_expected_header_growth() const {
+    // The sequence header including quantizer matrices becomes the
+    // codec private data once it has been found.
+    return g_expected_mpeg1_2_codec_private_size;
+  }
 
   virtual translatable_string_c get_format_name() const {
     return YT("MPEG-1/2");
@@ -19,6 +19,7 @@
 #include <deque>
 
 #include "common/mpeg4_p2.h"
+#include "merge/track_headers_space.h"
 #include "output/p_video_for_windows.h"
 
 class mpeg4_p2_video_packetizer_c: public video_for_windows_packetizer_c {
@@ -59,7 +60,13 @@ public:
   mpeg4_p2_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, double fps, int width, int height, bool input_is_native);
   virtual ~mpeg4_p2_video_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int64_t get_expected_header_growth() const {
+    // In native mode the codec private data is taken from the first
+    // frame's configuration data.
+    return m_output_is_native && !m_ti.m_private_data ? g_expected_mpeg4_p2_codec_private_size : 0;
+  }
+
+  virtual int process_impl(packet_cptr packet);
 
   virtual translatable_string_c get_format_name() const {
     return YT("MPEG-4");
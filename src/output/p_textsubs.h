@@ -31,7 +31,7 @@ public:
   textsubs_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, const char *codec_id, bool recode, bool is_utf8);
   virtual ~textsubs_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void set_headers();
   virtual void set_line_ending_style(line_ending_style_e line_ending_style);
 
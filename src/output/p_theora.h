@@ -22,7 +22,7 @@ class theora_video_packetizer_c: public generic_video_packetizer_c {
 public:
   theora_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, double fps, int width, int height);
   virtual void set_headers();
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
 
   virtual translatable_string_c get_format_name() const {
     return YT("Theora");
@@ -0,0 +1,163 @@
+/*
+   mkvpropedit -- utility for editing properties of existing Matroska files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/strings/editing.h"
+#include "propedit/batch.h"
+
+// The result of the job currently run. Informational messages are
+// dropped; only the results are output.
+static batch_c::result_t *s_current_result;
+
+static void
+batch_message_handler(unsigned int level,
+                      std::string const &message) {
+  if (MXMSG_INFO == level)
+    return;
+
+  auto text = boost::trim_right_copy(message);
+
+  if (MXMSG_WARNING == level) {
+    if (s_current_result)
+      s_current_result->m_warnings.push_back(text);
+    return;
+  }
+
+  if (s_current_result)
+    s_current_result->m_errors.push_back(text);
+
+  throw mtx::propedit::job_failed_x{text};
+}
+
+batch_c::batch_c(std::vector<std::string> const &common_arguments)
+  : m_common_arguments{common_arguments}
+{
+}
+
+void
+batch_c::add_job(job_t const &job) {
+  m_jobs.push_back(job);
+}
+
+void
+batch_c::read_jobs(std::string const &file_name) {
+  try {
+    auto content = mm_file_io_c::slurp(file_name);
+    parse_jobs(std::string{reinterpret_cast<char const *>(content->get_buffer()), content->get_size()});
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The batch file '%1%' could not be read: %2%.\n")) % file_name % ex);
+  }
+}
+
+void
+batch_c::parse_jobs(std::string const &content) {
+  auto trimmed = boost::trim_copy(content);
+
+  if (!balg::starts_with(trimmed, "[")) {
+    for (auto line : split(content, "\n")) {
+      boost::trim(line);
+      if (!line.empty() && (line[0] != '#'))
+        add_job(job_t{ line, {} });
+    }
+
+    return;
+  }
+
+  try {
+    for (auto const &item : mtx::json::parse(trimmed)) {
+      if (item.is_string()) {
+        add_job(job_t{ item.get<std::string>(), {} });
+        continue;
+      }
+
+      auto job = job_t{ item.at("file_name").get<std::string>(), {} };
+      if (item.count("arguments"))
+        for (auto const &argument : item["arguments"])
+          job.m_arguments.push_back(argument.get<std::string>());
+
+      add_job(job);
+    }
+
+  } catch (std::exception &ex) {
+    mxerror(boost::format(Y("The batch file is not valid JSON or doesn't have the expected structure: %1%\n")) % ex.what());
+  }
+}
+
+nlohmann::json
+batch_c::result_to_json(job_t const &job,
+                        result_t const &result) {
+  auto warnings = nlohmann::json::array();
+  auto errors   = nlohmann::json::array();
+
+  for (auto const &warning : result.m_warnings)
+    warnings.push_back(warning);
+  for (auto const &error : result.m_errors)
+    errors.push_back(error);
+
+  return nlohmann::json{
+    { "file_name", job.m_file_name  },
+    { "success",   result.m_success  },
+    { "modified",  result.m_modified },
+    { "warnings",  warnings          },
+    { "errors",    errors            },
+  };
+}
+
+batch_c::result_t
+batch_c::run_job(job_t const &job,
+                 editor_t const &editor) {
+  auto result      = result_t{};
+  s_current_result = &result;
+
+  auto arguments = m_common_arguments;
+  brng::copy(job.m_arguments, std::back_inserter(arguments));
+  arguments.push_back(job.m_file_name);
+
+  try {
+    result.m_modified = editor(arguments);
+    result.m_success  = true;
+
+  } catch (mtx::propedit::job_failed_x &) {
+    // Already recorded by the message handler.
+
+  } catch (std::exception &ex) {
+    result.m_errors.push_back(ex.what());
+
+  } catch (...) {
+    result.m_errors.push_back(Y("An unknown error occurred."));
+  }
+
+  s_current_result = nullptr;
+
+  return result;
+}
+
+int
+batch_c::run(editor_t const &editor) {
+  set_mxmsg_handler(MXMSG_INFO,    batch_message_handler);
+  set_mxmsg_handler(MXMSG_WARNING, batch_message_handler);
+  set_mxmsg_handler(MXMSG_ERROR,   batch_message_handler);
+
+  auto exit_code = 0;
+
+  for (auto const &job : m_jobs) {
+    auto result = run_job(job, editor);
+
+    g_mm_stdio->puts(mtx::json::dump(result_to_json(job, result)) + "\n");
+    g_mm_stdio->flush();
+
+    exit_code = std::max(exit_code, !result.m_success ? 2 : !result.m_warnings.empty() ? 1 : 0);
+  }
+
+  return exit_code;
+}
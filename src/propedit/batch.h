@@ -0,0 +1,87 @@
+/*
+   mkvpropedit -- utility for editing properties of existing Matroska files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_PROPEDIT_BATCH_H
+#define MTX_PROPEDIT_BATCH_H
+
+#include "common/common_pch.h"
+
+#include "common/json.h"
+
+namespace mtx { namespace propedit {
+
+class job_failed_x: public exception {
+protected:
+  std::string m_message;
+public:
+  job_failed_x(std::string const &message) : m_message{message} { }
+  virtual ~job_failed_x() throw() { }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+}}
+
+// Edits a list of files within one process. The list is either a
+// plain text file with one file name per line or a JSON array. Its
+// items are either file names or objects with the keys "file_name"
+// and "arguments". The latter are additional actions for that file
+// only in the same syntax as on the command line.
+//
+// The jobs are run one after the other as the editing code relies on
+// global state. While a batch is run, errors no longer abort the
+// process but only fail the current file. Informational messages are
+// suppressed. Instead one JSON object per file is output in the order
+// of the list (NDJSON).
+class batch_c {
+public:
+  struct job_t {
+    std::string m_file_name;
+    std::vector<std::string> m_arguments;
+  };
+
+  struct result_t {
+    bool m_success{}, m_modified{};
+    std::vector<std::string> m_warnings, m_errors;
+  };
+
+  // Parses the arguments and edits the file named in them. Returns
+  // whether or not the file has been modified. Failures are reported
+  // via mxerror().
+  using editor_t = std::function<bool(std::vector<std::string> const &arguments)>;
+
+protected:
+  std::vector<std::string> m_common_arguments;
+  std::vector<job_t> m_jobs;
+
+public:
+  batch_c(std::vector<std::string> const &common_arguments);
+
+  void read_jobs(std::string const &file_name);
+  void parse_jobs(std::string const &content);
+  void add_job(job_t const &job);
+
+  std::vector<job_t> const &get_jobs() const {
+    return m_jobs;
+  }
+
+  // Returns the exit code: 0 if all files have been edited without
+  // warnings, 1 if warnings were issued and 2 if at least one failed.
+  int run(editor_t const &editor);
+
+  static nlohmann::json result_to_json(job_t const &job, result_t const &result);
+
+protected:
+  result_t run_job(job_t const &job, editor_t const &editor);
+};
+
+#endif // MTX_PROPEDIT_BATCH_H
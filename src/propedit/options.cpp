@@ -23,16 +23,24 @@
 
 options_c::options_c()
   : m_show_progress(false)
+  , m_use_sidecar_index(false)
+  , m_num_scan_threads(1)
   , m_parse_mode(kax_analyzer_c::parse_mode_fast)
 {
 }
 
 void
 options_c::validate() {
-  if (m_file_name.empty())
+  // In batch mode the file names and possibly all changes come from
+  // the batch file.
+  if (!m_batch_file_name.empty()) {
+    if (!m_file_name.empty())
+      mxerror(boost::format(Y("A file name ('%1%') cannot be used together with '--batch'.\n")) % m_file_name);
+
+  } else if (m_file_name.empty())
     mxerror(Y("No file name given.\n"));
 
-  if (!has_changes())
+  else if (!has_changes())
     mxerror(Y("Nothing to do.\n"));
 
   for (auto &target : m_targets)
@@ -149,10 +157,16 @@ options_c::dump_info()
   mxinfo(boost::format("options:\n"
                        "  file_name:     %1%\n"
                        "  show_progress: %2%\n"
-                       "  parse_mode:    %3%\n")
+                       "  parse_mode:    %3%\n"
+                       "  sidecar_index: %4%\n"
+                       "  scan_threads:  %5%\n"
+                       "  batch:         %6%\n")
          % m_file_name
          % m_show_progress
-         % static_cast<int>(m_parse_mode));
+         % static_cast<int>(m_parse_mode)
+         % m_use_sidecar_index
+         % m_num_scan_threads
+         % m_batch_file_name);
 
   for (auto &target : m_targets)
     target->dump_info();
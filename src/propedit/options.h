@@ -21,9 +21,11 @@
 
 class options_c {
 public:
-  std::string m_file_name;
+  std::string m_file_name, m_batch_file_name;
+  std::vector<std::string> m_batch_common_arguments;
   std::vector<target_cptr> m_targets;
-  bool m_show_progress;
+  bool m_show_progress, m_use_sidecar_index;
+  unsigned int m_num_scan_threads;
   kax_analyzer_c::parse_mode_e m_parse_mode;
 
 public:
@@ -20,6 +20,7 @@
 #include "common/mm_io_x.h"
 #include "common/unique_numbers.h"
 #include "common/version.h"
+#include "propedit/batch.h"
 #include "propedit/propedit_cli_parser.h"
 
 static void
@@ -106,7 +107,7 @@ write_changes(options_cptr &options,
   }
 }
 
-static void
+static bool
 run(options_cptr &options) {
   console_kax_analyzer_cptr analyzer;
 
@@ -127,6 +128,8 @@ run(options_cptr &options) {
   try {
     ok = analyzer
       ->set_parse_mode(options->m_parse_mode)
+      .set_use_sidecar_index(options->m_use_sidecar_index)
+      .set_num_scan_threads(options->m_num_scan_threads)
       .set_open_mode(MODE_WRITE)
       .set_throw_on_error(true)
       .process();
@@ -148,17 +151,33 @@ run(options_cptr &options) {
 
   options->execute(*analyzer);
 
-  if (has_content_been_modified(options)) {
-    mxinfo(Y("The changes are written to the file.\n"));
+  if (!has_content_been_modified(options)) {
+    mxinfo(Y("No changes were made.\n"));
+    return false;
+  }
 
-    write_changes(options, analyzer.get());
+  mxinfo(Y("The changes are written to the file.\n"));
 
-    mxinfo(Y("Done.\n"));
+  write_changes(options, analyzer.get());
 
-  } else
-    mxinfo(Y("No changes were made.\n"));
+  mxinfo(Y("Done.\n"));
 
-  mxexit();
+  return true;
+}
+
+static bool
+run_batch_job(std::vector<std::string> const &arguments) {
+  auto options = propedit_cli_parser_c(arguments).run();
+
+  return run(options);
+}
+
+static int
+run_batch(options_cptr &options) {
+  batch_c batch{options->m_batch_common_arguments};
+  batch.read_jobs(options->m_batch_file_name);
+
+  return batch.run(run_batch_job);
 }
 
 static
@@ -185,6 +204,9 @@ main(int argc,
     options->dump_info();
   }
 
+  if (!options->m_batch_file_name.empty())
+    mxexit(run_batch(options));
+
   run(options);
 
   mxexit();
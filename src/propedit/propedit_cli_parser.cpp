@@ -35,6 +35,38 @@ propedit_cli_parser_c::set_parse_mode() {
   }
 }
 
+void
+propedit_cli_parser_c::set_use_sidecar_index() {
+  m_options->m_use_sidecar_index = true;
+}
+
+void
+propedit_cli_parser_c::set_num_scan_threads() {
+  if (!parse_number(m_next_arg, m_options->m_num_scan_threads) || (1 > m_options->m_num_scan_threads))
+    mxerror(boost::format(Y("Invalid number of threads in argument '%1%'.\n")) % m_next_arg);
+}
+
+void
+propedit_cli_parser_c::set_batch_file_name() {
+  m_options->m_batch_file_name = m_next_arg;
+}
+
+void
+propedit_cli_parser_c::set_batch_common_arguments() {
+  // All remaining arguments apart from the batch option itself apply
+  // to each file in the batch.
+  for (auto idx = 0u; idx < m_args.size(); ++idx) {
+    auto option_it = m_option_map.find(m_args[idx]);
+    auto num_args  = (m_option_map.end() != option_it) && option_it->second.m_needs_arg && ((idx + 1) < m_args.size()) ? 2u : 1u;
+
+    if (m_args[idx] != "--batch")
+      for (auto arg_idx = 0u; arg_idx < num_args; ++arg_idx)
+        m_options->m_batch_common_arguments.push_back(m_args[idx + arg_idx]);
+
+    idx += num_args - 1;
+  }
+}
+
 void
 propedit_cli_parser_c::add_target() {
   try {
@@ -208,6 +240,11 @@ propedit_cli_parser_c::init_parser() {
   add_section_header(YT("Options"));
   OPT("l|list-property-names",      list_property_names, YT("List all valid property names and exit"));
   OPT("p|parse-mode=<mode>",        set_parse_mode,      YT("Sets the Matroska parser mode to 'fast' (default) or 'full'"));
+  OPT("sidecar-index",              set_use_sidecar_index, YT("Reuses the list of elements stored in '<file>.mtxindex' by an earlier run "
+                                                              "if the file hasn't changed since; otherwise parses fully and creates that index"));
+  OPT("scan-threads=<n>",           set_num_scan_threads, YT("Scans the file for its elements on up to n threads in parallel when parsing fully (default: 1)"));
+  OPT("batch=<file>",               set_batch_file_name,  YT("Edits all files listed in 'file' instead of a single one. 'file' contains either one file name per line "
+                                                             "or a JSON array of file names and objects with additional per-file arguments (see man page)"));
 
   add_section_header(YT("Actions for handling properties"));
   OPT("e|edit=<selector>",          add_target,          YT("Sets the Matroska file section that all following add/set/delete "
@@ -283,6 +320,9 @@ propedit_cli_parser_c::run() {
   parse_args();
   validate();
 
+  if (!m_options->m_batch_file_name.empty())
+    set_batch_common_arguments();
+
   m_options->options_parsed();
   m_options->validate();
 
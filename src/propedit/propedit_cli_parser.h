@@ -37,6 +37,10 @@ protected:
   void add_tags();
   void add_chapters();
   void set_parse_mode();
+  void set_use_sidecar_index();
+  void set_num_scan_threads();
+  void set_batch_file_name();
+  void set_batch_common_arguments();
   void set_file_name();
 
   void set_attachment_name();
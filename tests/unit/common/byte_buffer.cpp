@@ -22,6 +22,29 @@ TEST(ByteBuffer, Add) {
   ASSERT_EQ(std::string{"Helloworld!"}, s);
 }
 
+TEST(ByteBuffer, Extract) {
+  byte_buffer_c b{16};
+
+  b.add(reinterpret_cast<unsigned char const *>("Hello world, bye"), 16);
+  auto buffer = b.get_buffer();
+  auto data   = b.extract(6);
+
+  EXPECT_EQ(buffer + 6, data->get_buffer());
+  EXPECT_TRUE(*data == "world, bye");
+  EXPECT_EQ(0u, b.get_size());
+
+  b.add(reinterpret_cast<unsigned char const *>("Hi"), 2);
+  data = b.extract();
+
+  EXPECT_TRUE(*data == "Hi");
+  EXPECT_EQ(0u, b.get_size());
+
+  b.add(reinterpret_cast<unsigned char const *>("again"), 5);
+
+  EXPECT_EQ(5u, b.get_size());
+  EXPECT_EQ(std::string{"again"}, std::string(reinterpret_cast<char *>(b.get_buffer()), b.get_size()));
+}
+
 TEST(ByteBuffer, Remove) {
   byte_buffer_c b;
 
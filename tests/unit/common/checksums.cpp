@@ -134,4 +134,28 @@ TEST_F(ChecksumTest, FileChunked1000) {
   EXPECT_EQ(*m_data_md5, *calculate_bin(mtx::checksum::algorithm_e::md5,                       1000));
 }
 
+TEST_F(ChecksumTest, CrcSameResultForAllLengthsAndAlignments) {
+  auto algorithms = std::vector<mtx::checksum::algorithm_e>{
+    mtx::checksum::algorithm_e::crc8_atm,
+    mtx::checksum::algorithm_e::crc16_ansi,
+    mtx::checksum::algorithm_e::crc16_ccitt,
+    mtx::checksum::algorithm_e::crc32_ieee,
+    mtx::checksum::algorithm_e::crc32_ieee_le,
+  };
+
+  auto ptr = m_data->get_buffer();
+
+  for (auto algorithm : algorithms)
+    for (auto offset = 0u; offset < 8; ++offset)
+      for (auto length = 0u; length < 300; ++length) {
+        // Adding single bytes always uses the byte-wise path.
+        auto bytewise = mtx::checksum::for_algorithm(algorithm, 0xffffffff);
+        for (auto idx = 0u; idx < length; ++idx)
+          bytewise->add(ptr + offset + idx, 1);
+
+        EXPECT_EQ(dynamic_cast<mtx::checksum::uint_result_c &>(*bytewise).get_result_as_uint(),
+                  mtx::checksum::calculate_as_uint(algorithm, ptr + offset, length, 0xffffffff));
+      }
+}
+
 }
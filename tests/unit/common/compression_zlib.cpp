@@ -0,0 +1,92 @@
+#include "common/common_pch.h"
+
+#include "gtest/gtest.h"
+
+#include "common/compression.h"
+#include "common/compression/zlib.h"
+
+namespace {
+
+// Roughly what a PGS object definition segment looks like: long runs
+// of transparent pixels with short runs of a few colors in between.
+memory_cptr
+create_pgs_like_packet(unsigned int seed,
+                       std::size_t size) {
+  auto packet = memory_c::alloc(size);
+  auto buffer = packet->get_buffer();
+
+  for (auto idx = 0u; idx < size; ++idx) {
+    seed        = seed * 1103515245 + 12345;
+    buffer[idx] = 0 == ((seed >> 16) % 8) ? (seed >> 24) % 4 : 0;
+  }
+
+  return packet;
+}
+
+memory_cptr
+compress_with_zlib(memory_cptr const &data) {
+  auto size = compressBound(data->get_size());
+  auto dst  = memory_c::alloc(size);
+
+  EXPECT_EQ(Z_OK, compress2(dst->get_buffer(), &size, data->get_buffer(), data->get_size(), 9));
+  dst->resize(size);
+
+  return dst;
+}
+
+class zlib_compressor_test_c: public zlib_compressor_c {
+public:
+  memory_cptr test_decompress(memory_cptr const &buffer) {
+    return do_decompress(buffer);
+  }
+  memory_cptr test_compress(memory_cptr const &buffer) {
+    return do_compress(buffer);
+  }
+};
+
+TEST(CompressionZlib, RoundTripReusingStreams) {
+  zlib_compressor_test_c compressor;
+
+  for (auto idx = 0u; idx < 20; ++idx) {
+    // Vary the sizes so that the output buffer has to grow and shrink.
+    auto data         = create_pgs_like_packet(idx, 0 == (idx % 3) ? 30 * 1024 : 1000 + idx * 37);
+    auto compressed   = compressor.test_compress(data);
+    auto decompressed = compressor.test_decompress(compressed);
+
+    EXPECT_LT(compressed->get_size(), data->get_size());
+    EXPECT_TRUE(*data == *decompressed);
+    EXPECT_TRUE(*data == *compressor.test_decompress(compress_with_zlib(data)));
+  }
+}
+
+TEST(CompressionZlib, EmptyPacket) {
+  zlib_compressor_test_c compressor;
+
+  auto empty = memory_c::alloc(0);
+
+  EXPECT_EQ(0u, compressor.test_decompress(compressor.test_compress(empty))->get_size());
+}
+
+TEST(CompressionZlib, HighCompressionRatio) {
+  zlib_compressor_test_c compressor;
+
+  auto data = memory_c::alloc(4 * 1024 * 1024);
+  std::memset(data->get_buffer(), 0, data->get_size());
+
+  EXPECT_TRUE(*data == *compressor.test_decompress(compress_with_zlib(data)));
+}
+
+TEST(CompressionZlib, CorruptDataThrows) {
+  zlib_compressor_test_c compressor;
+
+  auto data       = create_pgs_like_packet(42, 10000);
+  auto compressed = compress_with_zlib(data);
+
+  compressed->get_buffer()[0] ^= 0xff;
+  EXPECT_THROW(compressor.test_decompress(compressed), mtx::compression_x);
+
+  // The stream must be usable again after a failure.
+  EXPECT_TRUE(*data == *compressor.test_decompress(compress_with_zlib(data)));
+}
+
+}
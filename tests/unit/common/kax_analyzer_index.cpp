@@ -0,0 +1,110 @@
+#include "common/common_pch.h"
+
+#include "common/kax_analyzer_index.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class KaxAnalyzerIndex: public ::testing::Test {
+protected:
+  bfs::path m_file_name;
+  std::string m_content;
+  std::vector<kax_analyzer_index_c::entry_t> m_entries;
+
+  virtual void SetUp() {
+    m_file_name = bfs::temp_directory_path() / bfs::unique_path();
+    m_content   = std::string(3 * 1024 * 1024, 'x');
+    m_entries   = std::vector<kax_analyzer_index_c::entry_t>{
+      { 0x1549a966, 4, 52,   100,     true  },
+      { 0x1654ae6b, 4, 152,  200,     true  },
+      { 0x1f43b675, 4, 352,  3000000, false },
+    };
+
+    write_file(m_content);
+  }
+
+  virtual void TearDown() {
+    kax_analyzer_index_c{m_file_name.string()}.remove();
+    bfs::remove(m_file_name);
+  }
+
+  void write_file(std::string const &content) {
+    {
+      mm_file_io_c out{m_file_name.string(), MODE_CREATE};
+      out.write(content.c_str(), content.size());
+    }
+
+    // Whole seconds only so that the modification time can be restored
+    // exactly after modifying the file.
+    bfs::last_write_time(m_file_name, 1500000000);
+  }
+
+  void store() {
+    kax_analyzer_index_c index{m_file_name.string()};
+    index.set(40, m_entries);
+    ASSERT_TRUE(index.store());
+  }
+};
+
+TEST_F(KaxAnalyzerIndex, StoreAndLoad) {
+  kax_analyzer_index_c index{m_file_name.string()};
+
+  EXPECT_FALSE(index.load());
+
+  store();
+
+  ASSERT_TRUE(index.load());
+  EXPECT_EQ(40u, index.get_segment_pos());
+  ASSERT_EQ(3u, index.get_entries().size());
+
+  for (auto idx = 0u; idx < m_entries.size(); ++idx) {
+    EXPECT_EQ(m_entries[idx].m_id,         index.get_entries()[idx].m_id);
+    EXPECT_EQ(m_entries[idx].m_id_length,  index.get_entries()[idx].m_id_length);
+    EXPECT_EQ(m_entries[idx].m_pos,        index.get_entries()[idx].m_pos);
+    EXPECT_EQ(m_entries[idx].m_size,       index.get_entries()[idx].m_size);
+    EXPECT_EQ(m_entries[idx].m_size_known, index.get_entries()[idx].m_size_known);
+  }
+}
+
+TEST_F(KaxAnalyzerIndex, ChangedSizeIsRejected) {
+  store();
+
+  write_file(m_content + "y");
+  EXPECT_FALSE(kax_analyzer_index_c{m_file_name.string()}.load());
+}
+
+TEST_F(KaxAnalyzerIndex, ChangedHeadOrTailIsRejected) {
+  store();
+
+  auto content = m_content;
+  content[content.size() - 10] = 'y';
+  write_file(content);
+  EXPECT_FALSE(kax_analyzer_index_c{m_file_name.string()}.load());
+
+  store();
+  EXPECT_TRUE(kax_analyzer_index_c{m_file_name.string()}.load());
+
+  content[10] = 'y';
+  write_file(content);
+  EXPECT_FALSE(kax_analyzer_index_c{m_file_name.string()}.load());
+}
+
+TEST_F(KaxAnalyzerIndex, ChangedModificationTimeIsRejected) {
+  store();
+
+  bfs::last_write_time(m_file_name, 1500000001);
+  EXPECT_FALSE(kax_analyzer_index_c{m_file_name.string()}.load());
+}
+
+TEST_F(KaxAnalyzerIndex, DamagedIndexIsRejected) {
+  store();
+
+  mm_file_io_c out{kax_analyzer_index_c{m_file_name.string()}.get_index_file_name(), MODE_CREATE};
+  out.puts("{ \"version\": ");
+  out.close();
+
+  EXPECT_FALSE(kax_analyzer_index_c{m_file_name.string()}.load());
+}
+
+}
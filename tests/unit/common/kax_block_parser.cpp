@@ -0,0 +1,129 @@
+#include "common/common_pch.h"
+
+#include "common/kax_block_parser.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace mtx::kax;
+
+using bytes_t = std::vector<unsigned char>;
+
+TEST(KaxBlockParser, ReadRawElement) {
+  auto element = raw_element_t{};
+  auto cluster = bytes_t{ 0x1f, 0x43, 0xb6, 0x75, 0x83, 0xe7, 0x81, 0x05 };
+
+  ASSERT_TRUE(read_raw_element(cluster.data(), cluster.size(), element));
+  EXPECT_EQ(0x1f43b675u, element.m_id);
+  EXPECT_EQ(5u,          element.m_header_size);
+  EXPECT_EQ(3u,          element.m_data_size);
+
+  ASSERT_TRUE(read_raw_element(&cluster[5], 3, element));
+  EXPECT_EQ(0xe7u, element.m_id);
+  EXPECT_EQ(2u,    element.m_header_size);
+  EXPECT_EQ(5u,    read_raw_uint(&cluster[7], element.m_data_size));
+
+  auto two_byte_size = bytes_t{ 0xa3, 0x40, 0x02, 0x00, 0x00 };
+  ASSERT_TRUE(read_raw_element(two_byte_size.data(), two_byte_size.size(), element));
+  EXPECT_EQ(3u, element.m_header_size);
+  EXPECT_EQ(2u, element.m_data_size);
+}
+
+TEST(KaxBlockParser, ReadRawElementFailures) {
+  auto element = raw_element_t{};
+
+  auto unknown_size = bytes_t{ 0x1f, 0x43, 0xb6, 0x75, 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+  EXPECT_FALSE(read_raw_element(unknown_size.data(), unknown_size.size(), element));
+
+  auto too_large = bytes_t{ 0xa3, 0x85, 0x00, 0x00 };
+  EXPECT_FALSE(read_raw_element(too_large.data(), too_large.size(), element));
+  EXPECT_TRUE(read_raw_element_header(too_large.data(), too_large.size(), element));
+  EXPECT_EQ(5u, element.m_data_size);
+
+  auto invalid_id = bytes_t{ 0x00, 0x81, 0x00 };
+  EXPECT_FALSE(read_raw_element(invalid_id.data(), invalid_id.size(), element));
+
+  EXPECT_FALSE(read_raw_element(too_large.data(), 1, element));
+}
+
+TEST(KaxBlockParser, NoLacing) {
+  auto data  = bytes_t{ 0x82, 0xff, 0xfe, 0x81, 0x01, 0x02, 0x03 };
+  auto block = raw_block_t{};
+
+  ASSERT_TRUE(block.parse(data.data(), data.size()));
+  EXPECT_EQ(2u, block.m_track_number);
+  EXPECT_EQ(-2, block.m_relative_timecode);
+  EXPECT_TRUE(block.is_keyframe());
+  EXPECT_TRUE(block.is_discardable());
+  ASSERT_EQ(1u, block.m_frames.size());
+  EXPECT_EQ(4u, block.m_frames[0].m_offset);
+  EXPECT_EQ(3u, block.m_frames[0].m_size);
+}
+
+TEST(KaxBlockParser, XiphLacing) {
+  auto data = bytes_t{ 0x81, 0x00, 0x10, 0x02, 0x02, 0xff, 0x01, 0x02 };
+  data.resize(data.size() + 256 + 2 + 5);
+
+  auto block = raw_block_t{};
+
+  ASSERT_TRUE(block.parse(data.data(), data.size()));
+  EXPECT_EQ(16, block.m_relative_timecode);
+  EXPECT_FALSE(block.is_keyframe());
+  ASSERT_EQ(3u,   block.m_frames.size());
+  EXPECT_EQ(8u,   block.m_frames[0].m_offset);
+  EXPECT_EQ(256u, block.m_frames[0].m_size);
+  EXPECT_EQ(264u, block.m_frames[1].m_offset);
+  EXPECT_EQ(2u,   block.m_frames[1].m_size);
+  EXPECT_EQ(266u, block.m_frames[2].m_offset);
+  EXPECT_EQ(5u,   block.m_frames[2].m_size);
+}
+
+TEST(KaxBlockParser, FixedLacing) {
+  auto data = bytes_t{ 0x81, 0x00, 0x00, 0x04, 0x02 };
+  data.resize(data.size() + 3 * 7);
+
+  auto block = raw_block_t{};
+
+  ASSERT_TRUE(block.parse(data.data(), data.size()));
+  ASSERT_EQ(3u, block.m_frames.size());
+
+  for (auto idx = 0u; idx < 3; ++idx) {
+    EXPECT_EQ(5u + idx * 7, block.m_frames[idx].m_offset);
+    EXPECT_EQ(7u,           block.m_frames[idx].m_size);
+  }
+}
+
+TEST(KaxBlockParser, EBMLLacing) {
+  // Sizes 10, 8 (one byte difference -2) and 12 (two byte difference
+  // +4); the last frame takes the remaining 20 bytes.
+  auto data = bytes_t{ 0x81, 0x00, 0x00, 0x06, 0x03, 0x8a, 0xbd, 0x60, 0x03 };
+  auto header_size = data.size();
+  data.resize(header_size + 10 + 8 + 12 + 20);
+
+  auto block = raw_block_t{};
+
+  ASSERT_TRUE(block.parse(data.data(), data.size()));
+  ASSERT_EQ(4u, block.m_frames.size());
+  EXPECT_EQ(10u, block.m_frames[0].m_size);
+  EXPECT_EQ(8u,  block.m_frames[1].m_size);
+  EXPECT_EQ(12u, block.m_frames[2].m_size);
+  EXPECT_EQ(20u, block.m_frames[3].m_size);
+  EXPECT_EQ(header_size,           block.m_frames[0].m_offset);
+  EXPECT_EQ(header_size + 10 + 8,  block.m_frames[2].m_offset);
+}
+
+TEST(KaxBlockParser, InvalidLacing) {
+  auto block = raw_block_t{};
+
+  auto xiph_overflow = bytes_t{ 0x81, 0x00, 0x00, 0x02, 0x01, 0x20, 0x00 };
+  EXPECT_FALSE(block.parse(xiph_overflow.data(), xiph_overflow.size()));
+
+  auto truncated_header = bytes_t{ 0x81, 0x00 };
+  EXPECT_FALSE(block.parse(truncated_header.data(), truncated_header.size()));
+
+  auto missing_lace_count = bytes_t{ 0x81, 0x00, 0x00, 0x02 };
+  EXPECT_FALSE(block.parse(missing_lace_count.data(), missing_lace_count.size()));
+}
+
+}
@@ -0,0 +1,160 @@
+#include "common/common_pch.h"
+
+#include "common/endian.h"
+#include "common/kax_level1_scanner.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+uint32_t const s_cluster_id = 0x1f43b675, s_info_id = 0x1549a966, s_cues_id = 0x1c53bb6b;
+
+std::string
+element_header(uint32_t id,
+               uint64_t payload_size) {
+  unsigned char buffer[12];
+
+  put_uint32_be(&buffer[0], id);
+  put_uint64_be(&buffer[4], payload_size);
+  buffer[4] = 0x01;
+
+  return std::string{reinterpret_cast<char *>(buffer), 12};
+}
+
+class KaxLevel1Scanner: public ::testing::Test {
+protected:
+  bfs::path m_file_name;
+  std::string m_content;
+  unsigned int m_num_sequential_scans{};
+
+  virtual void SetUp() {
+    m_file_name = bfs::temp_directory_path() / bfs::unique_path();
+  }
+
+  virtual void TearDown() {
+    bfs::remove(m_file_name);
+  }
+
+  void add_element(uint32_t id,
+                   uint64_t payload_size,
+                   std::string const &payload_start = std::string{}) {
+    m_content += element_header(id, payload_size);
+    m_content += payload_start;
+    m_content += std::string(payload_size - payload_start.size(), static_cast<char>(m_content.size() & 0xff));
+  }
+
+  // Payloads containing the cluster ID that isn't followed by a
+  // plausible size.
+  std::string fake_cluster_id() {
+    return element_header(s_cluster_id, 0).substr(0, 4) + "garbage";
+  }
+
+  void write_file() {
+    mm_file_io_c out{m_file_name.string(), MODE_CREATE};
+    out.write(m_content.c_str(), m_content.size());
+  }
+
+  kax_level1_scanner_c create_scanner() {
+    return kax_level1_scanner_c{m_file_name.string(), 0, m_content.size(), { s_cluster_id, s_info_id, s_cues_id }, s_cluster_id};
+  }
+
+  std::vector<kax_level1_scanner_c::entry_t> scan(unsigned int num_threads) {
+    auto scanner = create_scanner();
+
+    return scanner.scan(num_threads, [this, &scanner](uint64_t start, uint64_t end) {
+      ++m_num_sequential_scans;
+      return scanner.scan_range(start, end, false);
+    });
+  }
+
+  void expect_same_entries(std::vector<kax_level1_scanner_c::entry_t> const &expected,
+                           std::vector<kax_level1_scanner_c::entry_t> const &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+
+    for (auto idx = 0u; idx < expected.size(); ++idx) {
+      EXPECT_EQ(expected[idx].m_id,   actual[idx].m_id);
+      EXPECT_EQ(expected[idx].m_pos,  actual[idx].m_pos);
+      EXPECT_EQ(expected[idx].m_size, actual[idx].m_size);
+    }
+  }
+};
+
+TEST_F(KaxLevel1Scanner, SameResultAsSequentialScan) {
+  add_element(s_info_id, 1000);
+
+  for (auto idx = 0u; m_content.size() < 100 * 1024 * 1024; ++idx)
+    add_element(s_cluster_id, 10000 + (idx * 7919) % (1024 * 1024), fake_cluster_id());
+
+  add_element(s_cues_id, 5000);
+  write_file();
+
+  auto expected = create_scanner().scan_range(0, m_content.size(), false);
+  ASSERT_TRUE(expected.m_complete);
+  EXPECT_EQ(m_content.size(), expected.m_stop_pos);
+
+  expect_same_entries(expected.m_entries, scan(4));
+
+  // Only the last range, which contains the cues but no cluster, must
+  // be scanned sequentially.
+  EXPECT_GE(1u, m_num_sequential_scans);
+}
+
+TEST_F(KaxLevel1Scanner, FalseResyncIsDetected) {
+  // Two ranges with a boundary at 20 MiB. The cluster straddling it
+  // contains something looking like a cluster header right after the
+  // boundary whose size ends where the next real cluster starts.
+  uint64_t const boundary = 20 * 1024 * 1024, fake_pos = boundary + 1000, real_cluster_end = boundary + 2 * 1024 * 1024;
+
+  add_element(s_info_id, 1000);
+  while (m_content.size() < (boundary - 3 * 1024 * 1024))
+    add_element(s_cluster_id, 100000);
+
+  auto straddling_start = m_content.size();
+  add_element(s_cluster_id, real_cluster_end - straddling_start - 12);
+
+  auto fake = element_header(s_cluster_id, real_cluster_end - fake_pos - 12);
+  m_content.replace(fake_pos, fake.size(), fake);
+
+  while (m_content.size() < (2 * boundary - 200000))
+    add_element(s_cluster_id, 100000);
+
+  add_element(s_cluster_id, 2 * boundary - m_content.size() - 12);
+  write_file();
+
+  auto expected = create_scanner().scan_range(0, m_content.size(), false);
+  ASSERT_TRUE(expected.m_complete);
+  ASSERT_EQ(2 * boundary, m_content.size());
+
+  m_num_sequential_scans = 0;
+  auto actual            = scan(2);
+
+  expect_same_entries(expected.m_entries, actual);
+  EXPECT_LE(1u, m_num_sequential_scans);
+}
+
+TEST_F(KaxLevel1Scanner, DamagedRangeIsScannedSequentially) {
+  add_element(s_info_id, 1000);
+
+  while (m_content.size() < 50 * 1024 * 1024)
+    add_element(s_cluster_id, 200000);
+
+  write_file();
+
+  auto expected = create_scanner().scan_range(0, m_content.size(), false);
+  ASSERT_TRUE(expected.m_complete);
+
+  // Damage the first element starting after 30 MiB. Both the parallel
+  // and the sequential walk stop there.
+  auto damaged = std::find_if(expected.m_entries.begin(), expected.m_entries.end(), [](kax_level1_scanner_c::entry_t const &entry) { return entry.m_pos > 30 * 1024 * 1024; });
+  ASSERT_TRUE(damaged != expected.m_entries.end());
+
+  m_content[damaged->m_pos] = 0;
+  write_file();
+
+  auto actual = scan(4);
+
+  expect_same_entries(std::vector<kax_level1_scanner_c::entry_t>(expected.m_entries.begin(), damaged), actual);
+  EXPECT_LE(1u, m_num_sequential_scans);
+}
+
+}
@@ -30,4 +30,50 @@ TEST(Memory, OperatorNotEq) {
   EXPECT_TRUE(*m1 != "world");
 }
 
+TEST(Memory, BorrowKeepsOwnerAlive) {
+  auto owner    = std::make_shared<std::string>("Hello world");
+  auto borrowed = memory_c::borrow(owner, &(*owner)[6], 5);
+  std::weak_ptr<std::string> weak_owner = owner;
+
+  owner.reset();
+
+  EXPECT_FALSE(weak_owner.expired());
+  EXPECT_TRUE(borrowed->keeps_buffer_alive());
+  EXPECT_FALSE(borrowed->is_free());
+  EXPECT_TRUE(*borrowed == "world");
+
+  borrowed.reset();
+
+  EXPECT_TRUE(weak_owner.expired());
+}
+
+TEST(Memory, GrabOnlyCopiesUnownedBuffers) {
+  auto owner    = std::make_shared<std::string>("Hello world");
+  auto borrowed = memory_c::borrow(owner, &(*owner)[0], owner->size());
+  auto pointing = memory_c::point_to(*owner);
+
+  borrowed->grab();
+  pointing->grab();
+
+  EXPECT_EQ(reinterpret_cast<unsigned char *>(&(*owner)[0]), borrowed->get_buffer());
+  EXPECT_NE(reinterpret_cast<unsigned char *>(&(*owner)[0]), pointing->get_buffer());
+  EXPECT_TRUE(pointing->is_free());
+  EXPECT_TRUE(*pointing == "Hello world");
+}
+
+TEST(Memory, ResizingBorrowedBufferReleasesOwner) {
+  auto owner    = std::make_shared<std::string>("Hello world");
+  auto borrowed = memory_c::borrow(owner, &(*owner)[0], owner->size());
+  std::weak_ptr<std::string> weak_owner = owner;
+
+  owner.reset();
+  borrowed->set_offset(6);
+  borrowed->resize(7);
+  std::memcpy(borrowed->get_buffer() + 5, "!!", 2);
+
+  EXPECT_TRUE(weak_owner.expired());
+  EXPECT_TRUE(borrowed->is_free());
+  EXPECT_TRUE(*borrowed == "world!!");
+}
+
 }
@@ -0,0 +1,84 @@
+#include "common/common_pch.h"
+
+#include "common/memory.h"
+#include "common/memory_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class MemoryPool: public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    mtx::mem::pool::enable(true);
+  }
+
+  virtual void TearDown() {
+    mtx::mem::pool::enable(false);
+  }
+};
+
+TEST_F(MemoryPool, BuffersAreRecycled) {
+  auto m1     = memory_c::alloc(1000);
+  auto buffer = m1->get_buffer();
+  m1.reset();
+
+  auto m2 = memory_c::alloc(1020);
+  EXPECT_EQ(buffer,  m2->get_buffer());
+  EXPECT_EQ(1020u,   m2->get_size());
+  EXPECT_TRUE(m2->is_free());
+}
+
+TEST_F(MemoryPool, ResizingWithinSizeClass) {
+  auto m1     = memory_c::clone("hello", 5);
+  auto buffer = m1->get_buffer();
+
+  m1->resize(64);
+  EXPECT_EQ(buffer, m1->get_buffer());
+  EXPECT_EQ(64u,    m1->get_size());
+
+  m1->add(reinterpret_cast<unsigned char const *>("world"), 5);
+  EXPECT_EQ(69u, m1->get_size());
+  EXPECT_EQ(0, std::memcmp(m1->get_buffer(), "hello", 5));
+  EXPECT_EQ(0, std::memcmp(m1->get_buffer() + 64, "world", 5));
+}
+
+TEST_F(MemoryPool, TakingOverBuffers) {
+  auto m1 = memory_c::alloc(100);
+  m1->lock();
+
+  auto buffer = m1->get_buffer();
+  m1.reset();
+
+  // The buffer is owned by us now.
+  auto m2 = memory_c::alloc(100);
+  EXPECT_NE(buffer, m2->get_buffer());
+  free(buffer);
+}
+
+TEST_F(MemoryPool, LargeBuffersAreNotPooled) {
+  auto m1 = memory_c::alloc(16 * 1024 * 1024);
+  m1->get_buffer()[16 * 1024 * 1024 - 1] = 42;
+  m1->resize(17 * 1024 * 1024);
+  EXPECT_EQ(42, m1->get_buffer()[16 * 1024 * 1024 - 1]);
+}
+
+TEST_F(MemoryPool, Objects) {
+  struct object_t {
+    int64_t m_value;
+  };
+
+  using pool_t = mtx::mem::object_pool_c<object_t>;
+
+  auto o1 = pool_t::allocate(sizeof(object_t));
+  pool_t::release(o1, sizeof(object_t));
+  EXPECT_EQ(o1, pool_t::allocate(sizeof(object_t)));
+  pool_t::release(o1, sizeof(object_t));
+
+  mtx::mem::pool::enable(false);
+
+  auto o2 = pool_t::allocate(sizeof(object_t));
+  pool_t::release(o2, sizeof(object_t));
+}
+
+}
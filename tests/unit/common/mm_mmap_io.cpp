@@ -0,0 +1,94 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_mmap_io.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class MmMmapIo: public ::testing::Test {
+protected:
+  std::string m_file_name;
+  memory_cptr m_data;
+
+  virtual void SetUp() {
+    m_file_name = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    m_data      = memory_c::alloc(10000);
+
+    for (auto idx = 0u; idx < m_data->get_size(); ++idx)
+      m_data->get_buffer()[idx] = (idx * 13) & 0xff;
+
+    mm_file_io_c out{m_file_name, MODE_CREATE};
+    out.write(m_data);
+  }
+
+  virtual void TearDown() {
+    boost::filesystem::remove(m_file_name);
+  }
+};
+
+TEST_F(MmMmapIo, Reading) {
+  mm_mmap_io_c in{m_file_name};
+  auto out = memory_c::alloc(m_data->get_size());
+
+  EXPECT_EQ(10000, in.get_size());
+  EXPECT_EQ(1000u, in.read(out->get_buffer(), 1000));
+  EXPECT_EQ(9000u, in.read(out->get_buffer() + 1000, 20000));
+  EXPECT_TRUE(in.eof());
+  EXPECT_EQ(*m_data, *out);
+}
+
+TEST_F(MmMmapIo, Seeking) {
+  mm_mmap_io_c in{m_file_name};
+
+  in.setFilePointer(4711);
+  EXPECT_EQ(4711u, in.getFilePointer());
+  EXPECT_EQ(m_data->get_buffer()[4711], in.read_uint8());
+
+  in.setFilePointer(-10, seek_end);
+  EXPECT_EQ(9990u, in.getFilePointer());
+
+  in.setFilePointer(-90, seek_current);
+  EXPECT_EQ(9900u, in.getFilePointer());
+
+  in.setFilePointer(20000);
+  EXPECT_EQ(10000u, in.getFilePointer());
+
+  EXPECT_THROW(in.setFilePointer(-1), mtx::mm_io::seek_x);
+}
+
+TEST_F(MmMmapIo, MemoryReadsAndViews) {
+  mm_mmap_io_c in{m_file_name};
+
+  in.setFilePointer(100);
+  auto copy = in.read(50);
+  EXPECT_EQ(150u, in.getFilePointer());
+  EXPECT_TRUE(copy->is_free());
+  EXPECT_EQ(0, std::memcmp(copy->get_buffer(), m_data->get_buffer() + 100, 50));
+
+  auto view = in.read_view(50);
+  EXPECT_EQ(200u, in.getFilePointer());
+  EXPECT_FALSE(view->is_free());
+  EXPECT_EQ(0, std::memcmp(view->get_buffer(), m_data->get_buffer() + 150, 50));
+
+  EXPECT_EQ(in.get_view(150, 50)->get_buffer(), view->get_buffer());
+
+  EXPECT_THROW(in.get_view(9990, 11), mtx::mm_io::end_of_file_x);
+  in.setFilePointer(9990);
+  EXPECT_THROW(in.read(11), mtx::mm_io::end_of_file_x);
+}
+
+TEST_F(MmMmapIo, WritingFails) {
+  mm_mmap_io_c in{m_file_name};
+
+  EXPECT_THROW(in.write(m_data), mtx::mm_io::wrong_read_write_access_x);
+}
+
+TEST_F(MmMmapIo, EmptyFilesAreRejected) {
+  mm_file_io_c{m_file_name, MODE_CREATE};
+
+  EXPECT_THROW(mm_mmap_io_c{m_file_name}, mtx::mm_io::open_x);
+}
+
+}
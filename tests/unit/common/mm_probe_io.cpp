@@ -0,0 +1,127 @@
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include "common/mm_io_x.h"
+#include "common/mm_probe_io.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class counting_io_c: public mm_proxy_io_c {
+public:
+  std::size_t m_num_bytes_read{};
+
+  counting_io_c(mm_io_c *in)
+    : mm_proxy_io_c{in}
+  {
+  }
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size) {
+    auto num_read     = mm_proxy_io_c::_read(buffer, size);
+    m_num_bytes_read += num_read;
+    return num_read;
+  }
+};
+
+class MmProbeIo: public ::testing::Test {
+protected:
+  memory_cptr m_data;
+  std::shared_ptr<counting_io_c> m_source;
+
+  virtual void SetUp() {
+    m_data = memory_c::alloc(1000000);
+
+    for (auto idx = 0u; idx < m_data->get_size(); ++idx)
+      m_data->get_buffer()[idx] = (idx * 13 + idx / 7) & 0xff;
+
+    m_source = std::make_shared<counting_io_c>(new mm_mem_io_c{*m_data});
+  }
+};
+
+TEST_F(MmProbeIo, ReadingWithinWindowHitsSourceOnce) {
+  auto window = std::make_shared<mm_probe_io_c::window_c>(m_source, 200000);
+  auto out    = memory_c::alloc(150000);
+
+  for (auto idx = 0; idx < 5; ++idx) {
+    mm_probe_io_c in{window};
+
+    EXPECT_EQ(1000000, in.get_size());
+    EXPECT_EQ(150000u, in.read(out->get_buffer(), 150000));
+    EXPECT_EQ(0, std::memcmp(out->get_buffer(), m_data->get_buffer(), 150000));
+  }
+
+  EXPECT_LE(m_source->m_num_bytes_read, 200000u);
+}
+
+TEST_F(MmProbeIo, ReadingAcrossWindowEnd) {
+  auto window = std::make_shared<mm_probe_io_c::window_c>(m_source, 1000);
+  mm_probe_io_c in{window};
+  auto out = memory_c::alloc(m_data->get_size());
+
+  in.setFilePointer(900);
+  EXPECT_EQ(2000u, in.read(out->get_buffer(), 2000));
+  EXPECT_EQ(0, std::memcmp(out->get_buffer(), m_data->get_buffer() + 900, 2000));
+
+  in.setFilePointer(-100, seek_end);
+  EXPECT_EQ(100u, in.read(out->get_buffer(), 2000));
+  EXPECT_TRUE(in.eof());
+  EXPECT_EQ(0, std::memcmp(out->get_buffer(), m_data->get_buffer() + 999900, 100));
+}
+
+TEST_F(MmProbeIo, Seeking) {
+  auto window = std::make_shared<mm_probe_io_c::window_c>(m_source, 1000);
+  mm_probe_io_c in{window};
+
+  in.setFilePointer(4711);
+  EXPECT_EQ(4711u, in.getFilePointer());
+  EXPECT_EQ(m_data->get_buffer()[4711], in.read_uint8());
+
+  in.setFilePointer(-90, seek_current);
+  EXPECT_EQ(4622u, in.getFilePointer());
+
+  in.setFilePointer(2000000);
+  EXPECT_EQ(1000000u, in.getFilePointer());
+
+  EXPECT_THROW(in.setFilePointer(-1), mtx::mm_io::seek_x);
+}
+
+TEST_F(MmProbeIo, WindowLargerThanFile) {
+  auto window = std::make_shared<mm_probe_io_c::window_c>(m_source, 4000000);
+  mm_probe_io_c in{window};
+  auto out = memory_c::alloc(m_data->get_size());
+
+  EXPECT_EQ(1000000u, in.read(out->get_buffer(), 2000000));
+  EXPECT_EQ(*m_data, *out);
+}
+
+TEST_F(MmProbeIo, SharedBetweenThreads) {
+  auto window  = std::make_shared<mm_probe_io_c::window_c>(m_source, 500000);
+  auto threads = std::vector<std::thread>{};
+  auto ok      = std::vector<int>(8, 0);
+
+  for (auto thread_idx = 0u; thread_idx < ok.size(); ++thread_idx)
+    threads.emplace_back([this, &window, &ok, thread_idx]() {
+      mm_probe_io_c in{window};
+      auto out = memory_c::alloc(4096);
+      auto all = true;
+
+      for (auto pos = thread_idx * 1000u; pos < 800000; pos += 37 * 1024) {
+        in.setFilePointer(pos);
+        auto num_read = in.read(out->get_buffer(), 4096);
+        all           = all && (4096 == num_read) && !std::memcmp(out->get_buffer(), m_data->get_buffer() + pos, 4096);
+      }
+
+      ok[thread_idx] = all ? 1 : 0;
+    });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (auto value : ok)
+    EXPECT_EQ(1, value);
+}
+
+}
@@ -0,0 +1,68 @@
+#include "common/common_pch.h"
+
+#include "common/mm_read_ahead_io.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/util.h"
+
+namespace {
+
+TEST(MmReadAheadIo, SequentialReading) {
+  auto data = memory_c::clone(mtxut::create_test_data(100000));
+  mm_read_ahead_io_c in{new mm_mem_io_c{*data}, 1000, 4};
+  auto out  = memory_c::alloc(data->get_size());
+
+  EXPECT_EQ(100000, in.get_size());
+  EXPECT_EQ(0u,     in.getFilePointer());
+
+  EXPECT_EQ(1u,     in.read(out->get_buffer(), 1));
+  EXPECT_EQ(2999u,  in.read(out->get_buffer() + 1, 2999));
+  EXPECT_EQ(97000u, in.read(out->get_buffer() + 3000, 100000));
+  EXPECT_EQ(100000u, in.getFilePointer());
+  EXPECT_TRUE(in.eof());
+
+  EXPECT_EQ(*data, *out);
+}
+
+TEST(MmReadAheadIo, Seeking) {
+  auto data = memory_c::clone(mtxut::create_test_data(100000));
+  mm_read_ahead_io_c in{new mm_mem_io_c{*data}, 1000, 4};
+  auto buf  = std::string{};
+
+  // Forward within the queued data
+  in.setFilePointer(1500);
+  EXPECT_EQ(1500u, in.getFilePointer());
+  EXPECT_EQ(10u,   in.read(buf, 10));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 1500, 10), buf);
+
+  // Far forward
+  in.setFilePointer(77777);
+  EXPECT_EQ(5000u, in.read(buf, 5000));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 77777, 5000), buf);
+
+  // Backwards
+  in.setFilePointer(-100, seek_current);
+  EXPECT_EQ(82677u, in.getFilePointer());
+  EXPECT_EQ(100u,   in.read(buf, 100));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 82677, 100), buf);
+
+  // Backwards into the block read before
+  in.setFilePointer(81900);
+  EXPECT_EQ(81900u, in.getFilePointer());
+  EXPECT_EQ(300u,   in.read(buf, 300));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 81900, 300), buf);
+
+  // Relative to the end
+  in.setFilePointer(-10, seek_end);
+  EXPECT_EQ(10u, in.read(buf, 20));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 99990, 10), buf);
+  EXPECT_TRUE(in.eof());
+
+  // Start over
+  in.setFilePointer(0);
+  EXPECT_FALSE(in.eof());
+  EXPECT_EQ(0x00, in.read_uint8());
+  EXPECT_EQ(0x07, in.read_uint8());
+}
+
+}
@@ -0,0 +1,97 @@
+#include "common/common_pch.h"
+
+#include "common/mm_read_buffer_io.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/util.h"
+
+namespace {
+
+class test_read_buffer_io_c: public mm_read_buffer_io_c {
+public:
+  test_read_buffer_io_c(mm_io_c *in, size_t buffer_size)
+    : mm_read_buffer_io_c{in, buffer_size}
+  {
+  }
+
+  statistics_t const &get_statistics() const {
+    return m_statistics;
+  }
+
+  size_t get_buffer_size() const {
+    return m_size;
+  }
+};
+
+TEST(MmReadBufferIo, SmallReads) {
+  auto data = memory_c::clone(mtxut::create_test_data(10000));
+  test_read_buffer_io_c in{new mm_mem_io_c{*data}, 1000};
+  auto out  = memory_c::alloc(data->get_size());
+
+  for (auto idx = 0u; idx < 100; ++idx)
+    EXPECT_EQ(100u, in.read(out->get_buffer() + idx * 100, 100));
+
+  EXPECT_EQ(*data, *out);
+  EXPECT_EQ(0u,    in.read(out->get_buffer(), 1));
+  EXPECT_TRUE(in.eof());
+
+  auto &stats = in.get_statistics();
+  EXPECT_EQ(0u,     stats.m_num_bypasses);
+  EXPECT_EQ(10000u, stats.m_bytes_copied);
+  EXPECT_EQ(10000u, stats.m_bytes_refilled);
+}
+
+TEST(MmReadBufferIo, LargeReadsBypassTheBuffer) {
+  auto data = memory_c::clone(mtxut::create_test_data(10000));
+  test_read_buffer_io_c in{new mm_mem_io_c{*data}, 1000};
+  auto out  = memory_c::alloc(data->get_size());
+
+  EXPECT_EQ(10u,   in.read(out->get_buffer(), 10));
+  EXPECT_EQ(5000u, in.read(out->get_buffer() + 10, 5000));
+  EXPECT_EQ(5010u, in.getFilePointer());
+  EXPECT_EQ(4990u, in.read(out->get_buffer() + 5010, 8000));
+  EXPECT_TRUE(in.eof());
+
+  EXPECT_EQ(*data, *out);
+
+  auto &stats = in.get_statistics();
+  EXPECT_EQ(1u,    stats.m_num_refills);
+  EXPECT_EQ(2u,    stats.m_num_bypasses);
+  EXPECT_EQ(1000u, stats.m_bytes_copied);
+  EXPECT_EQ(9000u, stats.m_bytes_bypassed);
+}
+
+TEST(MmReadBufferIo, BufferSizeAdaptsToAccessPattern) {
+  auto data = memory_c::clone(mtxut::create_test_data(100000));
+  test_read_buffer_io_c in{new mm_mem_io_c{*data}, 1000};
+  auto buf  = std::string{};
+
+  for (auto idx = 0u; idx < 100; ++idx)
+    in.read(buf, 200);
+
+  EXPECT_LT(1000u, in.get_buffer_size());
+
+  in.setFilePointer(90000);
+  EXPECT_EQ(1000u, in.get_buffer_size());
+
+  EXPECT_EQ(10u, in.read(buf, 10));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 90000, 10), buf);
+}
+
+TEST(MmReadBufferIo, SeekingWithinTheBuffer) {
+  auto data = memory_c::clone(mtxut::create_test_data(10000));
+  test_read_buffer_io_c in{new mm_mem_io_c{*data}, 1000};
+  auto buf  = std::string{};
+
+  EXPECT_EQ(10u, in.read(buf, 10));
+  in.setFilePointer(500);
+  EXPECT_EQ(10u, in.read(buf, 10));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data->get_buffer()) + 500, 10), buf);
+
+  auto &stats = in.get_statistics();
+  EXPECT_EQ(1u, stats.m_num_refills);
+  EXPECT_EQ(1u, stats.m_num_hits);
+  EXPECT_EQ(0u, stats.m_num_seeks);
+}
+
+}
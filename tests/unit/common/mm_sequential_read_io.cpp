@@ -0,0 +1,98 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_sequential_read_io.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/util.h"
+
+namespace {
+
+class MmSequentialReadIo: public ::testing::Test {
+protected:
+  std::string m_data;
+  std::unique_ptr<mm_sequential_read_io_c> m_in;
+
+  virtual void SetUp() override {
+    m_data = mtxut::create_test_data(8 * 1024 * 1024);
+    m_in   = std::make_unique<mm_sequential_read_io_c>(new mm_mem_io_c{reinterpret_cast<unsigned char const *>(m_data.c_str()), m_data.size()}, 256 * 1024);
+  }
+
+  std::string read(std::size_t size) {
+    auto buffer   = std::string(size, '\0');
+    auto num_read = m_in->read(&buffer[0], size);
+    buffer.resize(num_read);
+
+    return buffer;
+  }
+};
+
+TEST_F(MmSequentialReadIo, ProbingLimitedToWindow) {
+  EXPECT_EQ(256 * 1024, m_in->get_size());
+
+  EXPECT_EQ(m_data.substr(0, 1000), read(1000));
+
+  m_in->setFilePointer(200 * 1024);
+  EXPECT_EQ(m_data.substr(200 * 1024, 56 * 1024), read(100 * 1024));
+  EXPECT_TRUE(m_in->eof());
+
+  m_in->setFilePointer(0);
+  EXPECT_FALSE(m_in->eof());
+  EXPECT_EQ(m_data.substr(0, 256 * 1024), read(256 * 1024));
+}
+
+TEST_F(MmSequentialReadIo, StreamingAfterProbing) {
+  EXPECT_EQ(m_data.substr(0, 100 * 1024), read(100 * 1024));
+
+  m_in->enable_streaming();
+  EXPECT_EQ(mm_sequential_read_io_c::ms_unknown_size, m_in->get_size());
+
+  // Headers are parsed beyond the probed range, then the reader starts
+  // from the beginning.
+  EXPECT_EQ(m_data.substr(100 * 1024, 150 * 1024), read(150 * 1024));
+  m_in->setFilePointer(0);
+
+  auto content = std::string{};
+  while (true) {
+    auto chunk = read(100 * 1000);
+    if (chunk.empty())
+      break;
+    content += chunk;
+  }
+
+  EXPECT_TRUE(m_in->eof());
+  EXPECT_EQ(m_data, content);
+  EXPECT_EQ(static_cast<int64_t>(m_data.size()), m_in->get_size());
+}
+
+TEST_F(MmSequentialReadIo, SeekingBackwards) {
+  m_in->enable_streaming();
+  m_in->setFilePointer(3 * 1024 * 1024);
+
+  EXPECT_EQ(m_data.substr(3 * 1024 * 1024, 1000), read(1000));
+
+  // Short seeks backwards are possible.
+  m_in->setFilePointer(-100 * 1024, seek_current);
+  EXPECT_EQ(m_data.substr(3 * 1024 * 1024 + 1000 - 100 * 1024, 1000), read(1000));
+
+  // Once more data has been read, the window and everything else far
+  // behind the current position are gone.
+  read(2 * 1024 * 1024);
+
+  EXPECT_THROW(m_in->setFilePointer(0),                mtx::mm_io::seek_x);
+  EXPECT_THROW(m_in->setFilePointer(1024 * 1024),      mtx::mm_io::seek_x);
+  EXPECT_THROW(m_in->setFilePointer(-10, seek_end),    mtx::mm_io::seek_x);
+  EXPECT_THROW(m_in->setFilePointer(-1),               mtx::mm_io::seek_x);
+}
+
+TEST_F(MmSequentialReadIo, SkippingForward) {
+  m_in->enable_streaming();
+
+  EXPECT_EQ(m_data.substr(0, 10), read(10));
+
+  m_in->setFilePointer(7 * 1024 * 1024);
+  EXPECT_EQ(m_data.substr(7 * 1024 * 1024, 1024 * 1024), read(2 * 1024 * 1024));
+  EXPECT_TRUE(m_in->eof());
+}
+
+}
@@ -0,0 +1,67 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_sequential_write_io.h"
+#include "common/mm_write_buffer_io.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(MmSequentialWriteIo, TracksPosition) {
+  auto mem = new mm_mem_io_c{nullptr, 0, 1024};
+  mm_sequential_write_io_c out{mem, false};
+
+  EXPECT_EQ(0u, out.getFilePointer());
+
+  out.write(std::string(1000, 'a'));
+  out.write(std::string(24,   'b'));
+
+  EXPECT_EQ(1024u, out.getFilePointer());
+  EXPECT_EQ(1024u, out.get_size());
+
+  out.close();
+  delete mem;
+}
+
+TEST(MmSequentialWriteIo, SeekingToCurrentPositionOnly) {
+  auto mem = new mm_mem_io_c{nullptr, 0, 1024};
+  mm_sequential_write_io_c out{mem, false};
+
+  out.write(std::string(100, 'a'));
+
+  EXPECT_NO_THROW(out.setFilePointer(100));
+  EXPECT_NO_THROW(out.setFilePointer(0, seek_current));
+  EXPECT_NO_THROW(out.setFilePointer(0, seek_end));
+
+  EXPECT_THROW(out.setFilePointer(0),                mtx::mm_io::seek_x);
+  EXPECT_THROW(out.setFilePointer(-10, seek_current), mtx::mm_io::seek_x);
+  EXPECT_THROW(out.setFilePointer(-10, seek_end),     mtx::mm_io::seek_x);
+  EXPECT_THROW(out.setFilePointer(200),              mtx::mm_io::seek_x);
+
+  EXPECT_EQ(100u, out.getFilePointer());
+
+  out.close();
+  delete mem;
+}
+
+TEST(MmSequentialWriteIo, BehindWriteBuffer) {
+  auto mem = new mm_mem_io_c{nullptr, 0, 1024};
+  mm_write_buffer_io_c out{new mm_sequential_write_io_c{mem, false}, 4096};
+
+  out.write(std::string(10000, 'a'));
+  EXPECT_EQ(10000u, out.getFilePointer());
+
+  // Seeking to the end, e.g. by get_size(), must work without moving.
+  out.setFilePointer(0, seek_end);
+  out.write(std::string(5, 'b'));
+  out.flush();
+
+  EXPECT_EQ(10005u, mem->get_size());
+  EXPECT_THROW(out.setFilePointer(0), mtx::mm_io::seek_x);
+
+  out.close();
+  delete mem;
+}
+
+}
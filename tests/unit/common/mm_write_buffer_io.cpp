@@ -0,0 +1,109 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/util.h"
+
+namespace {
+
+void
+write_and_patch(mm_write_buffer_io_c &out) {
+  out.write(mtxut::create_test_data(10,    3));
+  out.write(mtxut::create_test_data(25000, 5));
+  out.write(mtxut::create_test_data(3,     7));
+  out.write(mtxut::create_test_data(70000, 11));
+
+  EXPECT_EQ(95013u, out.getFilePointer());
+
+  out.setFilePointer(100);
+  out.write(std::string{"patched"});
+  EXPECT_EQ(107u, out.getFilePointer());
+
+  out.setFilePointer(0, seek_end);
+  EXPECT_EQ(95013u, out.getFilePointer());
+
+  out.write(mtxut::create_test_data(4096, 13));
+  out.flush();
+}
+
+TEST(MmWriteBufferIo, WriteBehindSameAsSynchronous) {
+  auto sync_mem  = new mm_mem_io_c{nullptr, 0, 1024};
+  auto async_mem = new mm_mem_io_c{nullptr, 0, 1024};
+
+  mm_write_buffer_io_c sync_out{sync_mem, 4096, false}, async_out{async_mem, 4096, false};
+  async_out.enable_write_behind(2);
+
+  write_and_patch(sync_out);
+  write_and_patch(async_out);
+
+  EXPECT_EQ(99109u, sync_mem->get_size());
+  EXPECT_EQ(sync_mem->get_content(), async_mem->get_content());
+
+  sync_out.close();
+  async_out.close();
+
+  delete sync_mem;
+  delete async_mem;
+}
+
+TEST(MmWriteBufferIo, WriteBehindReadBack) {
+  auto mem = new mm_mem_io_c{nullptr, 0, 1024};
+  auto buf = std::string{};
+
+  mm_write_buffer_io_c out{mem, 1000};
+  out.enable_write_behind(3);
+
+  out.write(mtxut::create_test_data(50000, 17));
+  out.setFilePointer(4711);
+
+  EXPECT_EQ(100u, out.read(buf, 100));
+  EXPECT_EQ(mtxut::create_test_data(50000, 17).substr(4711, 100), buf);
+}
+
+TEST(MmWriteBufferIo, WriteBehindPositionAfterRead) {
+  auto mem  = new mm_mem_io_c{nullptr, 0, 1024};
+  auto buf  = std::string{};
+  auto data = mtxut::create_test_data(20000, 19);
+
+  mm_write_buffer_io_c out{mem, 1000};
+  out.enable_write_behind(2);
+
+  out.write(data);
+  out.setFilePointer(1000);
+
+  EXPECT_EQ(500u, out.read(buf, 500));
+  EXPECT_EQ(1500u, out.getFilePointer());
+
+  out.write(std::string{"patched"});
+  EXPECT_EQ(1507u, out.getFilePointer());
+
+  out.setFilePointer(-7, seek_current);
+  EXPECT_EQ(1500u, out.getFilePointer());
+
+  EXPECT_EQ(7u, out.read(buf, 7));
+  EXPECT_EQ(std::string{"patched"}, buf);
+  EXPECT_EQ(1507u, out.getFilePointer());
+
+  out.setFilePointer(0, seek_end);
+  EXPECT_EQ(20000u, out.getFilePointer());
+}
+
+TEST(MmWriteBufferIo, WriteErrorsOnlyThrownByClose) {
+  static unsigned char const read_only[16]{};
+
+  auto out = std::make_unique<mm_write_buffer_io_c>(new mm_mem_io_c{read_only, sizeof(read_only)}, 100);
+  out->enable_write_behind(2);
+  out->write(mtxut::create_test_data(150, 23));
+
+  EXPECT_THROW(out->close(), mtx::mm_io::exception);
+
+  out = std::make_unique<mm_write_buffer_io_c>(new mm_mem_io_c{read_only, sizeof(read_only)}, 100);
+  out->enable_write_behind(2);
+  out->write(mtxut::create_test_data(50, 23));
+
+  EXPECT_NO_THROW(out.reset());
+}
+
+}
@@ -0,0 +1,90 @@
+#include "common/common_pch.h"
+
+#include "gtest/gtest.h"
+
+#include "common/mpeg.h"
+
+namespace {
+
+unsigned char const *
+find_start_code_bytewise(unsigned char const *begin,
+                         unsigned char const *end) {
+  for (auto p = begin; (p + 3) <= end; ++p)
+    if (!p[0] && !p[1] && (1 == p[2]))
+      return p;
+
+  return end;
+}
+
+TEST(MPEG, FindStartCodeSimple) {
+  unsigned char data[] = { 0x00, 0x00, 0x01, 0x09, 0x00, 0x00, 0x00, 0x01, 0x67, 0x00, 0x00 };
+  auto end             = data + sizeof(data);
+
+  EXPECT_EQ(data,     mtx::mpeg::find_start_code(data,     end));
+  EXPECT_EQ(data + 5, mtx::mpeg::find_start_code(data + 1, end));
+  EXPECT_EQ(end,      mtx::mpeg::find_start_code(data + 6, end));
+  EXPECT_EQ(data + 2, mtx::mpeg::find_start_code(data,     data + 2));
+  EXPECT_EQ(data,     mtx::mpeg::find_start_code(data,     data + 3));
+  EXPECT_EQ(end,      mtx::mpeg::find_start_code(end,      end));
+}
+
+TEST(MPEG, FindStartCodeSameResultAsBytewiseSearch) {
+  auto data = memory_c::alloc(4096);
+  auto buf  = data->get_buffer();
+
+  // Lots of zero bytes and ones so that partial and complete start
+  // codes occur at all offsets.
+  for (auto idx = 0u; idx < data->get_size(); ++idx) {
+    auto value = (idx * 2654435761u) >> 28;
+    buf[idx]   = value < 9 ? 0x00 : value < 13 ? 0x01 : value;
+  }
+
+  for (auto begin = 0u; begin < 64; ++begin)
+    for (auto end = begin; end < data->get_size(); end += 1 + end / 8)
+      for (auto p = buf + begin; p <= buf + end; ++p) {
+        auto expected = find_start_code_bytewise(p, buf + end);
+        ASSERT_EQ(expected, mtx::mpeg::find_start_code(p, buf + end));
+        if (expected == buf + end)
+          break;
+        p = const_cast<unsigned char *>(expected);
+      }
+}
+
+TEST(MPEG, SplitIntoNALUs) {
+  unsigned char data[] = {
+    0x00, 0x00, 0x00, 0x01, 0x09, 0x10,
+    0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x68, 0xce,
+    0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00,
+  };
+
+  auto expected = std::vector<std::pair<std::string, uint64_t>>{
+    { std::string{"\x09\x10"},         0 },
+    { std::string{"\x67\x42", 2},      6 },
+    { std::string{"\x68\xce"},        13 },
+    { std::string{"\x65\x88\x84\x00", 4}, 22 },
+  };
+
+  // Every chunk size must result in the same NALUs at the same
+  // positions, including start codes split between two chunks.
+  for (auto chunk_size = 1u; chunk_size <= sizeof(data); ++chunk_size) {
+    auto nalus           = std::vector<std::pair<std::string, uint64_t>>{};
+    auto unparsed_buffer = memory_cptr{};
+    auto parsed_position = uint64_t{};
+    auto handle_nalu     = [&nalus](memory_cptr const &nalu, uint64_t position) {
+      nalus.emplace_back(std::string{reinterpret_cast<char const *>(nalu->get_buffer()), nalu->get_size()}, position);
+    };
+
+    for (auto offset = 0u; offset < sizeof(data); offset += chunk_size)
+      mtx::mpeg::split_into_nalus(unparsed_buffer, parsed_position, data + offset, std::min<std::size_t>(chunk_size, sizeof(data) - offset), handle_nalu);
+
+    EXPECT_EQ(3u, nalus.size());
+
+    mtx::mpeg::flush_nalus(unparsed_buffer, parsed_position, handle_nalu);
+
+    EXPECT_EQ(expected, nalus) << "chunk size " << chunk_size;
+    EXPECT_FALSE(!!unparsed_buffer);
+  }
+}
+
+}
@@ -0,0 +1,82 @@
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include "tests/unit/init.h"
+
+namespace {
+
+using namespace mtx::output;
+
+TEST(WorkerMessages, ErrorsAreThrown) {
+  worker_messages_c worker_messages;
+  g_warning_issued = false;
+
+  EXPECT_THROW(mxerror("fatal\n"), error_x);
+
+  try {
+    mxerror("fatal\n");
+  } catch (error_x &ex) {
+    EXPECT_EQ(std::string{"fatal\n"}, ex.what());
+  }
+
+  mxwarn("passed through\n");
+  EXPECT_TRUE(g_warning_issued);
+}
+
+TEST(WorkerMessages, RestoresPreviousHandling) {
+  {
+    worker_messages_c worker_messages;
+    EXPECT_EQ(&worker_messages, worker_messages_c::current());
+  }
+
+  EXPECT_EQ(nullptr, worker_messages_c::current());
+  EXPECT_THROW(mxerror("fatal\n"), mtxut::mxerror_x);
+}
+
+TEST(WorkerMessages, OnlyAffectsCurrentThread) {
+  worker_messages_c worker_messages;
+  auto thrown = false;
+
+  std::thread{[&thrown]() {
+    try {
+      mxerror("fatal\n");
+    } catch (mtxut::mxerror_x &) {
+      thrown = true;
+    }
+  }}.join();
+
+  EXPECT_TRUE(thrown);
+}
+
+TEST(WorkerMessages, CaptureAndReplay) {
+  auto messages    = std::vector<message_t>{};
+  g_warning_issued = false;
+
+  std::thread{[&messages]() {
+    worker_messages_c worker_messages{true};
+
+    mxinfo("info\n");
+    mxwarn("warning\n");
+
+    try {
+      mxerror("error\n");
+    } catch (error_x &) {
+    }
+
+    messages = worker_messages.get_messages();
+  }}.join();
+
+  EXPECT_FALSE(g_warning_issued);
+
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ(MXMSG_INFO,    messages[0].m_level);
+  EXPECT_EQ(MXMSG_WARNING, messages[1].m_level);
+  EXPECT_EQ(MXMSG_ERROR,   messages[2].m_level);
+  EXPECT_EQ(std::string{"warning\n"}, messages[1].m_message);
+
+  EXPECT_THROW(replay(messages), mtxut::mxerror_x);
+  EXPECT_TRUE(g_warning_issued);
+}
+
+}
@@ -0,0 +1,86 @@
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include "common/profiling.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace mtx::profiling;
+
+void
+sleep_ms(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST(Profiling, DisabledTimersDontCount) {
+  enable(false);
+
+  {
+    scoped_timer_c timer{stage_e::reader_read, 1};
+  }
+
+  enable(true);
+  enable(false);
+
+  auto report = create_report();
+
+  EXPECT_TRUE(report["stages"].empty());
+  EXPECT_TRUE(report["tracks"].empty());
+}
+
+TEST(Profiling, NestedTimersAreExclusive) {
+  enable(true);
+
+  {
+    scoped_timer_c outer{stage_e::reader_read, 1};
+    sleep_ms(20);
+
+    {
+      scoped_timer_c inner{stage_e::packetizer_process, 2};
+      sleep_ms(50);
+    }
+  }
+
+  {
+    scoped_timer_c timer{stage_e::cluster_render};
+  }
+
+  enable(false);
+
+  auto report  = create_report();
+  auto read_ns = report["stages"]["reader_read"]["time_ns"].get<int64_t>();
+  auto proc_ns = report["stages"]["packetizer_process"]["time_ns"].get<int64_t>();
+
+  EXPECT_EQ(1u, report["stages"]["reader_read"]["calls"].get<uint64_t>());
+  EXPECT_EQ(1u, report["stages"]["packetizer_process"]["calls"].get<uint64_t>());
+  EXPECT_EQ(1u, report["stages"]["cluster_render"]["calls"].get<uint64_t>());
+
+  EXPECT_GE(read_ns, 20000000);
+  EXPECT_GE(proc_ns, 50000000);
+
+  ASSERT_EQ(2u, report["tracks"].size());
+  EXPECT_EQ(1, report["tracks"][0]["track_number"].get<int64_t>());
+  EXPECT_TRUE(report["tracks"][0]["stages"].count("reader_read"));
+  EXPECT_FALSE(report["tracks"][0]["stages"].count("packetizer_process"));
+  EXPECT_EQ(2, report["tracks"][1]["track_number"].get<int64_t>());
+
+  EXPECT_GE(report["total_time_ns"].get<int64_t>(), read_ns + proc_ns);
+}
+
+TEST(Profiling, EnablingResetsCounters) {
+  enable(true);
+  add(stage_e::write_wait, -1, 1000);
+  enable(false);
+
+  EXPECT_EQ(1000, create_report()["stages"]["write_wait"]["time_ns"].get<int64_t>());
+
+  enable(true);
+  enable(false);
+
+  EXPECT_TRUE(create_report()["stages"].empty());
+}
+
+}
@@ -0,0 +1,42 @@
+#include "common/common_pch.h"
+
+#include "common/strings/fast_format.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(StringsFastFormat, SameResultAsBoostFormat) {
+  auto format_string = std::string{"%1% frame, track %2%, timecode %3% (%4%), duration %|5$.3f|, size %6%, adler 0x%|7$08x|%8%%9%\n"};
+  fast_format_c format{format_string};
+
+  ASSERT_TRUE(format.is_supported());
+
+  EXPECT_EQ((boost::format(format_string) % 'P' % 2ull % 40004ll % std::string{"00:00:40.004"} % 41.708f % 1234 % 0xabcdu % "" % ", position 1234").str(),
+            format.format({ 'P', 2ull, 40004ll, std::string{"00:00:40.004"}, 41.708f, 1234, 0xabcdu, "", ", position 1234" }));
+
+  EXPECT_EQ((boost::format(format_string) % 'B' % 12ull % -3ll % std::string{"-00:00:00.003"} % 0.0 % 0 % 0x12345678u % " hexdump 01 02" % "").str(),
+            format.format({ 'B', 12ull, -3ll, std::string{"-00:00:00.003"}, 0.0, 0, 0x12345678u, " hexdump 01 02", "" }));
+}
+
+TEST(StringsFastFormat, Directives) {
+  EXPECT_EQ("100% 2 1",     fast_format_c{"100%% %2% %1%"}.format({ 1, 2 }));
+  EXPECT_EQ("[  42]",       fast_format_c{"[%|1$4d|]"}.format({ 42 }));
+  EXPECT_EQ("[-0042]",      fast_format_c{"[%|1$05d|]"}.format({ -42 }));
+  EXPECT_EQ("0xFF 0xff",    fast_format_c{"0x%|1$X| 0x%|1$x|"}.format({ 255u }));
+  EXPECT_EQ("1.50 0.333",   fast_format_c{"%|1$.2f| %|2$.3f|"}.format({ 1.5, 1.0 / 3 }));
+  EXPECT_EQ("0.333333",     fast_format_c{"%1%"}.format({ 1.0 / 3 }));
+  EXPECT_EQ("ab",           fast_format_c{"%|1$.2s|"}.format({ "abc" }));
+}
+
+TEST(StringsFastFormat, UnsupportedDirectives) {
+  EXPECT_FALSE(fast_format_c{"%d"}.is_supported());
+  EXPECT_FALSE(fast_format_c{"%s"}.is_supported());
+  EXPECT_FALSE(fast_format_c{"%1"}.is_supported());
+  EXPECT_FALSE(fast_format_c{"%|1$-5d|"}.is_supported());
+  EXPECT_FALSE(fast_format_c{"%|1$5e|"}.is_supported());
+  EXPECT_FALSE(fast_format_c{"%|5d|"}.is_supported());
+  EXPECT_TRUE(fast_format_c{"no directives at all"}.is_supported());
+}
+
+}
@@ -0,0 +1,196 @@
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "extract/extraction_pipeline.h"
+
+#include "tests/unit/init.h"
+
+namespace {
+
+class test_extractor_c: public xtr_base_c {
+public:
+  std::vector<int> m_handled;
+  std::function<void(int)> m_on_frame;
+
+  test_extractor_c(int64_t tid,
+                   track_spec_t &tspec)
+    : xtr_base_c{"V_TEST", tid, tspec}
+  {
+  }
+
+  virtual void handle_frame(xtr_frame_t &f) override {
+    auto value = static_cast<int>(f.frame->get_buffer()[0]);
+
+    if (m_on_frame)
+      m_on_frame(value);
+
+    m_handled.push_back(value);
+  }
+};
+
+class ExtractionPipeline: public ::testing::Test {
+protected:
+  track_spec_t m_tspec;
+  std::vector<std::unique_ptr<test_extractor_c>> m_extractors;
+
+  test_extractor_c &add_extractor() {
+    m_extractors.emplace_back(std::make_unique<test_extractor_c>(m_extractors.size(), m_tspec));
+    return *m_extractors.back();
+  }
+
+  std::vector<xtr_base_c *> get_extractors() const {
+    auto extractors = std::vector<xtr_base_c *>{};
+    for (auto const &extractor : m_extractors)
+      extractors.push_back(extractor.get());
+
+    return extractors;
+  }
+
+  void add_frame(extraction_pipeline_c &pipeline,
+                 xtr_base_c &extractor,
+                 extraction_pipeline_c::cluster_cptr const &cluster,
+                 int value) {
+    auto frame = memory_c::alloc(1);
+    frame->get_buffer()[0] = value;
+
+    auto f = xtr_frame_t{frame, nullptr, value, 0, 0, 0, true, false, false, timestamp_c{}};
+    pipeline.add_frame(extractor, cluster, f);
+  }
+};
+
+TEST_F(ExtractionPipeline, FramesHandledInOrderPerExtractor) {
+  auto &first  = add_extractor();
+  auto &second = add_extractor();
+  auto &third  = add_extractor();
+
+  extraction_pipeline_c pipeline{get_extractors(), 2};
+
+  for (auto cluster_idx = 0; cluster_idx < 20; ++cluster_idx) {
+    auto cluster = pipeline.adopt_cluster(new KaxCluster);
+
+    for (auto frame_idx = 0; frame_idx < 5; ++frame_idx) {
+      auto value = cluster_idx * 5 + frame_idx;
+      add_frame(pipeline, first,  cluster, value);
+      add_frame(pipeline, second, cluster, value + 1);
+      add_frame(pipeline, third,  cluster, value + 2);
+    }
+  }
+
+  pipeline.finish();
+
+  ASSERT_EQ(100u, first.m_handled.size());
+  ASSERT_EQ(100u, second.m_handled.size());
+  ASSERT_EQ(100u, third.m_handled.size());
+
+  for (auto idx = 0; idx < 100; ++idx) {
+    EXPECT_EQ(idx,     first.m_handled[idx]);
+    EXPECT_EQ(idx + 1, second.m_handled[idx]);
+    EXPECT_EQ(idx + 2, third.m_handled[idx]);
+  }
+}
+
+TEST_F(ExtractionPipeline, NumberOfClustersAliveIsLimited) {
+  auto &first  = add_extractor();
+  auto &second = add_extractor();
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  auto blocked = true;
+
+  first.m_on_frame = [&](int) {
+    std::unique_lock<std::mutex> lock{mutex};
+    cond.wait(lock, [&blocked]() { return !blocked; });
+  };
+
+  // Two workers allow 2 * 2 + 2 clusters to be alive.
+  extraction_pipeline_c pipeline{get_extractors(), 2};
+  std::atomic<int> num_adopted{0};
+
+  auto producer = std::thread{[&]() {
+    for (auto idx = 0; idx < 10; ++idx) {
+      auto cluster = pipeline.adopt_cluster(new KaxCluster);
+      add_frame(pipeline, first,  cluster, idx);
+      add_frame(pipeline, second, cluster, idx);
+      ++num_adopted;
+    }
+  }};
+
+  for (auto wait = 0; (wait < 500) && (num_adopted < 6); ++wait)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(6, num_adopted.load());
+
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    blocked = false;
+  }
+  cond.notify_all();
+
+  producer.join();
+  pipeline.finish();
+
+  EXPECT_EQ(10, num_adopted.load());
+  EXPECT_EQ(10u, first.m_handled.size());
+  EXPECT_EQ(10u, second.m_handled.size());
+}
+
+TEST_F(ExtractionPipeline, WorkerExceptionsAreRethrown) {
+  auto &first  = add_extractor();
+  auto &second = add_extractor();
+
+  first.m_on_frame = [](int value) {
+    if (value == 3)
+      throw std::runtime_error{"failed"};
+  };
+
+  extraction_pipeline_c pipeline{get_extractors(), 2};
+
+  // Adding more frames fails as well once the worker has failed.
+  EXPECT_THROW({
+      for (auto idx = 0; idx < 5; ++idx) {
+        auto cluster = pipeline.adopt_cluster(new KaxCluster);
+        add_frame(pipeline, first,  cluster, idx);
+        add_frame(pipeline, second, cluster, idx);
+      }
+
+      pipeline.finish();
+    }, std::runtime_error);
+
+  EXPECT_EQ(3u, first.m_handled.size());
+}
+
+TEST_F(ExtractionPipeline, ErrorsOnWorkersDontExit) {
+  auto &first  = add_extractor();
+  auto &second = add_extractor();
+
+  first.m_on_frame = [](int value) {
+    if (value == 1)
+      mxerror("extractor failed\n");
+  };
+
+  extraction_pipeline_c pipeline{get_extractors(), 2};
+
+  try {
+    for (auto idx = 0; idx < 3; ++idx) {
+      auto cluster = pipeline.adopt_cluster(new KaxCluster);
+      add_frame(pipeline, first,  cluster, idx);
+      add_frame(pipeline, second, cluster, idx);
+    }
+
+    pipeline.finish();
+    ADD_FAILURE() << "no exception thrown";
+
+  } catch (mtx::output::error_x &ex) {
+    EXPECT_EQ(std::string{"extractor failed\n"}, ex.what());
+  }
+
+  EXPECT_EQ(1u, first.m_handled.size());
+}
+
+}
@@ -0,0 +1,164 @@
+#include "common/common_pch.h"
+
+#include "extract/extraction_range.h"
+
+#include "tests/unit/init.h"
+
+namespace {
+
+using filter_c = extraction_range_filter_c<int, int>;
+
+extraction_range_c
+range(int64_t start_s,
+      int64_t end_s) {
+  return extraction_range_c{0 <= start_s ? timestamp_c::s(start_s) : timestamp_c{}, 0 <= end_s ? timestamp_c::s(end_s) : timestamp_c{}};
+}
+
+std::vector<int>
+add_frames(filter_c &filter,
+           int track,
+           std::vector<std::pair<int64_t, bool>> const &frames) {
+  auto handled = std::vector<int>{};
+
+  for (auto const &frame : frames) {
+    auto timestamp = frame.first * 1000000;
+    auto action    = filter.add(track, timestamp, frame.second);
+
+    if (action == filter_c::action_e::hold)
+      filter.hold(track, frame.first);
+
+    else if (action == filter_c::action_e::handle) {
+      brng::copy(filter.take_held(track), std::back_inserter(handled));
+      handled.push_back(frame.first);
+    }
+  }
+
+  return handled;
+}
+
+TEST(ExtractionRange, CueSearchFindsLastCuePointBeforeStart) {
+  auto cue_points = std::vector<extraction_range_c::cue_point_t>{
+    { timestamp_c::s(0),  100 },
+    { timestamp_c::s(10), 300 },
+    { timestamp_c::s(10), 200 },
+    { timestamp_c::s(20), 400 },
+  };
+
+  auto start = range(15, -1).find_start_in_cues(cue_points, {});
+  ASSERT_TRUE(!!start);
+  EXPECT_EQ(200u,               start->first);
+  EXPECT_EQ(timestamp_c::s(10), start->second);
+
+  start = range(20, -1).find_start_in_cues(cue_points, {});
+  ASSERT_TRUE(!!start);
+  EXPECT_EQ(400u, start->first);
+
+  EXPECT_FALSE(range(15, -1).find_start_in_cues({ { timestamp_c::s(20), 400 } }, {}));
+  EXPECT_FALSE(range(15, -1).find_start_in_cues({}, {}));
+  EXPECT_FALSE(range(-1, 30).find_start_in_cues(cue_points, {}));
+}
+
+TEST(ExtractionRange, CueSearchVerifiesClusterPositions) {
+  auto cue_points = std::vector<extraction_range_c::cue_point_t>{
+    { timestamp_c::s(0),  100 },
+    { timestamp_c::s(10), 250 },
+  };
+
+  // Unless the file has been parsed fully only the first cluster is
+  // known.
+  EXPECT_TRUE(!!range(15, -1).find_start_in_cues(cue_points, { 100 }));
+  EXPECT_TRUE(!!range(15, -1).find_start_in_cues(cue_points, { 100, 250, 400 }));
+
+  g_warning_issued = false;
+  EXPECT_FALSE(range(15, -1).find_start_in_cues(cue_points, { 100, 200, 300 }));
+  EXPECT_TRUE(g_warning_issued);
+}
+
+TEST(ExtractionRange, ClusterSearch) {
+  auto positions  = std::vector<uint64_t>{ 100, 200, 300, 400, 500, 600, 700, 800 };
+  auto num_reads  = 0;
+  auto timestamps = [&num_reads](uint64_t position) -> boost::optional<timestamp_c> {
+    ++num_reads;
+    return timestamp_c::s(position / 10);
+  };
+
+  auto start = range(45, -1).find_start_in_clusters(positions, timestamps);
+  ASSERT_TRUE(!!start);
+  EXPECT_EQ(400u,               start->first);
+  EXPECT_EQ(timestamp_c::s(40), start->second);
+  EXPECT_GE(4, num_reads);
+
+  start = range(40, -1).find_start_in_clusters(positions, timestamps);
+  ASSERT_TRUE(!!start);
+  EXPECT_EQ(400u, start->first);
+
+  start = range(1000, -1).find_start_in_clusters(positions, timestamps);
+  ASSERT_TRUE(!!start);
+  EXPECT_EQ(800u, start->first);
+
+  EXPECT_FALSE(range(5, -1).find_start_in_clusters(positions, timestamps));
+  EXPECT_FALSE(range(45, -1).find_start_in_clusters(positions, [](uint64_t) { return boost::optional<timestamp_c>{}; }));
+}
+
+TEST(ExtractionRange, IsDone) {
+  EXPECT_FALSE(range(10, -1).is_done(timestamp_c::s(1000)));
+  EXPECT_FALSE(range(10, 20).is_done(timestamp_c::s(5)));
+  EXPECT_FALSE(range(10, 20).is_done(timestamp_c::ns(timestamp_c::s(20).to_ns() - 1)));
+  EXPECT_TRUE(range(10, 20).is_done(timestamp_c::s(20)));
+  EXPECT_TRUE(range(-1, 20).is_done(timestamp_c::s(25)));
+}
+
+TEST(ExtractionRangeFilter, VideoStartsAtPrecedingKeyFrame) {
+  auto filter  = filter_c{extraction_range_c{timestamp_c::ms(45), timestamp_c::ms(80)}};
+  auto handled = add_frames(filter, 1, { { 0, true }, { 10, false }, { 20, true }, { 30, false }, { 40, false }, { 50, false }, { 60, true }, { 70, false }, { 80, true } });
+  EXPECT_EQ((std::vector<int>{ 20, 30, 40, 50, 60, 70 }), handled);
+}
+
+TEST(ExtractionRangeFilter, KeyFrameAtStart) {
+  auto filter  = filter_c{extraction_range_c{timestamp_c::ms(20)}};
+  auto handled = add_frames(filter, 1, { { 0, true }, { 10, false }, { 20, true }, { 30, false } });
+
+  EXPECT_EQ((std::vector<int>{ 20, 30 }), handled);
+}
+
+TEST(ExtractionRangeFilter, TracksAreIndependent) {
+  auto filter = filter_c{extraction_range_c{timestamp_c::ms(25)}};
+
+  EXPECT_EQ(filter_c::action_e::hold,   filter.add(1, 0,        true));
+  filter.hold(1, 0);
+  EXPECT_EQ(filter_c::action_e::hold,   filter.add(2, 20000000, true));
+  filter.hold(2, 20);
+  EXPECT_EQ(filter_c::action_e::hold,   filter.add(1, 10000000, false));
+  filter.hold(1, 10);
+
+  EXPECT_EQ(filter_c::action_e::handle, filter.add(2, 30000000, true));
+  EXPECT_EQ((std::vector<int>{ 20 }),    filter.take_held(2));
+
+  EXPECT_EQ(filter_c::action_e::handle, filter.add(1, 30000000, false));
+  EXPECT_EQ((std::vector<int>{ 0, 10 }), filter.take_held(1));
+}
+
+TEST(ExtractionRangeFilter, WithoutKeyFrameBeforeStart) {
+  auto filter = filter_c{extraction_range_c{timestamp_c::ms(25)}};
+  filter.require_keyframes(1);
+
+  auto handled = add_frames(filter, 1, { { 10, false }, { 20, false }, { 30, false }, { 40, true }, { 50, false } });
+
+  EXPECT_EQ((std::vector<int>{ 40, 50 }), handled);
+}
+
+TEST(ExtractionRangeFilter, TrackWithoutKeyFrameFlags) {
+  auto filter  = filter_c{extraction_range_c{timestamp_c::ms(25), timestamp_c::ms(50)}};
+  auto handled = add_frames(filter, 2, { { 0, false }, { 10, false }, { 20, false }, { 30, false }, { 40, false }, { 50, false } });
+
+  EXPECT_EQ((std::vector<int>{ 30, 40 }), handled);
+}
+
+TEST(ExtractionRangeFilter, WithoutStart) {
+  auto filter  = filter_c{extraction_range_c{timestamp_c{}, timestamp_c::ms(30)}};
+  auto handled = add_frames(filter, 1, { { 0, false }, { 10, false }, { 20, true }, { 30, true }, { 40, true } });
+
+  EXPECT_EQ((std::vector<int>{ 0, 10, 20 }), handled);
+}
+
+}
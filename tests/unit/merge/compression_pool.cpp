@@ -0,0 +1,90 @@
+#include "common/common_pch.h"
+
+#include "merge/compression_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+memory_cptr
+create_buffer(unsigned int idx) {
+  auto buffer = memory_c::alloc(1000 + (idx * 7919) % 20000);
+  auto ptr    = buffer->get_buffer();
+
+  for (auto pos = 0u; pos < buffer->get_size(); ++pos)
+    ptr[pos] = (pos * idx / 13) & 0xff;
+
+  return buffer;
+}
+
+TEST(CompressionPool, SameResultAsSequentialCompression) {
+  auto compressor = compressor_c::create(COMPRESSION_ZLIB);
+  auto futures    = std::vector<std::future<compression_pool_c::result_t>>{};
+  auto buffers    = std::vector<std::vector<memory_cptr>>{};
+
+  {
+    compression_pool_c pool{4};
+
+    for (auto idx = 0u; idx < 200; ++idx) {
+      buffers.push_back({ create_buffer(idx) });
+      if (idx % 3)
+        buffers.back().push_back(create_buffer(idx + 1000));
+
+      futures.emplace_back(pool.compress(COMPRESSION_ZLIB, buffers.back()));
+    }
+
+    for (auto idx = 0u; idx < futures.size(); ++idx) {
+      auto result = futures[idx].get().m_buffers;
+
+      ASSERT_EQ(buffers[idx].size(), result.size());
+
+      for (auto buffer_idx = 0u; buffer_idx < result.size(); ++buffer_idx) {
+        EXPECT_TRUE(*compressor->compress(buffers[idx][buffer_idx]) == *result[buffer_idx]);
+        EXPECT_TRUE(*compressor->decompress(result[buffer_idx]) == *buffers[idx][buffer_idx]);
+      }
+    }
+  }
+}
+
+TEST(CompressionPool, MessagesAreReturnedWithTheResult) {
+  auto previous_verbose = verbose;
+  verbose               = 3;
+
+  auto result = compression_pool_c{2}.compress(COMPRESSION_ZLIB, { create_buffer(1), create_buffer(2) }).get();
+
+  verbose = previous_verbose;
+
+  EXPECT_EQ(2u, result.m_buffers.size());
+  ASSERT_EQ(2u, result.m_messages.size());
+  EXPECT_EQ(MXMSG_INFO, result.m_messages[0].m_level);
+  EXPECT_TRUE(balg::starts_with(result.m_messages[0].m_message, "zlib_compressor_c: Compression"));
+}
+
+TEST(CompressionPool, DestructionWithPendingJobs) {
+  auto futures = std::vector<std::future<compression_pool_c::result_t>>{};
+
+  {
+    compression_pool_c pool{2};
+
+    for (auto idx = 0u; idx < 100; ++idx)
+      futures.emplace_back(pool.compress(COMPRESSION_ZLIB, { create_buffer(idx) }));
+  }
+
+  // Jobs dropped on destruction must not leave their futures waiting
+  // forever.
+  auto num_finished = 0u, num_dropped = 0u;
+
+  for (auto &future : futures) {
+    try {
+      future.get();
+      ++num_finished;
+
+    } catch (std::future_error &) {
+      ++num_dropped;
+    }
+  }
+
+  EXPECT_EQ(futures.size(), num_finished + num_dropped);
+}
+
+}
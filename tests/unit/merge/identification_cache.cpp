@@ -0,0 +1,75 @@
+#include "common/common_pch.h"
+
+#include "merge/identification_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class IdentificationCache: public ::testing::Test {
+protected:
+  bfs::path m_directory, m_file_name;
+  nlohmann::json m_options, m_identification;
+
+  virtual void SetUp() {
+    m_directory      = bfs::temp_directory_path() / bfs::unique_path();
+    m_file_name      = bfs::temp_directory_path() / bfs::unique_path();
+    m_options        = nlohmann::json{ { "ui_locale", "en_US" } };
+    m_identification = nlohmann::json{ { "file_name", m_file_name.string() }, { "tracks", nlohmann::json::array() } };
+
+    write_file("0123456789");
+  }
+
+  virtual void TearDown() {
+    bfs::remove_all(m_directory);
+    bfs::remove(m_file_name);
+  }
+
+  void write_file(std::string const &content) {
+    mm_file_io_c out{m_file_name.string(), MODE_CREATE};
+    out.write(content.c_str(), content.size());
+  }
+};
+
+TEST_F(IdentificationCache, StoreAndFetch) {
+  auto cache = identification_cache_c{m_directory};
+
+  EXPECT_FALSE(!!cache.fetch(m_file_name.string(), m_options));
+
+  cache.store(m_file_name.string(), m_options, m_identification);
+
+  auto cached = cache.fetch(m_file_name.string(), m_options);
+  ASSERT_TRUE(!!cached);
+  EXPECT_EQ(m_identification, *cached);
+
+  // A second instance sharing the directory sees the same entry.
+  auto other = identification_cache_c{m_directory}.fetch(m_file_name.string(), m_options);
+  ASSERT_TRUE(!!other);
+  EXPECT_EQ(m_identification, *other);
+}
+
+TEST_F(IdentificationCache, DifferentOptionsMiss) {
+  auto cache = identification_cache_c{m_directory};
+  cache.store(m_file_name.string(), m_options, m_identification);
+
+  EXPECT_FALSE(!!cache.fetch(m_file_name.string(), nlohmann::json{ { "ui_locale", "de_DE" } }));
+}
+
+TEST_F(IdentificationCache, ChangedFileMisses) {
+  auto cache = identification_cache_c{m_directory};
+  cache.store(m_file_name.string(), m_options, m_identification);
+
+  write_file("01234567890123456789");
+
+  EXPECT_FALSE(!!cache.fetch(m_file_name.string(), m_options));
+}
+
+TEST_F(IdentificationCache, MissingFile) {
+  auto cache = identification_cache_c{m_directory};
+  auto name  = (bfs::temp_directory_path() / bfs::unique_path()).string();
+
+  cache.store(name, m_options, m_identification);
+  EXPECT_FALSE(!!cache.fetch(name, m_options));
+}
+
+}
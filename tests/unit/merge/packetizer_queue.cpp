@@ -0,0 +1,112 @@
+#include "common/common_pch.h"
+
+#include "merge/packetizer_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Synthetic tracks producing packets with a fixed duration each. The
+// durations are chosen so that lots of timestamps collide between
+// tracks, exercising the tie-breaking by packetizer index.
+class synthetic_tracks_c {
+public:
+  std::vector<int64_t> m_next_timestamps, m_durations;
+
+public:
+  synthetic_tracks_c(std::size_t num_tracks) {
+    static int64_t const s_durations[] = { 40000000, 20000000, 33366666, 32000000, 40000000, 21333333, 100000000, 1000000000 };
+
+    for (auto idx = 0u; idx < num_tracks; ++idx) {
+      m_durations.push_back(s_durations[idx % 8]);
+      m_next_timestamps.push_back((idx / 8) * 1000000);
+    }
+  }
+
+  timestamp_c
+  produce(std::size_t idx) {
+    auto timestamp          = m_next_timestamps[idx];
+    m_next_timestamps[idx] += m_durations[idx];
+
+    return timestamp_c::ns(timestamp);
+  }
+};
+
+std::vector<std::size_t>
+order_by_linear_scan(std::size_t num_tracks,
+                     std::size_t num_packets) {
+  auto tracks  = synthetic_tracks_c{num_tracks};
+  auto current = std::vector<timestamp_c>{};
+  auto order   = std::vector<std::size_t>{};
+
+  for (auto idx = 0u; idx < num_tracks; ++idx)
+    current.push_back(tracks.produce(idx));
+
+  while (order.size() < num_packets) {
+    auto winner = 0u;
+    for (auto idx = 1u; idx < num_tracks; ++idx)
+      if (current[idx] < current[winner])
+        winner = idx;
+
+    order.push_back(winner);
+    current[winner] = tracks.produce(winner);
+  }
+
+  return order;
+}
+
+std::vector<std::size_t>
+order_by_queue(std::size_t num_tracks,
+               std::size_t num_packets) {
+  auto tracks = synthetic_tracks_c{num_tracks};
+  auto queue  = packetizer_queue_c{};
+  auto order  = std::vector<std::size_t>{};
+
+  for (auto idx = 0u; idx < num_tracks; ++idx)
+    queue.push(tracks.produce(idx), idx);
+
+  while (order.size() < num_packets) {
+    auto winner = queue.top();
+    queue.pop();
+
+    order.push_back(winner);
+    queue.push(tracks.produce(winner), winner);
+  }
+
+  return order;
+}
+
+TEST(PacketizerQueue, Basics) {
+  auto queue = packetizer_queue_c{};
+
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(timestamp_c::ms(20), 0);
+  queue.push(timestamp_c::ms(10), 1);
+  queue.push(timestamp_c::ms(10), 3);
+  queue.push(timestamp_c::ms(10), 2);
+  queue.push(timestamp_c::ms(-5), 4);
+
+  EXPECT_FALSE(queue.empty());
+  EXPECT_EQ(5u, queue.size());
+
+  EXPECT_EQ(4u, queue.top()); queue.pop();
+  EXPECT_EQ(1u, queue.top()); queue.pop();
+  EXPECT_EQ(2u, queue.top()); queue.pop();
+  EXPECT_EQ(3u, queue.top()); queue.pop();
+  EXPECT_EQ(0u, queue.top()); queue.pop();
+
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(timestamp_c::ms(10), 1);
+  queue.clear();
+
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(PacketizerQueue, SameOrderAsLinearScan) {
+  for (auto num_tracks : std::vector<std::size_t>{ 1, 2, 3, 7, 8, 9, 40, 80, 200 })
+    EXPECT_EQ(order_by_linear_scan(num_tracks, 20000), order_by_queue(num_tracks, 20000)) << "number of tracks: " << num_tracks;
+}
+
+}
@@ -0,0 +1,56 @@
+#include "common/common_pch.h"
+
+#include "merge/track_headers_space.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(TrackHeadersSpace, InitialVoid) {
+  EXPECT_EQ(1024,        calculate_initial_void_after_track_headers(300, 300, 0));
+  EXPECT_EQ(1024 + 20,   calculate_initial_void_after_track_headers(320, 300, 0));
+  EXPECT_EQ(1024 + 2048, calculate_initial_void_after_track_headers(300, 300, g_expected_hevcc_size));
+}
+
+TEST(TrackHeadersSpace, RerenderBoundary) {
+  // Four bytes are the smallest void possible.
+  auto rerender = calculate_track_headers_rerender(4996, 5000, 1000, 500);
+  EXPECT_EQ(0, rerender.m_relocation);
+  EXPECT_EQ(4, rerender.m_void_size);
+
+  rerender = calculate_track_headers_rerender(4997, 5000, 1000, 500);
+  EXPECT_EQ(1024 - 3, rerender.m_relocation);
+  EXPECT_EQ(1024,     rerender.m_void_size);
+
+  // Without data after the void nothing has to be moved.
+  rerender = calculate_track_headers_rerender(5100, 5000, 0, 500);
+  EXPECT_EQ(0,    rerender.m_relocation);
+  EXPECT_EQ(1024, rerender.m_void_size);
+
+  // Large track headers leave as much space as they take up.
+  rerender = calculate_track_headers_rerender(5100, 5000, 1000, 4000);
+  EXPECT_EQ(4000 + 100, rerender.m_relocation);
+  EXPECT_EQ(4000,       rerender.m_void_size);
+}
+
+TEST(TrackHeadersSpace, ExpectedGrowthAvoidsRelocation) {
+  // Track headers rendered at position 100 with 300 bytes, followed by
+  // the void with its element ID and a two byte size.
+  auto const tracks_end = int64_t{400};
+  auto const void_size  = calculate_initial_void_after_track_headers(300, 300, g_expected_avcc_size);
+  auto const data_start = tracks_end + 3 + void_size;
+
+  // The expected codec private data and the general reserve fit.
+  auto rerender = calculate_track_headers_rerender(tracks_end + g_expected_avcc_size, data_start, 1000000, 300 + g_expected_avcc_size);
+  EXPECT_EQ(0, rerender.m_relocation);
+
+  rerender = calculate_track_headers_rerender(tracks_end + g_expected_avcc_size + g_track_headers_min_reserve - 1, data_start, 1000000, 300 + g_expected_avcc_size);
+  EXPECT_EQ(0, rerender.m_relocation);
+  EXPECT_EQ(4, rerender.m_void_size);
+
+  // One byte more requires moving the data.
+  rerender = calculate_track_headers_rerender(tracks_end + g_expected_avcc_size + g_track_headers_min_reserve, data_start, 1000000, 300 + g_expected_avcc_size);
+  EXPECT_LT(0, rerender.m_relocation);
+}
+
+}
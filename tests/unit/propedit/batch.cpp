@@ -0,0 +1,104 @@
+#include "common/common_pch.h"
+
+#include "propedit/batch.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/init.h"
+
+namespace {
+
+// batch_c::run() replaces the message handlers installed for the unit
+// tests.
+void
+restore_mxmsg_handlers() {
+  auto handler = [](unsigned int level, std::string const &message) {
+    if (MXMSG_WARNING == level)
+      g_warning_issued = true;
+
+    else if (MXMSG_ERROR == level)
+      throw mtxut::mxerror_x{message};
+  };
+
+  set_mxmsg_handler(MXMSG_INFO,    handler);
+  set_mxmsg_handler(MXMSG_WARNING, handler);
+  set_mxmsg_handler(MXMSG_ERROR,   handler);
+}
+
+TEST(PropeditBatch, ParseFileList) {
+  batch_c batch{{}};
+
+  batch.parse_jobs("a.mkv\n\n# comment\n  b c.mkv  \r\nd.mkv");
+
+  auto const &jobs = batch.get_jobs();
+
+  ASSERT_EQ(3u, jobs.size());
+  EXPECT_EQ("a.mkv",   jobs[0].m_file_name);
+  EXPECT_EQ("b c.mkv", jobs[1].m_file_name);
+  EXPECT_EQ("d.mkv",   jobs[2].m_file_name);
+  EXPECT_TRUE(jobs[1].m_arguments.empty());
+}
+
+TEST(PropeditBatch, ParseJSON) {
+  batch_c batch{{}};
+
+  batch.parse_jobs("  [ \"a.mkv\", { \"file_name\": \"b.mkv\", \"arguments\": [ \"--edit\", \"info\", \"--set\", \"title=B\" ] } ]");
+
+  auto const &jobs = batch.get_jobs();
+
+  ASSERT_EQ(2u, jobs.size());
+  EXPECT_EQ("a.mkv", jobs[0].m_file_name);
+  EXPECT_TRUE(jobs[0].m_arguments.empty());
+  EXPECT_EQ("b.mkv", jobs[1].m_file_name);
+  EXPECT_EQ((std::vector<std::string>{ "--edit", "info", "--set", "title=B" }), jobs[1].m_arguments);
+}
+
+TEST(PropeditBatch, ResultToJSON) {
+  auto result       = batch_c::result_t{};
+  result.m_success  = true;
+  result.m_warnings = { "careful" };
+
+  auto json = batch_c::result_to_json(batch_c::job_t{ "a.mkv", {} }, result);
+
+  EXPECT_EQ("a.mkv",  json["file_name"].get<std::string>());
+  EXPECT_TRUE(json["success"].get<bool>());
+  EXPECT_FALSE(json["modified"].get<bool>());
+  EXPECT_EQ(1u,        json["warnings"].size());
+  EXPECT_EQ("careful", json["warnings"][0].get<std::string>());
+  EXPECT_TRUE(json["errors"].empty());
+}
+
+TEST(PropeditBatch, ErrorsOnlyFailTheCurrentJob) {
+  batch_c batch{{ "--edit", "info" }};
+
+  for (auto idx = 0; idx < 20; ++idx)
+    batch.add_job(batch_c::job_t{ (boost::format("%1%.mkv") % idx).str(), {} });
+
+  auto arguments_seen = std::vector<std::vector<std::string>>{};
+
+  auto exit_code = batch.run([&arguments_seen](std::vector<std::string> const &arguments) -> bool {
+    arguments_seen.push_back(arguments);
+
+    if (arguments.back() == "3.mkv")
+      mxerror("broken\n");
+
+    if (arguments.back() == "5.mkv")
+      mxwarn("suspicious\n");
+
+    return true;
+  });
+
+  restore_mxmsg_handlers();
+
+  EXPECT_EQ(2, exit_code);
+  ASSERT_EQ(20u, arguments_seen.size());
+
+  for (auto idx = 0u; idx < arguments_seen.size(); ++idx) {
+    auto const &arguments = arguments_seen[idx];
+    ASSERT_EQ(3u, arguments.size());
+    EXPECT_EQ("--edit",                                     arguments[0]);
+    EXPECT_EQ("info",                                       arguments[1]);
+    EXPECT_EQ((boost::format("%1%.mkv") % idx).str(),        arguments[2]);
+  }
+}
+
+}
@@ -66,6 +66,17 @@ dump(EbmlElement *element,
     dump(el, with_values, level + 1);
 }
 
+std::string
+create_test_data(std::size_t size,
+                 unsigned int seed) {
+  auto data = std::string(size, '\0');
+
+  for (auto idx = 0u; idx < size; ++idx)
+    data[idx] = (idx * seed + idx / 251) & 0xff;
+
+  return data;
+}
+
 //
 // ----------------------------------------------------------------------
 //
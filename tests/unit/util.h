@@ -32,6 +32,10 @@ void dump(EbmlElement *element, bool with_values = false, unsigned int level = 0
 
 ::testing::AssertionResult EbmlEquals(char const *a_expr, char const *b_expr, EbmlElement &a, EbmlElement &b);
 
+// Returns size bytes of data that doesn't repeat within short
+// distances. Different seeds yield different data.
+std::string create_test_data(std::size_t size, unsigned int seed = 7);
+
 class ebml_equals_c {
 private:
   std::vector<std::string> m_path;